@@ -0,0 +1,166 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : AllocBench.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include "Lsystem.hpp"
+#include "Parser.hpp"
+#include "Turtle.hpp"
+#include "Growth.hpp"
+#include "ExpansionCache.hpp"
+#include "Rope.hpp"
+#include "Segments.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <memory_resource>
+#include <dirent.h>
+
+using namespace std;
+
+/**
+ * @brief Output that discards the Logo code.
+ */
+class NullBuffer : public streambuf {
+    protected:
+        int overflow(int symbol) {
+            return symbol;
+        }
+        streamsize xsputn(const char*, streamsize count) {
+            return count;
+        }
+};
+
+/**
+ * @brief Run the whole pipeline on a definition: parse, analyse,
+ *     derive (flat and as a rope), translate to Logo and trace.
+ * @param path The definition file.
+ * @param pooled Whether to keep the rope scratch in a monotonic
+ *     resource, as with -r, or on the heap.
+ * @param reserved Whether to reserve the segments from the analysis, or
+ *     let them grow.
+ * @return False if the file cannot be opened.
+ */
+static bool runPipeline(const string &path, const bool pooled,
+        const bool reserved) {
+    NullBuffer discard;
+    ostream logo(&discard);
+    pmr::monotonic_buffer_resource scratch;
+    Parser p;
+    string prod, error;
+    Growth::Count draws = 0;
+    size_t symbol;
+    if (!p.parse(path, error)) {
+        return false;
+    }
+    Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+    Turtle ninja(p.getTurtle());
+    Growth growth(lsys, p.getIterations());
+    ExpansionCache cache(lsys, p.getIterations());
+    prod = lsys.produce(p.getIterations(), 1, &cache);
+    Rope rope = lsys.produceRope(p.getIterations(), pooled ? &scratch :
+        pmr::get_default_resource());
+    ninja.rewrite(prod, p.getReductionScale(), p.getInitPos(),
+        p.getInitAng(), logo);
+    Segments segs;
+    if (reserved) {
+        for (symbol = 0; symbol < growth.getSymbols().size(); symbol++) {
+            draws += growth.getCount(growth.getSymbols()[symbol])*
+                ninja.getDraws(growth.getSymbols()[symbol]);
+        }
+        segs.reserve(static_cast<size_t>(draws));
+    }
+    ninja.trace(prod, atof(p.getReductionScale().c_str()),
+        atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+        atof(p.getInitAng().c_str()), segs);
+    return true;
+}
+
+int benchAlloc(const string &dataDir) {
+    vector<string> files;
+    string name;
+    unsigned long long counts[3], bytes[3];
+    unsigned int file, model;
+    int status = EXIT_SUCCESS;
+    DIR* dir = opendir(dataDir.c_str());
+    struct dirent* entry;
+    if (dir == NULL) {
+        cout << "error opening folder" << endl;
+        return EXIT_FAILURE;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        name = entry->d_name;
+        if ((name.size() > 4) && !name.compare(name.size() - 4, 4, ".def")) {
+            files.push_back(name);
+        }
+    }
+    closedir(dir);
+    sort(files.begin(), files.end());
+    cout << "alloc: heap vs monotonic rope scratch vs reserved segments" <<
+        endl;
+    cout << setw(16) << "definition" << setw(10) << "heap(n)" <<
+        setw(10) << "heap(KB)" << setw(10) << "arena(n)" <<
+        setw(10) << "arena(KB)" << setw(10) << "ratio" <<
+        setw(12) << "reserve(n)" << setw(12) << "reserve(KB)" <<
+        setw(10) << "ratio" << endl;
+    for (file = 0; file < files.size(); file++) {
+        // Heap, then the arena alone, then both
+        for (model = 0; model < 3; model++) {
+            counts[model] = benchAllocations();
+            bytes[model] = benchAllocatedBytes();
+            if (!runPipeline(dataDir + "/" + files[file], model > 0,
+                    model > 1)) {
+                cout << "error opening file" << endl;
+                return EXIT_FAILURE;
+            }
+            counts[model] = benchAllocations() - counts[model];
+            bytes[model] = benchAllocatedBytes() - bytes[model];
+        }
+        if ((counts[1] > counts[0]) || (counts[2] > counts[1])) {
+            cout << files[file] << ": more allocations" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(16) << files[file] << setw(10) << counts[0] <<
+            setw(10) << bytes[0]/1024 << setw(10) << counts[1] <<
+            setw(10) << bytes[1]/1024 << fixed << setprecision(2) <<
+            setw(9) << static_cast<double>(counts[0])/counts[1] << "x" <<
+            setw(12) << counts[2] << setw(12) << bytes[2]/1024 <<
+            setw(9) << static_cast<double>(counts[0])/counts[2] << "x" <<
+            endl;
+    }
+    return status;
+}
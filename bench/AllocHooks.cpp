@@ -0,0 +1,78 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : AllocHooks.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// The hooks are kept apart from the code that allocates, so that the
+// compiler does not inline them where it pairs new with free
+
+/**
+ * @brief Number of heap allocations made by the bench binary.
+ */
+static unsigned long long numAllocations = 0;
+
+/**
+ * @brief Number of bytes allocated from the heap by the bench binary.
+ */
+static unsigned long long numBytes = 0;
+
+unsigned long long benchAllocations() {
+    return numAllocations;
+}
+
+unsigned long long benchAllocatedBytes() {
+    return numBytes;
+}
+
+void* operator new(size_t size) {
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == NULL) {
+        throw bad_alloc();
+    }
+    numAllocations++;
+    numBytes += size;
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
@@ -0,0 +1,201 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : BatchBench.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include "Batch.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+/**
+ * @brief Number of seeds swept over every definition.
+ */
+static const unsigned int NUM_SEEDS = 8;
+
+/**
+ * @brief Run a job as its own process, as a shell loop would do.
+ * @return False if the process fails.
+ */
+static bool runProcess(const string &binary, const string &definition,
+        const unsigned int seed, const string &output) {
+    ostringstream seedText;
+    int status = -1;
+    int fd;
+    pid_t child;
+    seedText << seed;
+    child = fork();
+    if (child == 0) {
+        fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(fd, STDOUT_FILENO);
+        close(fd);
+        execl(binary.c_str(), binary.c_str(), "-s", seedText.str().c_str(),
+            definition.c_str(), (char*) NULL);
+        _exit(EXIT_FAILURE);
+    }
+    if (child > 0) {
+        waitpid(child, &status, 0);
+    }
+    return (status == 0);
+}
+
+/**
+ * @brief Contents of a file.
+ */
+static string slurp(const string &path) {
+    ifstream f(path.c_str(), ios::in | ios::binary);
+    ostringstream contents;
+    contents << f.rdbuf();
+    return contents.str();
+}
+
+int benchBatch(const string &dataDir) {
+    vector<string> definitions, outputs;
+    string name, binary, folder, manifestPath, error;
+    char self[4096], scratch[] = "/tmp/lsystem-bench.XXXXXX";
+    double start, processTime, serialTime, poolTime;
+    unsigned int numThreads = thread::hardware_concurrency();
+    unsigned int def, seed, job;
+    int status = EXIT_SUCCESS;
+    ssize_t length;
+    DIR* dir = opendir(dataDir.c_str());
+    struct dirent* entry;
+    if ((dir == NULL) || (mkdtemp(scratch) == NULL)) {
+        cout << "error opening folder" << endl;
+        return EXIT_FAILURE;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        name = entry->d_name;
+        if ((name.size() > 4) && !name.compare(name.size() - 4, 4, ".def")) {
+            definitions.push_back(dataDir + "/" + name);
+        }
+    }
+    closedir(dir);
+    sort(definitions.begin(), definitions.end());
+    folder = scratch;
+    // The main binary is built next to the bench
+    length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    self[length > 0 ? length : 0] = '\0';
+    binary = self;
+    binary = binary.substr(0, binary.rfind('/') + 1) + "lsystem";
+    // Sweep of seeds over every definition, written by the batch
+    manifestPath = folder + "/manifest";
+    ofstream manifest(manifestPath.c_str());
+    for (def = 0; def < definitions.size(); def++) {
+        for (seed = 0; seed < NUM_SEEDS; seed++) {
+            ostringstream output;
+            output << folder << "/job" << outputs.size();
+            outputs.push_back(output.str());
+            manifest << definitions[def] << " - " << seed << " logo " <<
+                output.str() << endl;
+        }
+    }
+    manifest.close();
+    cout << "batch: " << outputs.size() << " jobs, one process per job vs "
+        "one process" << endl;
+    cout << setw(16) << "workflow" << setw(12) << "time(s)" <<
+        setw(12) << "jobs/s" << setw(10) << "speedup" << endl;
+    processTime = 0;
+    if (access(binary.c_str(), X_OK) == 0) {
+        start = benchClock();
+        job = 0;
+        for (def = 0; def < definitions.size(); def++) {
+            for (seed = 0; seed < NUM_SEEDS; seed++) {
+                if (!runProcess(binary, definitions[def], seed,
+                        outputs[job] + ".proc")) {
+                    status = EXIT_FAILURE;
+                }
+                job++;
+            }
+        }
+        processTime = benchClock() - start;
+        cout << setw(16) << "processes" << fixed << setprecision(3) <<
+            setw(12) << processTime << setprecision(1) << setw(12) <<
+            outputs.size()/processTime << setprecision(2) << setw(9) <<
+            1.0 << "x" << endl;
+    } else {
+        cout << setw(16) << "processes" << "  (" << binary <<
+            " not found)" << endl;
+    }
+    Batch batch;
+    ifstream loaded(manifestPath.c_str());
+    if (!batch.load(loaded, error)) {
+        cout << error << endl;
+        return EXIT_FAILURE;
+    }
+    loaded.close();
+    start = benchClock();
+    if (batch.run(1) > 0) {
+        status = EXIT_FAILURE;
+    }
+    serialTime = benchClock() - start;
+    start = benchClock();
+    if (batch.run(numThreads) > 0) {
+        status = EXIT_FAILURE;
+    }
+    poolTime = benchClock() - start;
+    cout << setw(16) << "batch, 1 thread" << fixed << setprecision(3) <<
+        setw(12) << serialTime << setprecision(1) << setw(12) <<
+        outputs.size()/serialTime << setprecision(2) << setw(9) <<
+        (processTime > 0 ? processTime/serialTime : 0) << "x" << endl;
+    cout << setw(16) << "batch, threads" << fixed << setprecision(3) <<
+        setw(12) << poolTime << setprecision(1) << setw(12) <<
+        outputs.size()/poolTime << setprecision(2) << setw(9) <<
+        (processTime > 0 ? processTime/poolTime : 0) << "x" << endl;
+    // Same drawings either way, then clean up
+    for (job = 0; job < outputs.size(); job++) {
+        if ((processTime > 0) &&
+                (slurp(outputs[job]) != slurp(outputs[job] + ".proc"))) {
+            cout << outputs[job] << ": drawings differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        remove(outputs[job].c_str());
+        remove((outputs[job] + ".proc").c_str());
+    }
+    remove(manifestPath.c_str());
+    rmdir(folder.c_str());
+    return status;
+}
@@ -0,0 +1,122 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Bench.hpp                                                   |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief Wall-clock timer for the benchmarks.
+ * @return Seconds elapsed since an arbitrary origin.
+ */
+double benchClock();
+
+/**
+ * @brief Heap allocations made by the bench binary so far.
+ * @return The number of allocations.
+ */
+unsigned long long benchAllocations();
+
+/**
+ * @brief Heap bytes allocated by the bench binary so far.
+ * @return The number of bytes.
+ */
+unsigned long long benchAllocatedBytes();
+
+/**
+ * @brief Production benchmark: compiled rule table against the original
+ *     multimap-walking derivation.
+ * @param dataDir Folder where the L-system definitions are found.
+ * @return EXIT_SUCCESS if both derivations agree.
+ */
+int benchProduce(const string &dataDir);
+
+/**
+ * @brief Turtle benchmark: compiled opcodes against the original
+ *     per-symbol lookups and string comparisons, in symbols per second.
+ * @param dataDir Folder where the L-system definitions are found.
+ * @return EXIT_SUCCESS if both translations agree.
+ */
+int benchTurtle(const string &dataDir);
+
+/**
+ * @brief Allocation benchmark: the memory model of a run (definition
+ *     by reference, scratch in an arena, segments reserved beforehand)
+ *     against allocating as it goes, on every definition found.
+ * @param dataDir Folder where the L-system definitions are found.
+ * @return EXIT_SUCCESS if the memory model never allocates more.
+ */
+int benchAlloc(const string &dataDir);
+
+/**
+ * @brief Batch benchmark: a sweep of seeds over every definition found,
+ *     run as one process per job against a single batch process, in
+ *     jobs per second.
+ * @param dataDir Folder where the L-system definitions are found.
+ * @return EXIT_SUCCESS if all the jobs agree.
+ */
+int benchBatch(const string &dataDir);
+
+/**
+ * @brief Parser benchmark: a generated catalogue of up to 100k rules,
+ *     parsed in one pass over the mapped file against the original
+ *     line by line tokenizer.
+ * @return EXIT_SUCCESS if both parsers agree.
+ */
+int benchParse();
+
+/**
+ * @brief Raster benchmark: images of 16384 pixels drawn on tiles by a
+ *     pool of threads against a single thread, and tiled images against
+ *     the whole image drawn at once.
+ * @param dataDir Folder where the L-system definitions are found.
+ * @return EXIT_SUCCESS if the images never differ.
+ */
+int benchRaster(const string &dataDir);
+
+/**
+ * @brief Profile of every definition found at increasing iteration
+ *     counts: parse, derive and trace times, symbols per second, peak
+ *     resident memory and heap allocations, also written as JSON to be
+ *     tracked over time.
+ * @param dataDir Folder where the L-system definitions are found.
+ * @param jsonPath Where to write the JSON document.
+ * @return EXIT_SUCCESS if every definition is profiled.
+ */
+int benchProfile(const string &dataDir, const string &jsonPath);
+
+#endif
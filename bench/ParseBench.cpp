@@ -0,0 +1,180 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ParseBench.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include "Parser.hpp"
+#include <string>
+#include <set>
+#include <map>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <boost/tokenizer.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace boost;
+
+/**
+ * @brief Original parser of the rules, line by line with a tokenizer.
+ *     Kept as the reference of the benchmark.
+ */
+static void legacyParse(ifstream &file, set<char> &alphabet,
+        multimap<char, pair<string, double> > &rules) {
+    string line, instros, rule;
+    char cLine;
+    size_t ruleBegin, ruleEnd;
+    double weight;
+    char_separator<char> ruleSep(" \t->");
+    while (file.good()) {
+        getline(file, line);
+        if (!line.empty() && (line.at(0) != '#')) {
+            tokenizer<> tok(line);
+            tokenizer<>::iterator lineChar = tok.begin();
+            if (!(*lineChar).compare("variables")) {
+                for (lineChar++; lineChar != tok.end(); lineChar++) {
+                    alphabet.insert((*lineChar).at(0));
+                }
+            } else if (!(*lineChar).compare("rules")) {
+                ruleBegin = line.find('(');
+                while (ruleBegin != string::npos) {
+                    ruleEnd = line.find(')', ruleBegin);
+                    rule = line.substr(ruleBegin + 1,
+                        ruleEnd - ruleBegin - 1);
+                    tokenizer<char_separator<char> > ruleTok(rule, ruleSep);
+                    tokenizer<char_separator<char> >::iterator ruleChar =
+                        ruleTok.begin();
+                    cLine = (*ruleChar).at(0);
+                    ruleChar++;
+                    instros = *ruleChar;
+                    ruleChar++;
+                    weight = 1;
+                    if (ruleChar != ruleTok.end()) {
+                        weight = atof((*ruleChar).c_str());
+                    }
+                    rules.insert(pair<char, pair<string, double> >(cLine,
+                        pair<string, double>(instros, weight)));
+                    ruleBegin = (ruleEnd == string::npos) ? string::npos :
+                        line.find('(', ruleEnd);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief A generated catalogue of stochastic rules, one rule per line,
+ *     over the letters and digits.
+ */
+static string catalogue(const unsigned int numRules) {
+    const string symbols =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    ostringstream text;
+    unsigned int rule, symbol, length;
+    unsigned long long state = 42;
+    text << "# Generated catalogue" << endl << "variables: ";
+    for (symbol = 0; symbol < symbols.size(); symbol++) {
+        text << (symbol > 0 ? ", " : "") << symbols[symbol];
+    }
+    text << endl << "start: A" << endl;
+    for (rule = 0; rule < numRules; rule++) {
+        text << "rules: (" << symbols[rule % symbols.size()] << " -> ";
+        for (length = 0; length < 16; length++) {
+            state = state*6364136223846793005ULL + 1442695040888963407ULL;
+            text << symbols[(state >> 33) % symbols.size()];
+        }
+        text << " " << (state >> 40) % 1000 / 1000.0 + 0.001 << ")" << endl;
+    }
+    text << "runIters: 4" << endl;
+    for (symbol = 0; symbol < symbols.size(); symbol++) {
+        text << "tg " << symbols[symbol] << ": drawForward 10, turnLeft " <<
+            symbol << endl;
+    }
+    return text.str();
+}
+
+int benchParse() {
+    const unsigned int numRules[] = {1000, 10000, 100000};
+    char path[] = "/tmp/lsystem-parse.XXXXXX";
+    string text, error;
+    double start, legacyTime, mappedTime;
+    int status = EXIT_SUCCESS;
+    int fd;
+    unsigned int n;
+    cout << "parse: mapped single pass vs getline and tokenizer" << endl;
+    cout << setw(10) << "rules" << setw(12) << "bytes" <<
+        setw(12) << "legacy(s)" << setw(12) << "mapped(s)" <<
+        setw(10) << "speedup" << setw(14) << "rules/s" << endl;
+    fd = mkstemp(path);
+    if (fd < 0) {
+        cout << "error writing file" << endl;
+        return EXIT_FAILURE;
+    }
+    close(fd);
+    for (n = 0; n < sizeof(numRules)/sizeof(numRules[0]); n++) {
+        set<char> alphabet;
+        multimap<char, pair<string, double> > rules;
+        Parser p;
+        text = catalogue(numRules[n]);
+        ofstream out(path, ios::out | ios::binary);
+        out << text;
+        out.close();
+        start = benchClock();
+        ifstream f(path);
+        legacyParse(f, alphabet, rules);
+        f.close();
+        legacyTime = benchClock() - start;
+        start = benchClock();
+        if (!p.parse(path, error)) {
+            cout << error << endl;
+            status = EXIT_FAILURE;
+        }
+        mappedTime = benchClock() - start;
+        cout << setw(10) << numRules[n] << setw(12) << text.size() <<
+            fixed << setprecision(4) << setw(12) << legacyTime <<
+            setw(12) << mappedTime << setprecision(2) << setw(9) <<
+            legacyTime/mappedTime << "x" << setprecision(0) << setw(14) <<
+            numRules[n]/mappedTime << endl;
+        cout.unsetf(ios::fixed);
+        if ((p.getRules() != rules) || (p.getAlphabet() != alphabet)) {
+            cout << "MISMATCH: the parsers disagree" << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    unlink(path);
+    return status;
+}
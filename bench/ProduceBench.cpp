@@ -0,0 +1,643 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ProduceBench.cpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include "Lsystem.hpp"
+#include "ParametricLsystem.hpp"
+#include "Parser.hpp"
+#include "Derivation.hpp"
+#include "DerivationSession.hpp"
+#include "ExpansionCache.hpp"
+#include "Growth.hpp"
+#include "ProductionFile.hpp"
+#include "Rope.hpp"
+#include "RopeSource.hpp"
+#include <string>
+#include <set>
+#include <map>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @brief Original derivation, which walks the rule multimap for every
+ *     symbol. Kept as the reference of the benchmark.
+ */
+static string legacyProduce(const string &start,
+        const multimap<char, pair<string, double> > &weighted,
+        const int numIter) {
+    multimap<char, string> rules;
+    multimap<char, pair<string, double> >::const_iterator weightedIter;
+    string production = start;
+    string aux;
+    string::const_iterator prodIter;
+    multimap<char, string>::const_iterator ruleIter;
+    int numRules, chance, epoch;
+    for (weightedIter = weighted.begin(); weightedIter != weighted.end();
+            weightedIter++) {
+        rules.insert(pair<char, string>((*weightedIter).first,
+            (*weightedIter).second.first));
+    }
+    for (epoch = 0; epoch < numIter; epoch++) {
+        aux.clear();
+        for (prodIter = production.begin(); prodIter < production.end();
+                prodIter++) {
+            numRules = rules.count(*prodIter);
+            if (numRules > 0) {
+                chance = rand()%numRules;
+                for (ruleIter = rules.lower_bound(*prodIter);
+                        ruleIter != rules.upper_bound(*prodIter);
+                        ruleIter++) {
+                    if (!chance) {
+                        aux += (*ruleIter).second;
+                        break;
+                    }
+                    chance--;
+                }
+            } else {
+                aux += *prodIter;
+            }
+        }
+        production = aux;
+    }
+    return production;
+}
+
+/**
+ * @brief Parallel derivation against the serial one.
+ */
+static int benchParallel(const string &dataDir) {
+    const char* grammars[] = {"tree", "koch"};
+    const int iterations[] = {10, 10};
+    unsigned int numThreads = thread::hardware_concurrency();
+    string serial, parallel, error;
+    double start, serialTime, parallelTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "produce: " << numThreads << " threads vs serial" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "serial(s)" <<
+        setw(12) << "threads(s)" << setw(10) << "speedup" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        start = benchClock();
+        serial = lsys.produce(iterations[g]);
+        serialTime = benchClock() - start;
+        start = benchClock();
+        parallel = lsys.produce(iterations[g], numThreads);
+        parallelTime = benchClock() - start;
+        if (serial != parallel) {
+            cout << grammars[g] << ": productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << parallel.size() << fixed << setprecision(3) <<
+            setw(12) << serialTime << setw(12) << parallelTime <<
+            setprecision(2) << setw(9) << serialTime/parallelTime << "x" <<
+            endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Symbols of a lazy derivation, drained in blocks.
+ */
+static string drain(SymbolSource &source) {
+    string production;
+    char block[4096];
+    size_t count;
+    while ((count = source.read(block, sizeof(block))) > 0) {
+        production.append(block, count);
+    }
+    return production;
+}
+
+/**
+ * @brief Cached expansions against the derivation generation by
+ *     generation, both in memory and lazily. The cached times include
+ *     building the cache.
+ */
+static int benchCache(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon", "sierpinski"};
+    const int iterations[] = {12, 20, 14};
+    string table, cached, error;
+    double start, tableTime, cachedTime, lazyTime, lazyCachedTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "produce: expansion cache vs rule table" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "table(s)" <<
+        setw(12) << "cached(s)" << setw(10) << "speedup" <<
+        setw(12) << "lazy(s)" << setw(12) << "cached(s)" <<
+        setw(10) << "speedup" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        start = benchClock();
+        table = lsys.produce(iterations[g]);
+        tableTime = benchClock() - start;
+        start = benchClock();
+        ExpansionCache cache(lsys, iterations[g]);
+        cached = lsys.produce(iterations[g], 1, &cache);
+        cachedTime = benchClock() - start;
+        if (table != cached) {
+            cout << grammars[g] << ": productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        start = benchClock();
+        Derivation lazy(lsys, iterations[g]);
+        cached = drain(lazy);
+        lazyTime = benchClock() - start;
+        start = benchClock();
+        ExpansionCache lazyCache(lsys, iterations[g]);
+        Derivation lazyCached(lsys, iterations[g], &lazyCache);
+        cached = drain(lazyCached);
+        lazyCachedTime = benchClock() - start;
+        if (table != cached) {
+            cout << grammars[g] << ": lazy productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << table.size() << fixed << setprecision(3) <<
+            setw(12) << tableTime << setw(12) << cachedTime <<
+            setprecision(2) << setw(9) << tableTime/cachedTime << "x" <<
+            setprecision(3) << setw(12) << lazyTime <<
+            setw(12) << lazyCachedTime << setprecision(2) << setw(9) <<
+            lazyTime/lazyCachedTime << "x" << endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Closed-form length against the length of the derived
+ *     production.
+ */
+static int benchGrowth(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon", "koch"};
+    const int iterations[] = {12, 20, 10};
+    string production, error;
+    double start, produceTime, growthTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "length: growth matrix vs produce" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "produce(s)" <<
+        setw(12) << "matrix(s)" << setw(10) << "speedup" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        start = benchClock();
+        production = lsys.produce(iterations[g]);
+        produceTime = benchClock() - start;
+        start = benchClock();
+        Growth growth(lsys, iterations[g]);
+        growthTime = benchClock() - start;
+        if (!growth.isExact() || (growth.getLength() != production.size())) {
+            cout << grammars[g] << ": lengths differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << production.size() << fixed << setprecision(3) <<
+            setw(12) << produceTime << setprecision(6) << setw(12) <<
+            growthTime << scientific << setprecision(2) << setw(9) <<
+            produceTime/growthTime << "x" << fixed << endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Rope of shared subtrees against the flat production: memory,
+ *     time to build and read it in order, and random access.
+ */
+static int benchRope(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon", "koch"};
+    const int iterations[] = {12, 20, 10};
+    const unsigned long long probes = 1000000;
+    string flat, read, error;
+    double start, flatTime, ropeTime, accessTime;
+    unsigned long long probe, position, mismatches;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "produce: rope vs flat string" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "flat(s)" <<
+        setw(12) << "rope(s)" << setw(12) << "rope(B)" <<
+        setw(14) << "access(ns)" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        start = benchClock();
+        flat = lsys.produce(iterations[g]);
+        flatTime = benchClock() - start;
+        // Build and read in order, as the turtle does
+        start = benchClock();
+        Rope rope = lsys.produceRope(iterations[g]);
+        RopeSource source(rope);
+        read = drain(source);
+        ropeTime = benchClock() - start;
+        if (read != flat) {
+            cout << grammars[g] << ": productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        mismatches = 0;
+        position = 0;
+        start = benchClock();
+        for (probe = 0; probe < probes; probe++) {
+            position = (position*6364136223846793005ULL +
+                1442695040888963407ULL);
+            mismatches += rope.at((position >> 11)%flat.size()) !=
+                flat[(position >> 11)%flat.size()];
+        }
+        accessTime = benchClock() - start;
+        if (mismatches > 0) {
+            cout << grammars[g] << ": random access differs" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << flat.size() << fixed << setprecision(3) <<
+            setw(12) << flatTime << setw(12) << ropeTime <<
+            setw(12) << rope.getFootprint() << setprecision(1) <<
+            setw(14) << accessTime/probes*1e9 << endl;
+    }
+    return status;
+}
+
+/**
+ * @brief One more generation from a session against the derivation from
+ *     the axiom, and the cost of a checkpoint on disk.
+ */
+static int benchSession(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon", "koch"};
+    const int iterations[] = {12, 20, 10};
+    string production, error;
+    ostringstream path;
+    double start, produceTime, advanceTime, saveTime, loadTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    path << "/tmp/lsystem-bench-" << getpid() << ".ckpt";
+    cout << "produce: session n to n+1 vs from the axiom" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "produce(s)" <<
+        setw(12) << "advance(s)" << setw(10) << "speedup" <<
+        setw(10) << "save(s)" << setw(10) << "load(s)" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        DerivationSession session(lsys);
+        session.advance(iterations[g] - 1);
+        start = benchClock();
+        production = lsys.produce(iterations[g]);
+        produceTime = benchClock() - start;
+        start = benchClock();
+        session.advance();
+        advanceTime = benchClock() - start;
+        start = benchClock();
+        if (!session.save(path.str(), error)) {
+            cout << error << endl;
+            status = EXIT_FAILURE;
+        }
+        saveTime = benchClock() - start;
+        DerivationSession resumed(lsys);
+        start = benchClock();
+        if (!resumed.load(path.str(), error)) {
+            cout << error << endl;
+            status = EXIT_FAILURE;
+        }
+        loadTime = benchClock() - start;
+        if ((session.getProduction() != production) ||
+                (resumed.getProduction() != production)) {
+            cout << grammars[g] << ": productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << production.size() << fixed << setprecision(3) <<
+            setw(12) << produceTime << setw(12) << advanceTime <<
+            setprecision(2) << setw(9) << produceTime/advanceTime << "x" <<
+            setprecision(3) << setw(10) << saveTime << setw(10) <<
+            loadTime << endl;
+    }
+    remove(path.str().c_str());
+    return status;
+}
+
+/**
+ * @brief Out-of-core derivation into a mapped file against the
+ *     derivation in memory.
+ */
+static int benchOutOfCore(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon", "koch"};
+    const int iterations[] = {12, 20, 10};
+    string production, error;
+    ostringstream path;
+    double start, memoryTime, fileTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    path << "/tmp/lsystem-bench-" << getpid() << ".prod";
+    cout << "produce: mapped file vs memory" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "memory(s)" <<
+        setw(12) << "file(s)" << setw(10) << "ratio" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        start = benchClock();
+        production = lsys.produce(iterations[g]);
+        memoryTime = benchClock() - start;
+        start = benchClock();
+        if (!lsys.produceFile(iterations[g], path.str(), error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        fileTime = benchClock() - start;
+        ProductionFile mapped;
+        if (!mapped.open(path.str(), error) ||
+                (mapped.getHeader().length != production.size()) ||
+                memcmp(mapped.getSymbols(), production.data(),
+                production.size())) {
+            cout << grammars[g] << ": productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << production.size() << fixed << setprecision(3) <<
+            setw(12) << memoryTime << setw(12) << fileTime <<
+            setprecision(2) << setw(9) << fileTime/memoryTime << "x" <<
+            endl;
+    }
+    remove(path.str().c_str());
+    return status;
+}
+
+/**
+ * @brief Symbols of some modules of the parametric dragon curve, where
+ *     X(1) stands for the Y of the context-free definition.
+ */
+static string unparametrise(const ParametricLsystem &plsys,
+        const ParametricLsystem::Modules &modules) {
+    string symbols(modules.symbols);
+    size_t m, param = 0;
+    for (m = 0; m < symbols.size(); m++) {
+        if ((symbols[m] == 'X') && (plsys.getArity('X') == 1) &&
+                (modules.params[param] != 0)) {
+            symbols[m] = 'Y';
+        }
+        param += plsys.getArity(modules.symbols[m]);
+    }
+    return symbols;
+}
+
+/**
+ * @brief Context-sensitive and parametric engine against the context-free
+ *     one on equivalent grammars: the rules of the plant written as rule
+ *     lines, which take the fixed path; the Koch curve with a left and
+ *     right context that skips the turns, falling back to the plain rule
+ *     at the ends; the dragon curve with Y as X(1), chosen by a
+ *     condition; and the Koch curve with the length of every segment as
+ *     a parameter. Each time is the best of a few runs, and the ratios
+ *     beyond the bound of twice the context-free time are marked.
+ */
+static int benchParametric(const string &dataDir) {
+    const char* names[] = {"plant", "koch(ctx)", "dragon(t)", "koch(l)"};
+    const char* grammars[] = {"plant", "koch", "dragon", "koch"};
+    const int iterations[] = {12, 10, 20, 10};
+    const char* axioms[] = {NULL, "F", "FX(0)", "F(1)"};
+    const char* rules[][2] = {
+        {NULL, NULL},
+        {"F < F > F -> FpFmFmFpF", "F -> FpFmFmFpF"},
+        {"X(t) : t == 0 -> X(0)pX(1)F", "X(t) -> FX(0)mX(1)"},
+        {"F(l) -> F(l/3)pF(l/3)mF(l/3)mF(l/3)pF(l/3)", NULL}};
+    const char* ignored[] = {"", "pm", "", ""};
+    const int RUNS = 3;
+    multimap<char, pair<string, double> > none;
+    multimap<char, pair<string, double> >::const_iterator rule;
+    vector<string> moduleRules;
+    ParametricLsystem::Modules modules;
+    string production, axiom, error;
+    double start, elapsed, freeTime, moduleTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g, r;
+    cout << "produce: parametric engine vs context-free" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "free(s)" <<
+        setw(12) << "modules(s)" << setw(10) << "ratio" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        moduleRules.clear();
+        if (axioms[g] == NULL) {
+            axiom = p.getAxiom();
+            for (rule = p.getRules().begin(); rule != p.getRules().end();
+                    rule++) {
+                moduleRules.push_back(string(1, rule->first) + " -> " +
+                    rule->second.first);
+            }
+        } else {
+            axiom = axioms[g];
+            for (r = 0; (r < 2) && (rules[g][r] != NULL); r++) {
+                moduleRules.push_back(rules[g][r]);
+            }
+        }
+        ParametricLsystem plsys;
+        if (!plsys.compile(axiom, none, moduleRules,
+                set<char>(ignored[g], ignored[g] + strlen(ignored[g])),
+                set<char>(), set<char>(), error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        freeTime = 0;
+        moduleTime = 0;
+        for (r = 0; r < RUNS; r++) {
+            start = benchClock();
+            production = lsys.produce(iterations[g]);
+            elapsed = benchClock() - start;
+            freeTime = ((r == 0) || (elapsed < freeTime)) ? elapsed :
+                freeTime;
+            start = benchClock();
+            modules = plsys.produce(iterations[g]);
+            elapsed = benchClock() - start;
+            moduleTime = ((r == 0) || (elapsed < moduleTime)) ? elapsed :
+                moduleTime;
+        }
+        if (unparametrise(plsys, modules) != production) {
+            cout << names[g] << ": productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << names[g] << setw(7) << iterations[g] <<
+            setw(12) << production.size() << fixed << setprecision(3) <<
+            setw(12) << freeTime << setw(12) << moduleTime <<
+            setprecision(2) << setw(9) << moduleTime/freeTime << "x" <<
+            (moduleTime > 2*freeTime ? " over 2x" : "") << endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Contexts across branches: a signal sent up a branched axiom,
+ *     which reaches the base of every branch and the module after it,
+ *     one generation after the other, and a right context that skips a
+ *     branch and stops at the end of one.
+ */
+static int checkBranches() {
+    const char* axioms[] = {"S[A]A[A]A", "S[A]A[A]A", "A[B]C"};
+    const int iterations[] = {1, 2, 1};
+    const char* expected[] = {"A[S]S[A]A", "A[A]A[S]S", "Z[B]X"};
+    const char* rules[][3] = {
+        {"S < A -> S", "S -> A", NULL},
+        {"S < A -> S", "S -> A", NULL},
+        {"A < C -> X", "A > C -> Z", "B > C -> W"}};
+    const char opening[] = "[";
+    const char closing[] = "]";
+    multimap<char, pair<string, double> > none;
+    vector<string> moduleRules;
+    string production, error;
+    int status = EXIT_SUCCESS;
+    unsigned int g, r;
+    for (g = 0; g < sizeof(axioms)/sizeof(axioms[0]); g++) {
+        ParametricLsystem plsys;
+        moduleRules.clear();
+        for (r = 0; (r < 3) && (rules[g][r] != NULL); r++) {
+            moduleRules.push_back(rules[g][r]);
+        }
+        if (!plsys.compile(axioms[g], none, moduleRules, set<char>(),
+                set<char>(opening, opening + 1),
+                set<char>(closing, closing + 1), error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        production = plsys.produce(iterations[g]).symbols;
+        if (production.compare(expected[g])) {
+            cout << axioms[g] << ": branched contexts give " <<
+                production << " instead of " << expected[g] << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
+
+int benchProduce(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon"};
+    const int iterations[] = {12, 20};
+    string legacy, compiled, error;
+    double start, legacyTime, compiledTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "produce: compiled rule table vs multimap lookups" << endl;
+    cout << setw(10) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(12) << "legacy(s)" <<
+        setw(12) << "table(s)" << setw(10) << "speedup" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        start = benchClock();
+        legacy = legacyProduce(p.getAxiom(), p.getRules(), iterations[g]);
+        legacyTime = benchClock() - start;
+        start = benchClock();
+        compiled = lsys.produce(iterations[g]);
+        compiledTime = benchClock() - start;
+        if (legacy != compiled) {
+            cout << grammars[g] << ": productions differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(10) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << compiled.size() << fixed << setprecision(3) <<
+            setw(12) << legacyTime << setw(12) << compiledTime <<
+            setprecision(2) << setw(9) << legacyTime/compiledTime << "x" <<
+            endl;
+    }
+    if (benchParallel(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchCache(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchGrowth(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchRope(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchSession(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchOutOfCore(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchParametric(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (checkBranches() != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
@@ -0,0 +1,268 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ProfileBench.cpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include "Lsystem.hpp"
+#include "Parser.hpp"
+#include "Turtle.hpp"
+#include "Growth.hpp"
+#include "Segments.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <malloc.h>
+#include <dirent.h>
+
+using namespace std;
+
+/**
+ * @brief Largest production profiled, in symbols.
+ */
+static const double MAX_SYMBOLS = 16777216;
+
+/**
+ * @brief Smallest production profiled, in symbols. The iteration counts
+ *     are the first ones that reach every power of ten from here.
+ */
+static const double MIN_SYMBOLS = 1000;
+
+/**
+ * @brief Measures of a grammar at a number of iterations.
+ */
+struct Profile {
+    string grammar;
+    int iterations;
+    size_t symbols;
+    size_t segments;
+    double parseTime;
+    double deriveTime;
+    double turtleTime;
+    long peakKilobytes;
+    unsigned long long allocations;
+    unsigned long long bytes;
+};
+
+/**
+ * @brief Reset the peak resident set size of the process, where the
+ *     kernel allows it, to the memory still in use.
+ */
+static void resetPeak() {
+    // Return the memory freed by the previous profile first
+    malloc_trim(0);
+    ofstream refs("/proc/self/clear_refs");
+    refs << "5" << endl;
+}
+
+/**
+ * @brief Peak resident set size of the process, in kilobytes.
+ */
+static long peakKilobytes() {
+    ifstream status("/proc/self/status");
+    string line;
+    long peak = 0;
+    while (getline(status, line)) {
+        if (!line.compare(0, 6, "VmHWM:")) {
+            peak = atol(line.c_str() + 6);
+        }
+    }
+    return peak;
+}
+
+/**
+ * @brief The iteration counts of a grammar: the first that reach every
+ *     power of ten of symbols, up to the largest production profiled.
+ */
+static vector<int> schedule(const Lsystem &lsys, const int runIters) {
+    vector<int> counts;
+    double length = 0, threshold = MIN_SYMBOLS;
+    int n;
+    for (n = 1; (n <= 64) && (length <= MAX_SYMBOLS); n++) {
+        Growth growth(lsys, n);
+        length = growth.isExact() ?
+            static_cast<double>(growth.getLength()) :
+            growth.getExpectedLength();
+        if ((length >= threshold) && (length <= MAX_SYMBOLS)) {
+            counts.push_back(n);
+            while (threshold <= length) {
+                threshold *= 10;
+            }
+        }
+    }
+    // Grammars that do not grow are profiled as defined
+    if (counts.empty()) {
+        counts.push_back(runIters);
+    }
+    return counts;
+}
+
+/**
+ * @brief Profile a grammar at a number of iterations: parse, derive and
+ *     trace, each timed apart.
+ * @return False if the definition cannot be parsed.
+ */
+static bool profile(const string &path, Profile &result, string &error) {
+    double start;
+    string prod;
+    unsigned long long allocations = benchAllocations();
+    unsigned long long bytes = benchAllocatedBytes();
+    resetPeak();
+    start = benchClock();
+    Parser p;
+    if (!p.parse(path, error)) {
+        return false;
+    }
+    result.parseTime = benchClock() - start;
+    Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+    start = benchClock();
+    prod = lsys.produce(result.iterations);
+    result.deriveTime = benchClock() - start;
+    Turtle ninja(p.getTurtle());
+    Segments segs;
+    start = benchClock();
+    ninja.trace(prod, atof(p.getReductionScale().c_str()),
+        atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+        atof(p.getInitAng().c_str()), segs);
+    result.turtleTime = benchClock() - start;
+    result.symbols = prod.size();
+    result.segments = segs.size();
+    result.peakKilobytes = peakKilobytes();
+    result.allocations = benchAllocations() - allocations;
+    result.bytes = benchAllocatedBytes() - bytes;
+    return true;
+}
+
+/**
+ * @brief Write the profiles as a JSON document.
+ */
+static bool writeJson(const string &path, const vector<Profile> &results) {
+    ofstream out(path.c_str());
+    char date[32];
+    time_t now = time(NULL);
+    size_t r;
+    if (!out.is_open()) {
+        return false;
+    }
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    out << "{" << endl;
+    out << "  \"date\": \"" << date << "\"," << endl;
+    out << "  \"compiler\": \"" << __VERSION__ << "\"," << endl;
+    out << "  \"profiles\": [" << endl;
+    out << setprecision(9);
+    for (r = 0; r < results.size(); r++) {
+        const Profile &result = results[r];
+        out << "    {\"grammar\": \"" << result.grammar << "\", " <<
+            "\"iterations\": " << result.iterations << ", " <<
+            "\"symbols\": " << result.symbols << ", " <<
+            "\"segments\": " << result.segments << ", " <<
+            "\"parse_s\": " << result.parseTime << ", " <<
+            "\"derive_s\": " << result.deriveTime << ", " <<
+            "\"turtle_s\": " << result.turtleTime << ", " <<
+            "\"symbols_per_s\": " << result.symbols/result.deriveTime <<
+            ", \"peak_rss_kb\": " << result.peakKilobytes << ", " <<
+            "\"allocations\": " << result.allocations << ", " <<
+            "\"allocated_bytes\": " << result.bytes << "}" <<
+            (r + 1 < results.size() ? "," : "") << endl;
+    }
+    out << "  ]" << endl << "}" << endl;
+    return out.good();
+}
+
+int benchProfile(const string &dataDir, const string &jsonPath) {
+    vector<string> files;
+    vector<Profile> results;
+    vector<int> counts;
+    string name, error;
+    Profile result;
+    unsigned int file, count;
+    DIR* dir = opendir(dataDir.c_str());
+    struct dirent* entry;
+    if (dir == NULL) {
+        cout << "error opening folder" << endl;
+        return EXIT_FAILURE;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        name = entry->d_name;
+        if ((name.size() > 4) && !name.compare(name.size() - 4, 4, ".def")) {
+            files.push_back(name);
+        }
+    }
+    closedir(dir);
+    sort(files.begin(), files.end());
+    cout << "profile: parse, derive and trace every definition" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(11) << "symbols" << setw(11) << "parse(ms)" <<
+        setw(11) << "derive(s)" << setw(11) << "turtle(s)" <<
+        setw(10) << "Msym/s" << setw(10) << "peak(MB)" <<
+        setw(9) << "allocs" << endl;
+    for (file = 0; file < files.size(); file++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + files[file], error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        counts = schedule(Lsystem(p.getAlphabet(), p.getAxiom(),
+            p.getRules()), p.getIterations());
+        for (count = 0; count < counts.size(); count++) {
+            result.grammar = files[file].substr(0, files[file].size() - 4);
+            result.iterations = counts[count];
+            if (!profile(dataDir + "/" + files[file], result, error)) {
+                cout << error << endl;
+                return EXIT_FAILURE;
+            }
+            results.push_back(result);
+            cout << setw(12) << result.grammar << setw(7) <<
+                result.iterations << setw(11) << result.symbols <<
+                fixed << setprecision(3) << setw(11) <<
+                result.parseTime*1e3 << setw(11) << result.deriveTime <<
+                setw(11) << result.turtleTime << setprecision(1) <<
+                setw(10) << result.symbols/result.deriveTime/1e6 <<
+                setw(10) << result.peakKilobytes/1024.0 << setw(9) <<
+                result.allocations << endl;
+            cout.unsetf(ios::fixed);
+        }
+    }
+    if (!writeJson(jsonPath, results)) {
+        cout << "error writing file " << jsonPath << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "profile: written to " << jsonPath << endl;
+    return EXIT_SUCCESS;
+}
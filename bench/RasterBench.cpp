@@ -0,0 +1,276 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : RasterBench.cpp                                             |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include "Lsystem.hpp"
+#include "Parser.hpp"
+#include "Turtle.hpp"
+#include "Segments.hpp"
+#include "RasterWriter.hpp"
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Stream buffer that only counts and hashes what it is given, so
+ *     that huge images are timed without holding them.
+ */
+class HashBuffer : public streambuf {
+    public:
+        HashBuffer() : theHash(14695981039346656037ULL), theBytes(0) {
+        }
+        unsigned long long getHash() const {
+            return theHash;
+        }
+        unsigned long long getBytes() const {
+            return theBytes;
+        }
+    protected:
+        streamsize xsputn(const char* data, streamsize length) {
+            unsigned long long word;
+            streamsize byte;
+            // Words at a time, the same writes give the same hash
+            for (byte = 0; byte + 8 <= length; byte += 8) {
+                memcpy(&word, data + byte, 8);
+                theHash = (theHash ^ word)*1099511628211ULL;
+            }
+            for (; byte < length; byte++) {
+                theHash = (theHash ^ static_cast<unsigned char>(data[byte]))*
+                    1099511628211ULL;
+            }
+            theBytes += length;
+            return length;
+        }
+        int overflow(int value) {
+            char byte = static_cast<char>(value);
+            if (value != EOF) {
+                xsputn(&byte, 1);
+            }
+            return value;
+        }
+    private:
+        unsigned long long theHash;
+        unsigned long long theBytes;
+};
+
+/**
+ * @brief Whole image drawn at once, segment after segment, with the same
+ *     view box and pixel rule. Kept as the reference of the benchmark.
+ */
+static void wholeRaster(const Segments &segs, const unsigned int width,
+        const unsigned int height, vector<uint8_t> &image) {
+    const vector<double> &x0 = segs.getX0();
+    const vector<double> &y0 = segs.getY0();
+    const vector<double> &x1 = segs.getX1();
+    const vector<double> &y1 = segs.getY1();
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    double margin, scale, left, top, ax, ay, bx, by, slope, minor;
+    long major, last;
+    size_t seg;
+    if (segs.size() > 0) {
+        minX = maxX = x0[0];
+        minY = maxY = y0[0];
+    }
+    for (seg = 0; seg < segs.size(); seg++) {
+        minX = min(minX, min(x0[seg], x1[seg]));
+        maxX = max(maxX, max(x0[seg], x1[seg]));
+        minY = min(minY, min(y0[seg], y1[seg]));
+        maxY = max(maxY, max(y0[seg], y1[seg]));
+    }
+    margin = 0.02*max(max(maxX - minX, maxY - minY), 1.0);
+    scale = max(width, height)/max(maxX - minX + 2*margin,
+        maxY - minY + 2*margin);
+    left = minX - margin;
+    top = maxY + margin;
+    image.assign(static_cast<size_t>(width)*height, 0);
+    auto pixel = [](const double coord, const unsigned int limit) {
+        return min(max(static_cast<long>(floor(coord)), 0L),
+            static_cast<long>(limit) - 1);
+    };
+    for (seg = 0; seg < segs.size(); seg++) {
+        ax = (x0[seg] - left)*scale;
+        ay = (top - y0[seg])*scale;
+        bx = (x1[seg] - left)*scale;
+        by = (top - y1[seg])*scale;
+        if (fabs(bx - ax) >= fabs(by - ay)) {
+            if (ax > bx) {
+                swap(ax, bx);
+                swap(ay, by);
+            }
+            slope = bx > ax ? (by - ay)/(bx - ax) : 0;
+            last = pixel(bx, width);
+            for (major = pixel(ax, width); major <= last; major++) {
+                minor = ay + (min(max(major + 0.5, ax), bx) - ax)*slope;
+                image[pixel(minor, height)*width + major] = 255;
+            }
+        } else {
+            if (ay > by) {
+                swap(ax, bx);
+                swap(ay, by);
+            }
+            slope = (bx - ax)/(by - ay);
+            last = pixel(by, height);
+            for (major = pixel(ay, height); major <= last; major++) {
+                minor = ax + (min(max(major + 0.5, ay), by) - ay)*slope;
+                image[major*width + pixel(minor, width)] = 255;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tiled image against the whole image drawn at once, which must
+ *     match pixel for pixel, seams included.
+ */
+static int benchTiles(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon", "koch_island"};
+    const int iterations[] = {8, 14, 5};
+    const unsigned int size = 2048;
+    unsigned int numThreads = thread::hardware_concurrency();
+    string prod, failure, magic;
+    vector<uint8_t> whole;
+    unsigned int width, height, g;
+    size_t pixel, lit, mismatches;
+    int status = EXIT_SUCCESS;
+    cout << "raster: " << size << " pixels, tiles vs whole image" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(12) << "lit" <<
+        setw(12) << "mismatches" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        prod = lsys.produce(iterations[g]);
+        Turtle ninja(p.getTurtle());
+        Segments segs;
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), segs);
+        ostringstream ppm;
+        RasterWriter(size, RasterWriter::PPM, numThreads).write(segs, ppm);
+        istringstream header(ppm.str());
+        header >> magic >> width >> height;
+        wholeRaster(segs, width, height, whole);
+        const string &tiled = ppm.str();
+        const size_t offset = tiled.size() - 3*whole.size();
+        lit = mismatches = 0;
+        for (pixel = 0; pixel < whole.size(); pixel++) {
+            lit += whole[pixel] > 0;
+            if (static_cast<uint8_t>(tiled[offset + 3*pixel]) !=
+                    whole[pixel]) {
+                mismatches++;
+            }
+        }
+        if (mismatches > 0) {
+            cout << grammars[g] << ": images differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << segs.size() << setw(12) << lit <<
+            setw(12) << mismatches << endl;
+    }
+    return status;
+}
+
+int benchRaster(const string &dataDir) {
+    const char* grammars[] = {"plant", "tree"};
+    const int iterations[] = {10, 9};
+    const unsigned int size = 16384;
+    unsigned int numThreads = thread::hardware_concurrency();
+    string prod, failure;
+    double start, serialTime, parallelTime, pngTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "raster: " << size << " pixels, " << numThreads <<
+        " threads vs serial" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(12) << "serial(s)" <<
+        setw(12) << "threads(s)" << setw(10) << "speedup" <<
+        setw(10) << "png(s)" << setw(12) << "png(MB)" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        prod = lsys.produce(iterations[g]);
+        Turtle ninja(p.getTurtle());
+        Segments segs;
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), segs, numThreads);
+        HashBuffer serialBuffer, parallelBuffer, pngBuffer;
+        ostream serial(&serialBuffer), parallel(&parallelBuffer);
+        ostream png(&pngBuffer);
+        start = benchClock();
+        RasterWriter(size, RasterWriter::PPM).write(segs, serial);
+        serialTime = benchClock() - start;
+        start = benchClock();
+        RasterWriter(size, RasterWriter::PPM, numThreads).write(segs,
+            parallel);
+        parallelTime = benchClock() - start;
+        start = benchClock();
+        RasterWriter(size, RasterWriter::PNG, numThreads).write(segs, png);
+        pngTime = benchClock() - start;
+        if (serialBuffer.getHash() != parallelBuffer.getHash()) {
+            cout << grammars[g] << ": thread counts differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << segs.size() << fixed << setprecision(3) <<
+            setw(12) << serialTime << setw(12) << parallelTime <<
+            setprecision(2) << setw(9) << serialTime/parallelTime << "x" <<
+            setprecision(3) << setw(10) << pngTime << setprecision(1) <<
+            setw(12) << pngBuffer.getBytes()/1048576.0 << endl;
+    }
+    if (benchTiles(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
@@ -0,0 +1,746 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : TurtleBench.cpp                                             |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include "Lsystem.hpp"
+#include "Parser.hpp"
+#include "Turtle.hpp"
+#include "Segments.hpp"
+#include "Simplifier.hpp"
+#include "RasterWriter.hpp"
+#include "PlyWriter.hpp"
+#include "StringSource.hpp"
+#include <string>
+#include <map>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <cstring>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <boost/tokenizer.hpp>
+
+using namespace std;
+using namespace boost;
+
+/**
+ * @brief Original translation, which looks up the correspondence and
+ *     compares the instruction names for every symbol. Kept as the
+ *     reference of the benchmark.
+ */
+static string legacyRewrite(const string prod, map<char, string> corresp,
+        string scale, vector<string> iniPos, string iniAng) {
+    string expansion;
+    string::const_iterator charIt;
+    string logoCode = "; Logo code automatically generated by L-system\n";
+    logoCode += "\nmake \"stackPOS []\nmake \"stackANG []\nsetpencolor 7\nsetbackground 0\n";
+    logoCode += "hideturtle\n";
+    logoCode += "pu setxy ";
+    logoCode += iniPos[0];
+    logoCode += " ";
+    logoCode += iniPos[1];
+    logoCode += " pd\n";
+    logoCode += "setheading ";
+    logoCode += iniAng;
+    logoCode += "\n";
+    for (charIt = prod.begin(); charIt < prod.end(); charIt++) {
+        expansion += corresp[*charIt];
+        expansion += " ";
+    }
+    tokenizer<> tok(expansion);
+    tokenizer<>::iterator expToken;
+    for (expToken = tok.begin(); expToken != tok.end(); expToken++) {
+        if (!(*expToken).compare("drawForward")) {
+            logoCode += "fd ";
+            expToken++;
+            logoCode += *expToken;
+            logoCode += " / ";
+            logoCode += scale;
+            logoCode += "\n";
+        } else if (!(*expToken).compare("pushPos")) {
+            logoCode += "push \"stackPOS pos\n";
+        } else if (!(*expToken).compare("pushAng")) {
+            logoCode += "push \"stackANG heading\n";
+        } else if (!(*expToken).compare("turnLeft")) {
+            logoCode += "lt ";
+            expToken++;
+            logoCode += *expToken;
+            logoCode += "\n";
+        } else if (!(*expToken).compare("turnRight")) {
+            logoCode += "rt ";
+            expToken++;
+            logoCode += *expToken;
+            logoCode += "\n";
+        } else if (!(*expToken).compare("popPos")) {
+            logoCode += "pu setpos pop \"stackPOS pd\n";
+        } else if (!(*expToken).compare("popAng")) {
+            logoCode += "setheading pop \"stackANG\n";
+        }
+    }
+    return logoCode;
+}
+
+/**
+ * @brief Step by step native interpretation, which computes the sine and
+ *     cosine of every turn and moves one segment at a time. Kept as the
+ *     reference of the native turtle.
+ */
+static void legacyTrace(const string &prod, map<char, string> corresp,
+        const double scale, const double iniX, const double iniY,
+        const double iniAng, Segments &out) {
+    vector<double> posStack, angStack;
+    map<char, vector<pair<string, double> > > programs;
+    map<char, string>::const_iterator corrIter;
+    string::const_iterator charIt;
+    double x = iniX, y = iniY, heading = iniAng, step;
+    double dirX = sin(heading*M_PI/180), dirY = cos(heading*M_PI/180);
+    unsigned int pc;
+    for (corrIter = corresp.begin(); corrIter != corresp.end();
+            corrIter++) {
+        tokenizer<> tok((*corrIter).second);
+        tokenizer<>::iterator expToken;
+        for (expToken = tok.begin(); expToken != tok.end(); expToken++) {
+            pair<string, double> instro(*expToken, 0);
+            if (!instro.first.compare("drawForward") ||
+                    !instro.first.compare("turnLeft") ||
+                    !instro.first.compare("turnRight")) {
+                expToken++;
+                instro.second = atof((*expToken).c_str());
+            }
+            programs[(*corrIter).first].push_back(instro);
+        }
+    }
+    for (charIt = prod.begin(); charIt < prod.end(); charIt++) {
+        const vector<pair<string, double> > &program = programs[*charIt];
+        for (pc = 0; pc < program.size(); pc++) {
+            const string &name = program[pc].first;
+            if (!name.compare("drawForward")) {
+                step = program[pc].second/scale;
+                out.add(x, y, x + step*dirX, y + step*dirY);
+                x += step*dirX;
+                y += step*dirY;
+            } else if (!name.compare("turnLeft") ||
+                    !name.compare("turnRight")) {
+                heading += name.compare("turnLeft") ? program[pc].second :
+                    -program[pc].second;
+                heading = fmod(heading, 360.0);
+                dirX = sin(heading*M_PI/180);
+                dirY = cos(heading*M_PI/180);
+            } else if (!name.compare("pushPos")) {
+                posStack.push_back(x);
+                posStack.push_back(y);
+            } else if (!name.compare("popPos") && (posStack.size() >= 2)) {
+                y = posStack.back();
+                posStack.pop_back();
+                x = posStack.back();
+                posStack.pop_back();
+            } else if (!name.compare("pushAng")) {
+                angStack.push_back(heading);
+            } else if (!name.compare("popAng") && !angStack.empty()) {
+                heading = angStack.back();
+                angStack.pop_back();
+                dirX = sin(heading*M_PI/180);
+                dirY = cos(heading*M_PI/180);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Native turtle: heading table and exact fixed-point moves against
+ *     the step by step interpretation, in segments per second.
+ */
+static int benchTrace(const string &dataDir) {
+    const char* grammars[] = {"plant", "tree", "koch"};
+    const int iterations[] = {9, 8, 7};
+    const double tolerance = 1e-9;
+    string prod, failure;
+    double start, legacyTime, tableTime, error;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    size_t seg;
+    cout << "trace: move tables vs step by step" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(14) << "legacy(seg/s)" <<
+        setw(14) << "table(seg/s)" << setw(10) << "speedup" <<
+        setw(12) << "max error" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        prod = lsys.produce(iterations[g]);
+        Segments legacy, table;
+        start = benchClock();
+        legacyTrace(prod, p.getTurtle(), atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), legacy);
+        legacyTime = benchClock() - start;
+        start = benchClock();
+        Turtle ninja(p.getTurtle());
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), table);
+        tableTime = benchClock() - start;
+        error = 0;
+        if (legacy.size() != table.size()) {
+            error = HUGE_VAL;
+        }
+        for (seg = 0; (seg < table.size()) && (error < HUGE_VAL); seg++) {
+            error = max(error, fabs(legacy.getX0()[seg] -
+                table.getX0()[seg]));
+            error = max(error, fabs(legacy.getY0()[seg] -
+                table.getY0()[seg]));
+            error = max(error, fabs(legacy.getX1()[seg] -
+                table.getX1()[seg]));
+            error = max(error, fabs(legacy.getY1()[seg] -
+                table.getY1()[seg]));
+        }
+        if (error > tolerance) {
+            cout << grammars[g] << ": segments differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << table.size() << scientific << setprecision(3) <<
+            setw(14) << table.size()/legacyTime <<
+            setw(14) << table.size()/tableTime << fixed <<
+            setprecision(2) << setw(9) << legacyTime/tableTime << "x" <<
+            scientific << setprecision(1) << setw(12) << error << fixed <<
+            endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Whether two sets of segments are the same bytes, which tells
+ *     apart e.g. signed zeros that compare equal.
+ */
+static bool sameBytes(const Segments &segs, const Segments &other) {
+    size_t bytes = segs.size()*sizeof(double);
+    return (segs.size() == other.size()) && ((bytes == 0) ||
+        (!memcmp(&segs.getX0()[0], &other.getX0()[0], bytes) &&
+        !memcmp(&segs.getY0()[0], &other.getY0()[0], bytes) &&
+        !memcmp(&segs.getX1()[0], &other.getX1()[0], bytes) &&
+        !memcmp(&segs.getY1()[0], &other.getY1()[0], bytes)));
+}
+
+/**
+ * @brief Native turtle: chunked threads against the serial tracing, with
+ *     the same segments, byte for byte, for any number of threads.
+ */
+static int benchParallelTrace(const string &dataDir) {
+    const char* grammars[] = {"plant", "tree", "koch"};
+    const int iterations[] = {10, 10, 8};
+    unsigned int numThreads = thread::hardware_concurrency();
+    string prod, failure;
+    double start, serialTime, parallelTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "trace: " << numThreads << " threads vs serial" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(12) << "serial(s)" <<
+        setw(12) << "threads(s)" << setw(10) << "speedup" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        prod = lsys.produce(iterations[g]);
+        Turtle ninja(p.getTurtle());
+        Segments serial, parallel, pair;
+        start = benchClock();
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), serial);
+        serialTime = benchClock() - start;
+        start = benchClock();
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), parallel, numThreads);
+        parallelTime = benchClock() - start;
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), pair, 2);
+        if (!sameBytes(pair, parallel)) {
+            cout << grammars[g] << ": thread counts differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        // Bit for bit, as the chunks start from the exact serial states
+        if (!sameBytes(serial, parallel)) {
+            cout << grammars[g] << ": segments differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << parallel.size() << fixed << setprecision(3) <<
+            setw(12) << serialTime << setw(12) << parallelTime <<
+            setprecision(2) << setw(9) << serialTime/parallelTime << "x" <<
+            endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Auto-fit: the bounding box from memoised transforms against
+ *     deriving and tracing the whole drawing, which must then fill the
+ *     view exactly.
+ */
+static int benchExtent(const string &dataDir) {
+    const char* grammars[] = {"plant", "dragon", "koch_island"};
+    const int iterations[] = {9, 16, 6};
+    const double size = 450;
+    const double tolerance = 1e-6;
+    string prod, failure;
+    double start, traceTime, extentTime, error, scale, iniX, iniY;
+    double minX, maxX, minY, maxY;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    size_t seg;
+    cout << "fit: memoised extent vs full trace" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(12) << "trace(s)" <<
+        setw(12) << "extent(s)" << setw(12) << "speedup" <<
+        setw(12) << "max error" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        Turtle ninja(p.getTurtle());
+        Segments unit, fitted;
+        // The box that repeated renders would measure
+        start = benchClock();
+        prod = lsys.produce(iterations[g]);
+        ninja.trace(prod, 1, 0, 0, atof(p.getInitAng().c_str()), unit);
+        minX = *min_element(unit.getX0().begin(), unit.getX0().end());
+        maxX = *max_element(unit.getX0().begin(), unit.getX0().end());
+        minY = *min_element(unit.getY0().begin(), unit.getY0().end());
+        maxY = *max_element(unit.getY0().begin(), unit.getY0().end());
+        minX = min(minX, *min_element(unit.getX1().begin(),
+            unit.getX1().end()));
+        maxX = max(maxX, *max_element(unit.getX1().begin(),
+            unit.getX1().end()));
+        minY = min(minY, *min_element(unit.getY1().begin(),
+            unit.getY1().end()));
+        maxY = max(maxY, *max_element(unit.getY1().begin(),
+            unit.getY1().end()));
+        traceTime = benchClock() - start;
+        start = benchClock();
+        ninja.fit(lsys, iterations[g], atof(p.getInitAng().c_str()), size,
+            scale, iniX, iniY);
+        extentTime = benchClock() - start;
+        // The fitted drawing is centred and its longest side spans the view
+        error = fabs(max(maxX - minX, maxY - minY)/scale - size);
+        ninja.trace(prod, scale, iniX, iniY, atof(p.getInitAng().c_str()),
+            fitted);
+        minX = maxX = minY = maxY = 0;
+        for (seg = 0; seg < fitted.size(); seg++) {
+            minX = min(minX, min(fitted.getX0()[seg], fitted.getX1()[seg]));
+            maxX = max(maxX, max(fitted.getX0()[seg], fitted.getX1()[seg]));
+            minY = min(minY, min(fitted.getY0()[seg], fitted.getY1()[seg]));
+            maxY = max(maxY, max(fitted.getY0()[seg], fitted.getY1()[seg]));
+        }
+        error = max(error, fabs(minX + maxX)/2);
+        error = max(error, fabs(minY + maxY)/2);
+        error = max(error, fabs(max(maxX - minX, maxY - minY) - size));
+        if (error > tolerance) {
+            cout << grammars[g] << ": drawing does not fit" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << unit.size() << fixed << setprecision(3) <<
+            setw(12) << traceTime << scientific << setw(12) << extentTime <<
+            fixed << setprecision(0) << setw(11) << traceTime/extentTime <<
+            "x" << scientific << setprecision(1) << setw(12) << error <<
+            fixed << endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Pixels lit in an image with none lit around them in another one
+ *     of the same size, both as PPM.
+ */
+static size_t strayPixels(const string &image, const string &other) {
+    string magic;
+    size_t width, height, offset, row, column, stray = 0;
+    long dRow, dColumn, r, c;
+    bool near;
+    istringstream header(image);
+    header >> magic >> width >> height;
+    offset = image.size() - 3*width*height;
+    for (row = 0; row < height; row++) {
+        for (column = 0; column < width; column++) {
+            near = image[offset + 3*(row*width + column)] == 0;
+            for (dRow = -1; (dRow <= 1) && !near; dRow++) {
+                for (dColumn = -1; (dColumn <= 1) && !near; dColumn++) {
+                    r = row + dRow;
+                    c = column + dColumn;
+                    near = (r >= 0) && (r < static_cast<long>(height)) &&
+                        (c >= 0) && (c < static_cast<long>(width)) &&
+                        (other[offset + 3*(r*width + c)] != 0);
+                }
+            }
+            stray += !near;
+        }
+    }
+    return stray;
+}
+
+/**
+ * @brief Output optimisation: segments kept after deduplication and
+ *     merging, against the pixels they move in a raster of the drawing.
+ */
+static int benchSimplify(const string &dataDir) {
+    const char* grammars[] = {"plant", "tree", "koch_island", "algae",
+        "sierpinski"};
+    const int iterations[] = {9, 7, 5, 12, 10};
+    const unsigned int size = 1024;
+    const double tolerance = 1e-3;
+    string prod, failure;
+    double start, simplifyTime, changed;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    size_t numSegs, lit;
+    cout << "simplify: deduplicated and merged segments" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(12) << "kept" <<
+        setw(10) << "ratio" << setw(12) << "time(s)" <<
+        setw(12) << "stray" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        prod = lsys.produce(iterations[g]);
+        Turtle ninja(p.getTurtle());
+        Segments segs;
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), segs);
+        numSegs = segs.size();
+        ostringstream before, after;
+        RasterWriter(size, RasterWriter::PPM).write(segs, before);
+        start = benchClock();
+        Simplifier().simplify(segs);
+        simplifyTime = benchClock() - start;
+        RasterWriter(size, RasterWriter::PPM).write(segs, after);
+        // Merged runs may round a pixel apart from their steps, but not
+        // further
+        const string &full = before.str();
+        const string &simple = after.str();
+        lit = count(full.begin(), full.end(), '\xff')/3;
+        changed = full.size() != simple.size() ? HUGE_VAL :
+            static_cast<double>(strayPixels(full, simple) +
+            strayPixels(simple, full))/max(lit, static_cast<size_t>(1));
+        if (changed > tolerance) {
+            cout << grammars[g] << ": drawings differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << numSegs << setw(12) << segs.size() << fixed <<
+            setprecision(1) << setw(9) <<
+            static_cast<double>(numSegs)/segs.size() << "x" <<
+            setprecision(3) << setw(12) << simplifyTime << scientific <<
+            setprecision(1) << setw(12) << changed << fixed << endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Level of detail: expansions smaller than a pixel of the image
+ *     drawn as a single segment, against deriving and tracing them all.
+ */
+static int benchDetail(const string &dataDir) {
+    const char* grammars[] = {"koch", "dragon", "koch_island", "plant"};
+    const int iterations[] = {9, 22, 7, 10};
+    const unsigned int size = 1024;
+    const double tolerance = 1e-6;
+    string prod, failure;
+    double start, fullTime, detailTime, error, stray, scale, iniX, iniY;
+    double minX, maxX, minY, maxY;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    size_t seg, lit;
+    cout << "detail: one pixel in " << size << " vs every segment" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(10) << "drawn" <<
+        setw(11) << "full(s)" << setw(11) << "detail(s)" <<
+        setw(10) << "speedup" << setw(10) << "error" <<
+        setw(10) << "stray" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        Turtle ninja(p.getTurtle());
+        ninja.fit(lsys, iterations[g], atof(p.getInitAng().c_str()), size,
+            scale, iniX, iniY);
+        Segments full, exact, coarse;
+        start = benchClock();
+        prod = lsys.produce(iterations[g]);
+        ninja.trace(prod, scale, iniX, iniY, atof(p.getInitAng().c_str()),
+            full);
+        fullTime = benchClock() - start;
+        start = benchClock();
+        ninja.trace(lsys, iterations[g], 1, scale, iniX, iniY,
+            atof(p.getInitAng().c_str()), coarse);
+        detailTime = benchClock() - start;
+        // With no tolerance every segment is drawn
+        ninja.trace(lsys, iterations[g], 0, scale, iniX, iniY,
+            atof(p.getInitAng().c_str()), exact);
+        error = 0;
+        if (full.size() != exact.size()) {
+            error = HUGE_VAL;
+        }
+        for (seg = 0; (seg < exact.size()) && (error < HUGE_VAL); seg++) {
+            error = max(error, fabs(full.getX0()[seg] - exact.getX0()[seg]));
+            error = max(error, fabs(full.getY0()[seg] - exact.getY0()[seg]));
+            error = max(error, fabs(full.getX1()[seg] - exact.getX1()[seg]));
+            error = max(error, fabs(full.getY1()[seg] - exact.getY1()[seg]));
+        }
+        // Coarse segments stay within a pixel of the drawing, both
+        // pinned to its box so that the images share their frame
+        minX = min(*min_element(full.getX0().begin(), full.getX0().end()),
+            *min_element(full.getX1().begin(), full.getX1().end()));
+        maxX = max(*max_element(full.getX0().begin(), full.getX0().end()),
+            *max_element(full.getX1().begin(), full.getX1().end()));
+        minY = min(*min_element(full.getY0().begin(), full.getY0().end()),
+            *min_element(full.getY1().begin(), full.getY1().end()));
+        maxY = max(*max_element(full.getY0().begin(), full.getY0().end()),
+            *max_element(full.getY1().begin(), full.getY1().end()));
+        full.add(minX, minY, minX, minY);
+        full.add(maxX, maxY, maxX, maxY);
+        coarse.add(minX, minY, minX, minY);
+        coarse.add(maxX, maxY, maxX, maxY);
+        ostringstream before, after;
+        RasterWriter(size, RasterWriter::PPM).write(full, before);
+        RasterWriter(size, RasterWriter::PPM).write(coarse, after);
+        const string &whole = before.str();
+        const string &detailed = after.str();
+        lit = count(whole.begin(), whole.end(), '\xff')/3;
+        stray = whole.size() != detailed.size() ? HUGE_VAL :
+            static_cast<double>(strayPixels(whole, detailed) +
+            strayPixels(detailed, whole))/max(lit, static_cast<size_t>(1));
+        if ((error > tolerance) || (stray > 0.05)) {
+            cout << grammars[g] << ": drawings differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << exact.size() << setw(10) << coarse.size() - 2 <<
+            fixed <<
+            setprecision(3) << setw(11) << fullTime << setw(11) <<
+            detailTime << setprecision(0) << setw(9) <<
+            fullTime/detailTime << "x" << scientific << setprecision(1) <<
+            setw(10) << error << setw(10) << stray << fixed << endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Stream buffer that throws away what it is given.
+ */
+class NullBuffer : public streambuf {
+    protected:
+        streamsize xsputn(const char*, streamsize length) {
+            return length;
+        }
+        int overflow(int value) {
+            return value;
+        }
+};
+
+/**
+ * @brief Turtle in space, streamed to PLY, against the plane turtle:
+ *     the same drawing when there is no pitch nor roll, in time of the
+ *     same order and with heap allocations that do not grow with it.
+ */
+static int benchSpace(const string &dataDir) {
+    const char* grammars[] = {"plant", "koch", "bush"};
+    const int iterations[] = {9, 7, 8};
+    const double tolerance = 1e-3;
+    string prod, failure, magic;
+    double start, planeTime, spaceTime, error;
+    unsigned long long allocs;
+    float coords[6];
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    size_t seg, body;
+    cout << "space: PLY stream vs plane segments" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "segments" << setw(14) << "plane(seg/s)" <<
+        setw(14) << "space(seg/s)" << setw(8) << "ratio" <<
+        setw(8) << "allocs" << setw(12) << "max error" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", failure)) {
+            cout << failure << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        prod = lsys.produce(iterations[g]);
+        Turtle ninja(p.getTurtle());
+        Segments plane;
+        start = benchClock();
+        ninja.trace(prod, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), plane);
+        planeTime = benchClock() - start;
+        NullBuffer discard;
+        ostream sink(&discard);
+        StringSource timed(prod);
+        start = benchClock();
+        allocs = benchAllocations();
+        PlyWriter stream(sink, plane.size());
+        ninja.trace(timed, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), stream);
+        stream.close(failure);
+        allocs = benchAllocations() - allocs;
+        spaceTime = benchClock() - start;
+        // Read back, on the plane only where nothing pitches nor rolls
+        ostringstream file;
+        StringSource checked(prod);
+        PlyWriter written(file, plane.size());
+        ninja.trace(checked, atof(p.getReductionScale().c_str()),
+            atof(p.getInitPos()[0].c_str()), atof(p.getInitPos()[1].c_str()),
+            atof(p.getInitAng().c_str()), written);
+        written.close(failure);
+        const string &ply = file.str();
+        body = ply.find("end_header\n") + 11;
+        error = 0;
+        if ((written.size() != plane.size()) ||
+                (ply.size() != body + 32*plane.size())) {
+            error = HUGE_VAL;
+        }
+        for (seg = 0; (seg < plane.size()) && (error < HUGE_VAL) &&
+                strcmp(grammars[g], "bush"); seg++) {
+            // Little-endian, as the building machine
+            memcpy(coords, ply.data() + body + 24*seg, 24);
+            error = max(error, fabs(coords[0] - plane.getX0()[seg]));
+            error = max(error, fabs(coords[1] - plane.getY0()[seg]));
+            error = max(error, fabs(static_cast<double>(coords[2])));
+            error = max(error, fabs(coords[3] - plane.getX1()[seg]));
+            error = max(error, fabs(coords[4] - plane.getY1()[seg]));
+            error = max(error, fabs(static_cast<double>(coords[5])));
+        }
+        if ((error > tolerance) || (allocs > 16)) {
+            cout << grammars[g] << ": space drawing differs" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << plane.size() << scientific << setprecision(3) <<
+            setw(14) << plane.size()/planeTime <<
+            setw(14) << plane.size()/spaceTime << fixed <<
+            setprecision(2) << setw(8) << spaceTime/planeTime <<
+            setw(8) << allocs << scientific << setprecision(1) <<
+            setw(12) << error << fixed << endl;
+    }
+    return status;
+}
+
+int benchTurtle(const string &dataDir) {
+    const char* grammars[] = {"plant", "sierpinski"};
+    const int iterations[] = {9, 12};
+    string prod, legacy, error;
+    double start, legacyTime, compiledTime;
+    int status = EXIT_SUCCESS;
+    unsigned int g;
+    cout << "turtle: compiled opcodes vs per-symbol lookups" << endl;
+    cout << setw(12) << "grammar" << setw(7) << "iters" <<
+        setw(12) << "symbols" << setw(14) << "legacy(sym/s)" <<
+        setw(14) << "table(sym/s)" << setw(10) << "speedup" << endl;
+    for (g = 0; g < sizeof(grammars)/sizeof(grammars[0]); g++) {
+        Parser p;
+        if (!p.parse(dataDir + "/" + grammars[g] + ".def", error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
+        prod = lsys.produce(iterations[g]);
+        start = benchClock();
+        legacy = legacyRewrite(prod, p.getTurtle(), p.getReductionScale(),
+            p.getInitPos(), p.getInitAng());
+        legacyTime = benchClock() - start;
+        ostringstream compiled;
+        start = benchClock();
+        Turtle ninja(p.getTurtle());
+        ninja.rewrite(prod, p.getReductionScale(), p.getInitPos(),
+            p.getInitAng(), compiled);
+        compiledTime = benchClock() - start;
+        if (legacy != compiled.str()) {
+            cout << grammars[g] << ": drawings differ" << endl;
+            status = EXIT_FAILURE;
+        }
+        cout << setw(12) << grammars[g] << setw(7) << iterations[g] <<
+            setw(12) << prod.size() << scientific << setprecision(3) <<
+            setw(14) << prod.size()/legacyTime <<
+            setw(14) << prod.size()/compiledTime << fixed <<
+            setprecision(2) << setw(9) << legacyTime/compiledTime << "x" <<
+            endl;
+    }
+    if (benchTrace(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchParallelTrace(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchExtent(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchSimplify(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchDetail(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    if (benchSpace(dataDir) != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
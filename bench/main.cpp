@@ -0,0 +1,107 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : main.cpp                                                    |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Bench.hpp"
+#include <string>
+#include <cstdlib>
+#include <iostream>
+#include <sys/time.h>
+
+using namespace std;
+
+double benchClock() {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + now.tv_usec*1e-6;
+}
+
+int main(int argc, const char* argv[]) {
+    string suite = "all";
+    string dataDir = "data";
+    string jsonPath = "profile.json";
+    int status = EXIT_SUCCESS;
+    if (argc > 1) {
+        suite = argv[1];
+    }
+    if (argc > 2) {
+        dataDir = argv[2];
+    }
+    if (argc > 3) {
+        jsonPath = argv[3];
+    }
+    if (!suite.compare("all") || !suite.compare("produce")) {
+        if (benchProduce(dataDir) != EXIT_SUCCESS) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if (!suite.compare("all") || !suite.compare("turtle")) {
+        if (benchTurtle(dataDir) != EXIT_SUCCESS) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if (!suite.compare("all") || !suite.compare("alloc")) {
+        if (benchAlloc(dataDir) != EXIT_SUCCESS) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if (!suite.compare("all") || !suite.compare("batch")) {
+        if (benchBatch(dataDir) != EXIT_SUCCESS) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if (!suite.compare("all") || !suite.compare("parse")) {
+        if (benchParse() != EXIT_SUCCESS) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if (!suite.compare("all") || !suite.compare("raster")) {
+        if (benchRaster(dataDir) != EXIT_SUCCESS) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if (!suite.compare("all") || !suite.compare("profile")) {
+        if (benchProfile(dataDir, jsonPath) != EXIT_SUCCESS) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if (suite.compare("all") && suite.compare("produce") &&
+            suite.compare("turtle") && suite.compare("alloc") &&
+            suite.compare("batch") && suite.compare("parse") &&
+            suite.compare("raster") && suite.compare("profile")) {
+        cout << "usage: bench [all|produce|turtle|alloc|batch|parse|" <<
+            "raster|profile] [dataDir] [profile.json]" << endl;
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
@@ -0,0 +1,191 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Batch.hpp                                                   |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "Parser.hpp"
+#include "Lsystem.hpp"
+#include "ParametricLsystem.hpp"
+#include "Turtle.hpp"
+#include "ExpansionCache.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <istream>
+
+using namespace std;
+
+/**
+ * @class Batch
+ * @brief Many rendering jobs run in a single process.
+ *
+ * The jobs are listed in a manifest, one per line, as
+ * "definition iterations seed backend output", where the iterations may
+ * be "-" to take those of the definition, the backend is "logo", "svg",
+ * "bin", "ppm", "png" (images whose longest side takes the pixels of the
+ * batch) or "ply" (in space), and the output is the file where the job
+ * is written. Blank lines and lines starting with "#" are skipped, e.g.:
+ *
+ * <br/>data/plant.def 6 42 svg plant6.svg
+ * <br/>data/plant.def - 43 logo plant.txt
+ *
+ * Every definition is parsed, and its rules and turtle instructions are
+ * compiled, only once, however many jobs refer to it, and its jobs share
+ * it as it is, each with its own seed, along with a single cache of its
+ * deterministic subtrees. The jobs are then run concurrently on a
+ * work-stealing thread pool. Context-sensitive and parametric rules are
+ * derived by ParametricLsystem, and their modules drawn as by the
+ * single-job run (not in space if by their parameters).
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Batch {
+    public:
+        /**
+         * @brief Batch constructor.
+         * @param pixels The longest side of the raster images.
+         * @post Builds an empty batch.
+         */
+        Batch(const unsigned int pixels = 1024);
+        /**
+         * @brief Load the jobs of a manifest.
+         * @param manifest The manifest.
+         * @param error Where to describe the first error, if any.
+         * @return False if the manifest is malformed or refers to a
+         *     definition that cannot be opened.
+         * @pre Manifest must be open.
+         * @post The jobs are listed and their definitions compiled.
+         */
+        bool load(istream &manifest, string &error);
+        /**
+         * @brief Run all the jobs.
+         * @param numThreads The number of threads to use.
+         * @return The number of jobs that failed, which are reported on
+         *     the standard output.
+         * @pre The manifest must be loaded.
+         * @post Every job is written to its output.
+         */
+        unsigned int run(const unsigned int numThreads) const;
+        /**
+         * @brief Number of jobs.
+         * @return The number of jobs loaded.
+         * @pre None.
+         * @post The number of jobs is returned.
+         */
+        size_t getJobs() const;
+    private:
+        /**
+         * @brief Rendering job.
+         */
+        struct Job {
+            /**
+             * @brief The definition file.
+             */
+            string definition;
+            /**
+             * @brief The number of iterations (negative for those of the
+             *     definition).
+             */
+            int iterations;
+            /**
+             * @brief The seed of the stochastic choices.
+             */
+            unsigned long long seed;
+            /**
+             * @brief The backend.
+             */
+            string backend;
+            /**
+             * @brief The output file.
+             */
+            string output;
+        };
+        /**
+         * @brief Compiled definition, shared by its jobs.
+         */
+        struct Grammar {
+            /**
+             * @brief The definition.
+             */
+            Parser parser;
+            /**
+             * @brief The L-system, compiled with seed zero, whose jobs
+             *     derive it with their own seeds.
+             */
+            Lsystem lsys;
+            /**
+             * @brief The L-system of modules, if the rules are
+             *     context-sensitive or parametric.
+             */
+            ParametricLsystem modules;
+            /**
+             * @brief True if the rules take the L-system of modules.
+             */
+            bool modular;
+            /**
+             * @brief The turtle.
+             */
+            Turtle ninja;
+        };
+        /**
+         * @brief Run a job.
+         * @param job The job.
+         * @param error Where to describe the error, if any.
+         * @return False if the output cannot be opened or written.
+         * @pre The definition of the job must be compiled.
+         * @post The job is written to its output.
+         */
+        bool render(const Job &job, string &error) const;
+        /**
+         * @brief The jobs, in the order of the manifest.
+         */
+        vector<Job> theJobs;
+        /**
+         * @brief Compiled definitions by file name.
+         */
+        map<string, Grammar> theGrammars;
+        /**
+         * @brief Expansions of the deterministic subtrees of the
+         *     context-free definitions, by file name, as deep as their
+         *     deepest job.
+         */
+        map<string, ExpansionCache> theCaches;
+        /**
+         * @brief The longest side of the raster images.
+         */
+        unsigned int thePixels;
+};
+
+#endif
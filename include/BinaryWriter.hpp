@@ -0,0 +1,77 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : BinaryWriter.hpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef BINARYWRITER_HPP
+#define BINARYWRITER_HPP
+
+#include "SegmentWriter.hpp"
+#include "Segments.hpp"
+#include <ostream>
+
+using namespace std;
+
+/**
+ * @class BinaryWriter
+ * @brief Compact binary output of the segments.
+ *
+ * The format is a header followed by the coordinate arrays, all of them
+ * in little-endian byte order:
+ *
+ * - the magic "LSEG" (4 bytes),
+ * - the format version, currently 1 (unsigned 32-bit integer),
+ * - the number of segments n (unsigned 64-bit integer),
+ * - the n start abscissas x0, then the n start ordinates y0, then the
+ *   n end abscissas x1, and finally the n end ordinates y1 (64-bit
+ *   IEEE 754 doubles).
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class BinaryWriter : public SegmentWriter {
+    public:
+        /**
+         * @brief Binary writer constructor.
+         * @post Builds the binary writer.
+         */
+        BinaryWriter();
+        /**
+         * @brief Write the segments.
+         * @param segs The segments.
+         * @param out Where to write the segments, in binary mode.
+         * @pre None.
+         * @post The segments are written in the binary format.
+         */
+        void write(const Segments &segs, ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,129 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Derivation.hpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef DERIVATION_HPP
+#define DERIVATION_HPP
+
+#include "SymbolSource.hpp"
+#include "Lsystem.hpp"
+#include "ExpansionCache.hpp"
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class Derivation
+ * @brief Lazy derivation of an L-system production.
+ *
+ * Walks the derivation tree depth-first and yields the symbols of the
+ * last generation on demand, so the production is never materialised.
+ * The walk keeps one frame (the successor being scanned and the offset
+ * in it) for every generation, plus the position reached in every
+ * generation to key the stochastic choices, which makes the memory
+ * proportional to the number of iterations. The symbols are the same
+ * that Lsystem::produce delivers for the same seed.
+ *
+ * Given an expansion cache, the subtrees whose expansion is stored are
+ * copied at once instead of being walked, and only their lengths are
+ * added to the positions of the generations they span.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Derivation : public SymbolSource {
+    public:
+        /**
+         * @brief Derivation constructor.
+         * @param lsys The L-system.
+         * @param numIter The number of iterations to run.
+         * @param cache The expansion cache, if any.
+         * @pre The L-system (and the cache) must be defined and outlive
+         *     the derivation.
+         * @post The derivation is positioned at the first symbol.
+         */
+        Derivation(const Lsystem &lsys, const int numIter,
+                const ExpansionCache *cache = NULL);
+        /**
+         * @brief Read the next block of symbols.
+         * @param buffer Where to write the symbols.
+         * @param size The capacity of the buffer.
+         * @return The number of symbols read, zero at the end.
+         * @pre The buffer must hold size symbols.
+         * @post The symbols are derived and consumed.
+         */
+        size_t read(char* buffer, const size_t size);
+    private:
+        /**
+         * @brief Symbols being scanned in a generation.
+         */
+        struct Frame {
+            /**
+             * @brief The symbols.
+             */
+            const char* symbols;
+            /**
+             * @brief The number of symbols.
+             */
+            size_t length;
+            /**
+             * @brief The next symbol to scan.
+             */
+            size_t offset;
+        };
+        /**
+         * @brief The L-system.
+         */
+        const Lsystem &theLsystem;
+        /**
+         * @brief The expansion cache, if any.
+         */
+        const ExpansionCache *theCache;
+        /**
+         * @brief The number of iterations.
+         */
+        unsigned int theNumIter;
+        /**
+         * @brief One frame per generation, the axiom at the bottom.
+         */
+        vector<Frame> theStack;
+        /**
+         * @brief Position of the next symbol in every generation.
+         */
+        vector<unsigned long long> theCounters;
+        /**
+         * @brief Cached expansion being copied.
+         */
+        Frame theCopy;
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : DerivationSession.hpp                                       |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef DERIVATIONSESSION_HPP
+#define DERIVATIONSESSION_HPP
+
+#include "Lsystem.hpp"
+#include <string>
+
+using namespace std;
+
+/**
+ * @class DerivationSession
+ * @brief Stateful derivation of an L-system, one generation at a time.
+ *
+ * The session keeps the last generation derived, so that going from
+ * generation n to n+1 takes a single rewriting pass instead of deriving
+ * again from the axiom. The production of any generation is the same as
+ * Lsystem::produce() would give for that number of iterations.
+ *
+ * A generation may be kept as a checkpoint in memory, to go back to it
+ * later, or saved to disk, so that a long run may be resumed after a
+ * crash. The checkpoint file is a production file (see ProductionFile).
+ * It is written to a temporary file that is flushed to disk and then
+ * renamed, so a crash while saving leaves the previous checkpoint
+ * intact.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class DerivationSession {
+    public:
+        /**
+         * @brief Session constructor.
+         * @param lsys The L-system.
+         * @param numThreads The number of threads of every pass.
+         * @pre The L-system must be defined, and outlive the session.
+         * @post The session stands at the axiom, generation zero.
+         */
+        DerivationSession(const Lsystem &lsys,
+                const unsigned int numThreads = 1);
+        /**
+         * @brief Derive the next generations.
+         * @param count The number of generations.
+         * @pre None.
+         * @post The session stands count generations further.
+         */
+        void advance(const unsigned int count = 1);
+        /**
+         * @brief Keep the current generation in memory.
+         * @pre None.
+         * @post The checkpoint is replaced by the current generation.
+         */
+        void checkpoint();
+        /**
+         * @brief Go back to the checkpoint in memory.
+         * @return False if there is no checkpoint.
+         * @pre None.
+         * @post The session stands at the generation of the checkpoint.
+         */
+        bool rollback();
+        /**
+         * @brief Save the current generation to disk.
+         * @param path The checkpoint file.
+         * @param error Where to describe the error, if any.
+         * @return False if the file cannot be written.
+         * @pre None.
+         * @post The file holds the current generation.
+         */
+        bool save(const string &path, string &error) const;
+        /**
+         * @brief Resume from a generation saved to disk.
+         * @param path The checkpoint file.
+         * @param error Where to describe the error, if any.
+         * @return False if the file cannot be read, or it was saved for
+         *     another grammar or seed (and the session is left as is).
+         * @pre None.
+         * @post The session stands at the generation of the file.
+         */
+        bool load(const string &path, string &error);
+        /**
+         * @brief Current generation getter.
+         * @return The symbols of the current generation.
+         * @pre None.
+         * @post The current generation is returned.
+         */
+        const string& getProduction() const;
+        /**
+         * @brief Current generation number getter.
+         * @return The number of iterations derived so far.
+         * @pre None.
+         * @post The generation number is returned.
+         */
+        unsigned int getEpoch() const;
+    private:
+        /**
+         * @brief The L-system.
+         */
+        const Lsystem &theLsystem;
+        /**
+         * @brief The number of threads of every pass.
+         */
+        unsigned int theNumThreads;
+        /**
+         * @brief The current generation.
+         */
+        string theProduction;
+        /**
+         * @brief Buffer of the next generation, swapped with the current.
+         */
+        string theNext;
+        /**
+         * @brief The current generation number.
+         */
+        unsigned int theEpoch;
+        /**
+         * @brief The generation kept in memory.
+         */
+        string theCheckpoint;
+        /**
+         * @brief The generation number of the checkpoint (negative if
+         *     there is none).
+         */
+        int theCheckpointEpoch;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ExpansionCache.hpp                                          |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef EXPANSIONCACHE_HPP
+#define EXPANSIONCACHE_HPP
+
+#include "Lsystem.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class ExpansionCache
+ * @brief Memoised expansions of the symbols of an L-system.
+ *
+ * A symbol whose rules, and the rules of all the symbols it eventually
+ * rewrites into, are deterministic always expands to the same symbols
+ * after a given number of generations, wherever it appears. The cache
+ * keeps the length of these expansions for every depth up to the number
+ * of iterations, and the expanded symbols themselves for as many depths
+ * as fit in a memory budget, so that the derivation may copy a whole
+ * subtree at once (or only account for its length) instead of rewriting
+ * it generation by generation.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class ExpansionCache {
+    public:
+        /**
+         * @brief Expansion cache constructor.
+         * @param lsys The L-system.
+         * @param maxDepth The deepest expansion to cache.
+         * @param budget The maximum number of cached symbols.
+         * @pre The L-system must be defined and outlive the cache.
+         * @post The lengths are computed and the expansions that fit in
+         *     the budget are stored, shallowest first.
+         */
+        ExpansionCache(const Lsystem &lsys, const int maxDepth,
+                const size_t budget = 1 << 24);
+        /**
+         * @brief Whether the expansions of a symbol are deterministic.
+         * @param symbol The symbol.
+         * @return True for constants and for variables whose whole
+         *     derivation tree is free of stochastic choices.
+         * @pre None.
+         * @post The closure of the symbol is returned.
+         */
+        bool isClosed(const char symbol) const;
+        /**
+         * @brief Length of the expansion of a symbol.
+         * @param symbol The symbol.
+         * @param depth The number of generations.
+         * @return The number of symbols, saturated at the largest
+         *     representable value.
+         * @pre The symbol must be closed and the depth cached.
+         * @post The length is returned.
+         */
+        unsigned long long length(const char symbol,
+                const unsigned int depth) const;
+        /**
+         * @brief Stored expansion of a symbol.
+         * @param symbol The symbol.
+         * @param depth The number of generations.
+         * @param expansion Where to point to the expanded symbols.
+         * @param length Where to put the number of expanded symbols.
+         * @return False if the expansion is not stored (and the outputs
+         *     are left untouched).
+         * @pre None.
+         * @post The expansion is located.
+         */
+        bool lookup(const char symbol, const unsigned int depth,
+                const char* &expansion, size_t &length) const;
+        /**
+         * @brief Whether all the expansions of some symbols are stored.
+         * @param symbols The symbols.
+         * @param depth The number of generations.
+         * @return True if every symbol is a constant or has its
+         *     expansion stored.
+         * @pre None.
+         * @post The symbols are checked.
+         */
+        bool covers(const string &symbols, const unsigned int depth) const;
+    private:
+        /**
+         * @brief Cached expansion of a symbol at a depth.
+         */
+        struct Entry {
+            /**
+             * @brief The number of expanded symbols.
+             */
+            unsigned long long length;
+            /**
+             * @brief Offset of the expansion in the pool.
+             */
+            size_t offset;
+            /**
+             * @brief Whether the expansion is stored in the pool.
+             */
+            bool stored;
+        };
+        /**
+         * @brief The L-system.
+         */
+        const Lsystem &theLsystem;
+        /**
+         * @brief The deepest cached expansion.
+         */
+        unsigned int theMaxDepth;
+        /**
+         * @brief Closure of every symbol.
+         */
+        bool theClosed[256];
+        /**
+         * @brief Entries by depth, then by symbol.
+         */
+        vector<Entry> theEntries;
+        /**
+         * @brief All the stored expansions, one after the other.
+         */
+        string thePool;
+};
+
+#endif
@@ -0,0 +1,227 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Expression.hpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class Expression
+ * @brief Arithmetic expression of the parameters of a rule, compiled
+ *     into stack-machine bytecode.
+ *
+ * The expression is parsed once into a flat sequence of instructions
+ * that is then evaluated on a small stack for every module the rule
+ * rewrites, instead of interpreting its text every time. It may use
+ * numbers, the formal parameters of the rule, parentheses, the
+ * arithmetic operators "+", "-", "*", "/", "^" (power), the comparisons
+ * "<", ">", "<=", ">=", "==", "!=" and the logical operators "&&", "||"
+ * and "!", with the usual precedence. Comparisons and logical operators
+ * yield one if true and zero otherwise.
+ *
+ * Constant subexpressions are folded as they are compiled, and an
+ * arithmetic or comparison operator whose right operand is a constant
+ * takes it as an immediate, so "l/3" or "l > 2" is two instructions,
+ * which are evaluated without the stack. Otherwise, the value on top of
+ * the stack is kept apart, in a register, while the expression is
+ * evaluated.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Expression {
+    public:
+        /**
+         * @brief Expression constructor.
+         * @post Builds the constant expression zero.
+         */
+        Expression();
+        /**
+         * @brief Compile an expression.
+         * @param text The expression.
+         * @param formals The names of the formal parameters, which are
+         *     the slots of the evaluation in this order.
+         * @param error Where to describe the error, if any.
+         * @return False if the expression is malformed.
+         * @pre None.
+         * @post The bytecode is built.
+         */
+        bool compile(const string &text, const vector<string> &formals,
+                string &error);
+        /**
+         * @brief Evaluate the expression.
+         * @param slots The values of the formal parameters.
+         * @return The value of the expression.
+         * @pre The slots must hold every formal parameter.
+         * @post The expression is evaluated.
+         */
+        double evaluate(const double* slots) const;
+    private:
+        /**
+         * @brief Bytecode opcodes.
+         */
+        enum Opcode {
+            CONSTANT,
+            SLOT,
+            ADD,
+            SUBTRACT,
+            MULTIPLY,
+            DIVIDE,
+            POWER,
+            NEGATE,
+            LESS,
+            GREATER,
+            LESS_EQUAL,
+            GREATER_EQUAL,
+            EQUAL,
+            NOT_EQUAL,
+            AND,
+            OR,
+            NOT,
+            ADD_CONSTANT,
+            SUBTRACT_CONSTANT,
+            MULTIPLY_CONSTANT,
+            DIVIDE_CONSTANT,
+            LESS_CONSTANT,
+            GREATER_CONSTANT,
+            LESS_EQUAL_CONSTANT,
+            GREATER_EQUAL_CONSTANT,
+            EQUAL_CONSTANT,
+            NOT_EQUAL_CONSTANT
+        };
+        /**
+         * @brief Bytecode instruction.
+         */
+        struct Instruction {
+            /**
+             * @brief The opcode.
+             */
+            Opcode opcode;
+            /**
+             * @brief The slot of a formal parameter.
+             */
+            unsigned int slot;
+            /**
+             * @brief The value of a constant, or of an immediate operand.
+             */
+            double value;
+        };
+        /**
+         * @brief Evaluate the bytecode on the stack.
+         * @param slots The values of the formal parameters.
+         * @return The value of the expression.
+         */
+        double run(const double* slots) const;
+        /**
+         * @brief Compile a disjunction, the lowest precedence level.
+         * @return False if malformed.
+         */
+        bool parseOr();
+        /**
+         * @brief Compile a conjunction.
+         * @return False if malformed.
+         */
+        bool parseAnd();
+        /**
+         * @brief Compile a comparison.
+         * @return False if malformed.
+         */
+        bool parseComparison();
+        /**
+         * @brief Compile a sum or a difference.
+         * @return False if malformed.
+         */
+        bool parseSum();
+        /**
+         * @brief Compile a product or a quotient.
+         * @return False if malformed.
+         */
+        bool parseProduct();
+        /**
+         * @brief Compile a negation or a power.
+         * @return False if malformed.
+         */
+        bool parseUnary();
+        /**
+         * @brief Compile a number, a parameter or a parenthesis.
+         * @return False if malformed.
+         */
+        bool parsePrimary();
+        /**
+         * @brief Skip the blanks and match an operator.
+         * @param op The operator.
+         * @return True if matched (and consumed).
+         */
+        bool accept(const char* op);
+        /**
+         * @brief Append an instruction, folding it into the previous ones
+         *     if they are constant.
+         * @param opcode The opcode.
+         * @param slot The slot of a formal parameter.
+         * @param value The value of a constant.
+         */
+        void emit(const Opcode opcode, const unsigned int slot = 0,
+                const double value = 0);
+        /**
+         * @brief The bytecode.
+         */
+        vector<Instruction> theCode;
+        /**
+         * @brief True if the bytecode is a parameter or a constant, with
+         *     at most an immediate operand.
+         */
+        bool theShort;
+        /**
+         * @brief Text being compiled.
+         */
+        string theText;
+        /**
+         * @brief Position of the compilation in the text.
+         */
+        size_t thePosition;
+        /**
+         * @brief Formal parameters of the compilation.
+         */
+        vector<string> theFormals;
+        /**
+         * @brief Error of the compilation.
+         */
+        string theError;
+};
+
+#endif
@@ -0,0 +1,299 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Extent.hpp                                                  |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef EXTENT_HPP
+#define EXTENT_HPP
+
+#include "Lsystem.hpp"
+#include "Turtle.hpp"
+#include "Segments.hpp"
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class Extent
+ * @brief Bounding box of a drawing, computed without rendering it.
+ *
+ * The turtle is run over the production without tracing any segment,
+ * only keeping its state and the box of the positions it draws to, at
+ * unit scale from the origin.
+ *
+ * If the grammar is deterministic and the turns are discrete, the
+ * production is not even derived. The effect of the expansion of a
+ * symbol after a number of generations, when started with a given
+ * heading, is a relative move, a final heading and a box relative to the
+ * start, whatever it is surrounded by, as long as the expansion leaves
+ * the stacks as it finds them (e.g., brackets that match). These
+ * transforms are memoised per symbol, depth and heading and composed,
+ * so the box takes a few operations per rule and generation instead of
+ * one per symbol of the production. The symbols whose expansions do not
+ * match their brackets are expanded one level further.
+ *
+ * Otherwise the production is derived lazily (see Derivation) and
+ * streamed through the turtle, which still takes no memory for it.
+ *
+ * The same transforms give a level of detail drawing: the expansion of
+ * a symbol whose box is smaller than a tolerance is drawn as a single
+ * segment from where it starts to where it ends, instead of being
+ * expanded further, so the work depends on the size of the output
+ * rather than on the number of iterations.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Extent {
+    public:
+        /**
+         * @brief Extent constructor.
+         * @param lsys The L-system.
+         * @param ninja The turtle.
+         * @param numIter The number of iterations to run.
+         * @param iniAng The initial angle.
+         * @pre The L-system and the turtle must be defined.
+         * @post The bounding box of the drawing is computed.
+         */
+        Extent(const Lsystem &lsys, const Turtle &ninja, const int numIter,
+                const double iniAng);
+        /**
+         * @brief Whether anything is drawn.
+         * @return False if the drawing has no segment.
+         */
+        bool isEmpty() const;
+        /**
+         * @brief Whether the transforms were memoised.
+         * @return False if the production was streamed instead.
+         */
+        bool isMemoised() const;
+        /**
+         * @brief Smallest abscissa drawn, at unit scale from the origin.
+         */
+        double getMinX() const;
+        /**
+         * @brief Largest abscissa drawn, at unit scale from the origin.
+         */
+        double getMaxX() const;
+        /**
+         * @brief Smallest ordinate drawn, at unit scale from the origin.
+         */
+        double getMinY() const;
+        /**
+         * @brief Largest ordinate drawn, at unit scale from the origin.
+         */
+        double getMaxY() const;
+        /**
+         * @brief Scale and initial position that fit the drawing in a
+         *     square view centred at the origin.
+         * @param size The side of the view.
+         * @param scale Where to put the drawing reduction scale.
+         * @param iniX Where to put the initial abscissa.
+         * @param iniY Where to put the initial ordinate.
+         * @pre The drawing must not be empty.
+         * @post The drawing is centred and its longest side spans the
+         *     view.
+         */
+        void fit(const double size, double &scale, double &iniX,
+                double &iniY) const;
+        /**
+         * @brief Trace the line segments of the drawing down to a level
+         *     of detail.
+         * @param tolerance The largest side of the box of an expansion
+         *     drawn as a single segment, in drawing units.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param out Where to append the segments.
+         * @pre The transforms must be memoised.
+         * @post The segments are drawn in order, each one standing for
+         *     an expansion smaller than the tolerance or for a forward
+         *     move. With no tolerance they are those of Turtle::trace.
+         */
+        void trace(const double tolerance, const double scale,
+                const double iniX, const double iniY, Segments &out);
+        /**
+         * @brief Whether the transforms of a drawing can be memoised.
+         * @param lsys The L-system.
+         * @param ninja The turtle.
+         * @return True if the grammar is deterministic and the turns
+         *     are discrete.
+         */
+        static bool isMemoisable(const Lsystem &lsys, const Turtle &ninja);
+    private:
+        /**
+         * @brief Box of the positions drawn to.
+         */
+        struct Box {
+            double minX, maxX, minY, maxY;
+            /**
+             * @brief Whether anything is drawn.
+             */
+            bool drawn;
+        };
+        /**
+         * @brief State of the turtle.
+         */
+        struct State {
+            double x, y;
+            /**
+             * @brief The heading index, if it is discrete.
+             */
+            int index;
+            /**
+             * @brief The heading in degrees, if it is continuous.
+             */
+            double heading;
+            /**
+             * @brief The saved positions, as pairs of coordinates.
+             */
+            vector<double> posStack;
+            /**
+             * @brief The saved headings (or heading indices).
+             */
+            vector<double> angStack;
+            Box box;
+        };
+        /**
+         * @brief Effect of an expansion on the stacks: the number of
+         *     entries it pops from those it is handed and the number it
+         *     leaves pushed, for positions and headings.
+         */
+        struct Balance {
+            unsigned int posPops, posPushes, angPops, angPushes;
+            bool known;
+        };
+        /**
+         * @brief Effect of an expansion on the turtle, from the origin.
+         */
+        struct Transform {
+            double x, y;
+            /**
+             * @brief The final heading index.
+             */
+            int index;
+            Box box;
+            bool known;
+        };
+        /**
+         * @brief Run the turtle over the expansion of a symbol.
+         * @param symbol The symbol.
+         * @param depth The number of generations.
+         * @param state The state, moved.
+         */
+        void walk(const char symbol, const int depth, State &state);
+        /**
+         * @brief Trace the expansion of a symbol, down to a level of
+         *     detail.
+         * @param symbol The symbol.
+         * @param depth The number of generations.
+         * @param limit The largest side of an expansion drawn as a
+         *     single segment, at unit scale.
+         * @param state The state, moved.
+         * @param out Where to append the segments, at unit scale.
+         */
+        void detail(const char symbol, const int depth, const double limit,
+                State &state, Segments &out);
+        /**
+         * @brief Run the program of a symbol.
+         * @param symbol The symbol.
+         * @param state The state, moved.
+         * @param out Where to append the segments, if any.
+         */
+        void run(const char symbol, State &state,
+                Segments* out = NULL) const;
+        /**
+         * @brief Stack effect of the expansion of a symbol.
+         * @param symbol The symbol.
+         * @param depth The number of generations.
+         * @return The balance, memoised.
+         */
+        const Balance& balance(const char symbol, const int depth);
+        /**
+         * @brief Effect of the expansion of a balanced symbol.
+         * @param symbol The symbol.
+         * @param depth The number of generations.
+         * @param index The initial heading index.
+         * @return The transform, memoised.
+         */
+        const Transform& transform(const char symbol, const int depth,
+                const int index);
+        /**
+         * @brief Add a point to a box.
+         */
+        static void include(Box &box, const double x, const double y);
+        /**
+         * @brief The L-system.
+         */
+        const Lsystem &theLsystem;
+        /**
+         * @brief The turtle.
+         */
+        const Turtle &theTurtle;
+        /**
+         * @brief The number of iterations.
+         */
+        int theNumIter;
+        /**
+         * @brief The initial angle.
+         */
+        double theIniAng;
+        /**
+         * @brief Sines and cosines of the discrete headings.
+         */
+        vector<double> theSin, theCos;
+        /**
+         * @brief Index of every variable, -1 for constants.
+         */
+        int theIndex[256];
+        /**
+         * @brief Number of variables.
+         */
+        int theNumVariables;
+        /**
+         * @brief Memoised balances, by depth and variable.
+         */
+        vector<Balance> theBalances;
+        /**
+         * @brief Memoised transforms, by depth, variable and heading.
+         */
+        vector<Transform> theTransforms;
+        /**
+         * @brief Whether the transforms were memoised.
+         */
+        bool theMemoised;
+        /**
+         * @brief The bounding box.
+         */
+        Box theBox;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Growth.hpp                                                  |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef GROWTH_HPP
+#define GROWTH_HPP
+
+#include "Lsystem.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class Growth
+ * @brief Closed-form size analysis of an L-system production.
+ *
+ * The number of occurrences of every symbol after a generation is a
+ * linear function of the occurrences in the previous one, given by the
+ * production matrix, whose entry (i, j) counts the symbols j in the
+ * successor of the symbol i. The counts after n iterations are thus the
+ * counts of the axiom times the n-th power of the matrix, which is
+ * computed by repeated squaring without deriving the production.
+ *
+ * The counts are exact (in 128-bit integers, saturated on overflow)
+ * when all the symbols reached from the axiom are deterministic. The
+ * expected counts are also given, with every rule weighted by its
+ * probability, which is what stochastic grammars produce on average.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Growth {
+    public:
+        /**
+         * @brief Exact symbol count.
+         */
+        typedef unsigned __int128 Count;
+        /**
+         * @brief Growth constructor.
+         * @param lsys The L-system.
+         * @param numIter The number of iterations to run.
+         * @pre The L-system must be defined.
+         * @post The symbol counts of the production are computed.
+         */
+        Growth(const Lsystem &lsys, const int numIter);
+        /**
+         * @brief Whether the exact counts are available.
+         * @return False if some reachable symbol is stochastic or some
+         *     count overflows.
+         * @pre None.
+         * @post The exactness is returned.
+         */
+        bool isExact() const;
+        /**
+         * @brief Exact length of the production.
+         * @return The number of symbols, saturated on overflow.
+         * @pre The counts must be exact to be meaningful.
+         * @post The length is returned.
+         */
+        Count getLength() const;
+        /**
+         * @brief Exact count of a symbol in the production.
+         * @param symbol The symbol.
+         * @return The number of occurrences, saturated on overflow.
+         * @pre The counts must be exact to be meaningful.
+         * @post The count is returned.
+         */
+        Count getCount(const char symbol) const;
+        /**
+         * @brief Expected length of the production.
+         * @return The expected number of symbols.
+         * @pre None.
+         * @post The expected length is returned.
+         */
+        double getExpectedLength() const;
+        /**
+         * @brief Expected count of a symbol in the production.
+         * @param symbol The symbol.
+         * @return The expected number of occurrences.
+         * @pre None.
+         * @post The expected count is returned.
+         */
+        double getExpectedCount(const char symbol) const;
+        /**
+         * @brief Symbols reached from the axiom.
+         * @return The symbols, in order of appearance.
+         * @pre None.
+         * @post The symbols are returned.
+         */
+        const string& getSymbols() const;
+        /**
+         * @brief Decimal representation of a count.
+         * @param value The count.
+         * @return The digits.
+         * @pre None.
+         * @post The count is formatted.
+         */
+        static string format(const Count value);
+    private:
+        /**
+         * @brief Symbols reached from the axiom.
+         */
+        string theSymbols;
+        /**
+         * @brief Index of every symbol among the reached ones (or -1).
+         */
+        int theIndex[256];
+        /**
+         * @brief Whether all the reached symbols are deterministic.
+         */
+        bool theDeterministic;
+        /**
+         * @brief Whether some count has overflowed.
+         */
+        bool theOverflow;
+        /**
+         * @brief Exact length of the production.
+         */
+        Count theLength;
+        /**
+         * @brief Exact counts by reached symbol.
+         */
+        vector<Count> theCounts;
+        /**
+         * @brief Expected counts by reached symbol.
+         */
+        vector<double> theExpected;
+};
+
+#endif
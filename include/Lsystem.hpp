@@ -35,12 +35,18 @@
 #ifndef LSYSTEM_HPP
 #define LSYSTEM_HPP
 
+#include "Random.hpp"
+#include "Rope.hpp"
 #include <string>
 #include <set>
 #include <map>
+#include <vector>
+#include <memory_resource>
 
 using namespace std;
 
+class ExpansionCache;
+
 /**
  * @class Lsystem
  * @brief Structure of the L-system, which consists of an alphabet of 
@@ -51,12 +57,20 @@ using namespace std;
  * that are not expanded by any production rule.
  *
  * In case more than one production rule is available for a given symbol,
- * i.e., a stochastic grammar, a choice is taken according to an uniform
- * probability distribution among the possible rules.
+ * i.e., a stochastic grammar, a choice is taken according to the weights
+ * of the possible rules (an uniform probability distribution if they are
+ * equally weighted). The choice is drawn from a counter-based random
+ * generator keyed by the generation and the position of the symbol, so
+ * a given seed always yields the same production.
+ *
+ * The production rules are compiled once at construction into a flat
+ * table indexed by symbol, so that the derivation does not need to walk
+ * the rule multimap for every symbol of every generation.
  *
  * @author Alexandre Trilla (atrilla)
  */
 class Lsystem {
+    friend class DerivationSession;
     public:
         /**
          * @brief Plain L-system constructor.
@@ -68,22 +82,169 @@ class Lsystem {
          * @brief Parametric L-system constructor.
          * @param vars The variables.
          * @param start The initial axiom.
-         * @param rules The production rules.
+         * @param rules The production rules, i.e., the successor and the
+         *     weight of every rule by predecessor.
+         * @param seed The seed of the stochastic choices.
          * @pre The L-system definition must be consistent.
          * @post Initialises the defined L-system.
          */
         Lsystem(const set<char> &vars, const string start,
-                const multimap<char, string> &rules);
+                const multimap<char, pair<string, double> > &rules,
+                const unsigned long long seed = 0);
         /**
          * @brief Generate a production by iterating the system on the
          *     initial axiom.
          * A stochastic L-system is allowed.
+         *
+         * Each generation is derived in two passes: the first one
+         * computes the exact length of the next generation from the
+         * successor lengths, and the second one writes it into a single
+         * allocation. Two buffers are swapped between generations, so the
+         * memory stays at about twice the size of the final production.
+         *
+         * Each generation may be split into chunks for several threads:
+         * the output offset of every chunk is computed with a prefix sum
+         * of the chunk lengths, and the chunks are written concurrently
+         * into the shared output. The result is identical to the serial
+         * derivation for the same seed.
+         *
+         * Given an expansion cache, the derivation stops rewriting as
+         * soon as the cache holds the expansions of all the symbols of
+         * the current generation for the remaining iterations, and
+         * copies them into the final production instead.
          * @param numIter The number of iterations to run.
+         * @param numThreads The number of threads to use.
+         * @param cache The expansion cache, if any.
          * @return Sequence of symbols by the end of the iteration.
          * @pre The parametric L-system must be defined.
          * @post Produces a sequence of symbols by iteration.
          */
-        string produce(const int numIter) const;
+        string produce(const int numIter,
+                const unsigned int numThreads = 1,
+                const ExpansionCache *cache = NULL) const;
+        /**
+         * @brief Generate a production with another seed.
+         *
+         * The compiled rules are shared as they are, so that many
+         * productions of the same grammar, each with its own seed, may be
+         * derived concurrently from a single L-system.
+         * @param numIter The number of iterations to run.
+         * @param random The generator of the stochastic choices.
+         * @param numThreads The number of threads to use.
+         * @param cache The expansion cache, if any.
+         * @return Sequence of symbols by the end of the iteration.
+         * @pre The parametric L-system must be defined.
+         * @post Produces the same symbols as an L-system seeded as the
+         *     generator.
+         */
+        string produce(const int numIter, const Random &random,
+                const unsigned int numThreads = 1,
+                const ExpansionCache *cache = NULL) const;
+        /**
+         * @brief Generate a production as a rope.
+         *
+         * The subtrees of the deterministic symbols are built once for
+         * every depth and shared, so the rope of a deterministic grammar
+         * takes a few nodes per symbol and iteration. The stochastic
+         * symbols get a node for every occurrence, with the same choices
+         * as the flat derivation for the same seed.
+         *
+         * The scratch of the construction (the parts of every node and
+         * the nodes built so far) may be allocated from a monotonic
+         * resource, and released at once with it.
+         * @param numIter The number of iterations to run.
+         * @param memory The memory resource of the scratch.
+         * @return The production.
+         * @pre The parametric L-system must be defined.
+         * @post Produces the same symbols as produce().
+         */
+        Rope produceRope(const int numIter, pmr::memory_resource *memory =
+                pmr::get_default_resource()) const;
+        /**
+         * @brief Generate a production into a file, out of core.
+         *
+         * Every generation is written to a memory-mapped file while the
+         * previous one is read from another, in two sequential passes
+         * (measure, then rewrite) over windows of symbols, and the pages
+         * of every window are released once it is done. So the memory
+         * taken does not depend on the length of the production, which
+         * is only bound by the disk. The file is in the format of
+         * ProductionFile.
+         * @param numIter The number of iterations to run.
+         * @param path The file of the production.
+         * @param error Where to describe the error, if any.
+         * @return False if a generation cannot be written.
+         * @pre The parametric L-system must be defined.
+         * @post The file holds the same symbols as produce(), and the
+         *     intermediate generations are removed.
+         */
+        bool produceFile(const int numIter, const string &path,
+                string &error) const;
+        /**
+         * @brief Axiom getter.
+         * @return The initial axiom.
+         * @pre None.
+         * @post The initial axiom is returned.
+         */
+        const string& getAxiom() const;
+        /**
+         * @brief Seed getter.
+         * @return The seed of the stochastic choices.
+         * @pre None.
+         * @post The seed is returned.
+         */
+        unsigned long long getSeed() const;
+        /**
+         * @brief Fingerprint of the axiom and the compiled rules.
+         * @return The FNV-1a hash of the grammar.
+         * @pre The L-system must be defined.
+         * @post The same definition always yields the same fingerprint,
+         *     whatever the seed.
+         */
+        unsigned long long getFingerprint() const;
+        /**
+         * @brief Whether the productions depend on the seed.
+         * @return True if a symbol has several production rules.
+         * @pre The L-system must be defined.
+         * @post Whether the L-system is stochastic is returned.
+         */
+        bool isStochastic() const;
+        /**
+         * @brief Successor of a single symbol.
+         * @param symbol The symbol.
+         * @param epoch The generation of the symbol.
+         * @param position The position of the symbol in its generation.
+         * @param successor Where to point to the successor symbols.
+         * @param length Where to put the length of the successor.
+         * @return False if the symbol is a constant (and the successor is
+         *     left untouched).
+         * @pre The L-system must be defined.
+         * @post Chooses the same successor as the derivation does.
+         */
+        bool expand(const char symbol, const unsigned int epoch,
+                const unsigned long long position, const char* &successor,
+                size_t &length) const;
+        /**
+         * @brief Number of production rules of a symbol.
+         * @param symbol The symbol.
+         * @return The number of alternatives, zero for constants and one
+         *     for deterministic variables.
+         * @pre The L-system must be defined.
+         * @post The number of alternatives is returned.
+         */
+        unsigned int getAlternatives(const char symbol) const;
+        /**
+         * @brief Production rule of a symbol.
+         * @param symbol The symbol.
+         * @param alt The index of the alternative.
+         * @param successor Where to point to the successor symbols.
+         * @param length Where to put the length of the successor.
+         * @return The probability of the alternative.
+         * @pre The index must be below the number of alternatives.
+         * @post The successor of the alternative is located.
+         */
+        double getAlternative(const char symbol, const unsigned int alt,
+                const char* &successor, size_t &length) const;
     private:
         /**
          * @brief The set of variables.
@@ -96,8 +257,189 @@ class Lsystem {
         /**
          * @brief The set of production rules.
          */
-        multimap<char, string> theRules;
+        multimap<char, pair<string, double> > theRules;
+        /**
+         * @brief The generator of the stochastic choices.
+         */
+        Random theRandom;
+        /**
+         * @brief Location of a successor within the successor pool.
+         */
+        struct Span {
+            /**
+             * @brief Offset of the successor in the pool.
+             */
+            size_t offset;
+            /**
+             * @brief Length of the successor.
+             */
+            size_t length;
+            /**
+             * @brief Cumulative probability of the alternatives up to
+             *     this one.
+             */
+            double threshold;
+        };
+        /**
+         * @brief Compiled rule table entry of a symbol.
+         */
+        struct RuleEntry {
+            /**
+             * @brief Index of the first alternative in the span table.
+             */
+            unsigned int first;
+            /**
+             * @brief Number of alternatives (zero for constants).
+             */
+            unsigned int count;
+            /**
+             * @brief Length of the successor of a deterministic symbol
+             *     (one for constants, which rewrite to themselves).
+             */
+            size_t length;
+        };
+        /**
+         * @brief Compile the production rules into the rule table.
+         * @pre The production rules must be set.
+         * @post The successor pool, spans and rule table are built.
+         */
+        void compile();
+        /**
+         * @brief Choose the successor of a variable.
+         * @param entry The rule table entry of the variable.
+         * @param random The generator of the stochastic choices.
+         * @param epoch The generation of the variable.
+         * @param position The position of the variable in its generation.
+         * @return The span of the chosen successor.
+         * @pre The entry must have some alternative.
+         * @post The same position always yields the same successor.
+         */
+        const Span& choose(const RuleEntry &entry, const Random &random,
+                const unsigned int epoch,
+                const unsigned long long position) const;
+        /**
+         * @brief Length of the rewriting of some symbols.
+         * @param begin The first symbol.
+         * @param end Past the last symbol.
+         * @param random The generator of the stochastic choices.
+         * @param epoch The generation of the symbols.
+         * @param position The position of the first symbol.
+         * @return The length of the rewritten symbols.
+         * @pre The L-system must be defined.
+         * @post The symbols are measured.
+         */
+        size_t measure(const char* begin, const char* end,
+                const Random &random, const unsigned int epoch,
+                const unsigned long long position) const;
+        /**
+         * @brief Rewriting of some symbols.
+         * @param begin The first symbol.
+         * @param end Past the last symbol.
+         * @param random The generator of the stochastic choices.
+         * @param epoch The generation of the symbols.
+         * @param position The position of the first symbol.
+         * @param out Where to write the successors.
+         * @pre The output must hold the measured length.
+         * @post The successors are written.
+         */
+        void rewrite(const char* begin, const char* end,
+                const Random &random, const unsigned int epoch,
+                const unsigned long long position, char* out) const;
+        /**
+         * @brief Length of the cached expansion of some symbols.
+         * @param begin The first symbol.
+         * @param end Past the last symbol.
+         * @param cache The expansion cache.
+         * @param depth The number of generations.
+         * @return The length of the expanded symbols.
+         * @pre The cache must cover the symbols at the depth.
+         * @post The symbols are measured.
+         */
+        size_t measure(const char* begin, const char* end,
+                const ExpansionCache &cache, const unsigned int depth) const;
+        /**
+         * @brief Cached expansion of some symbols.
+         * @param begin The first symbol.
+         * @param end Past the last symbol.
+         * @param cache The expansion cache.
+         * @param depth The number of generations.
+         * @param out Where to write the expansions.
+         * @pre The output must hold the measured length.
+         * @post The expansions are written.
+         */
+        void rewrite(const char* begin, const char* end,
+                const ExpansionCache &cache, const unsigned int depth,
+                char* out) const;
+        /**
+         * @brief Derivation of one generation, possibly in parallel.
+         * @param production The current generation.
+         * @param random The generator of the stochastic choices.
+         * @param epoch The generation of the current production.
+         * @param next The next generation.
+         * @param numThreads The number of threads to use.
+         * @param cache The expansion cache to derive several generations
+         *     at once, if any.
+         * @param depth The number of generations to derive with the
+         *     cache.
+         * @pre The L-system must be defined, and the cache must cover the
+         *     production at the depth.
+         * @post The next generation is written.
+         */
+        void rewriteParallel(const string &production,
+                const Random &random, const unsigned int epoch, string &next,
+                const unsigned int numThreads,
+                const ExpansionCache *cache = NULL,
+                const unsigned int depth = 1) const;
+        /**
+         * @brief Rope nodes of the construction scratch.
+         */
+        typedef pmr::vector<size_t> Nodes;
+        /**
+         * @brief Generation positions of the construction scratch.
+         */
+        typedef pmr::vector<unsigned long long> Counters;
+        /**
+         * @brief Rope node of a deterministic subtree.
+         * @param rope The rope.
+         * @param memo The nodes built so far, by depth and symbol.
+         * @param symbol The symbol at the top of the subtree.
+         * @param depth The number of generations below it.
+         * @return The node.
+         * @pre The symbol must be closed (see ExpansionCache).
+         * @post The node is built once and shared.
+         */
+        size_t growClosed(Rope &rope, Nodes &memo, const char symbol,
+                const unsigned int depth) const;
+        /**
+         * @brief Rope node of a subtree.
+         * @param rope The rope.
+         * @param closure The closure and lengths of the symbols.
+         * @param memo The deterministic nodes built so far.
+         * @param counters Position of the next symbol in every
+         *     generation.
+         * @param symbol The symbol at the top of the subtree.
+         * @param epoch The generation of the symbol.
+         * @param numIter The number of iterations.
+         * @return The node.
+         * @pre The counters must locate the symbol.
+         * @post The node is built and the counters are moved past the
+         *     subtree.
+         */
+        size_t grow(Rope &rope, const ExpansionCache &closure,
+                Nodes &memo, Counters &counters, const char symbol,
+                const unsigned int epoch, const unsigned int numIter) const;
+        /**
+         * @brief All the successors, one after the other.
+         */
+        string thePool;
+        /**
+         * @brief Successor spans, grouped by predecessor symbol.
+         */
+        vector<Span> theSpans;
+        /**
+         * @brief Rule table indexed by symbol.
+         */
+        RuleEntry theTable[256];
 };
 
 #endif
-
@@ -0,0 +1,86 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : MappedSource.hpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef MAPPEDSOURCE_HPP
+#define MAPPEDSOURCE_HPP
+
+#include "SymbolSource.hpp"
+#include "ProductionFile.hpp"
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class MappedSource
+ * @brief Symbol source over a production file.
+ *
+ * The pages of the symbols read are released as the source moves on, so
+ * a production larger than the memory can be scanned front to back.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class MappedSource : public SymbolSource {
+    public:
+        /**
+         * @brief Mapped source constructor.
+         * @param prod The production file.
+         * @pre The file must be mapped, and outlive the source.
+         * @post The source is positioned at the first symbol.
+         */
+        MappedSource(ProductionFile &prod);
+        /**
+         * @brief Read the next block of symbols.
+         * @param buffer Where to write the symbols.
+         * @param size The capacity of the buffer.
+         * @return The number of symbols read, zero at the end.
+         * @pre The buffer must hold size symbols.
+         * @post The symbols are consumed from the source.
+         */
+        size_t read(char* buffer, const size_t size);
+    private:
+        /**
+         * @brief The production file.
+         */
+        ProductionFile &theProd;
+        /**
+         * @brief Position of the next symbol.
+         */
+        size_t theOffset;
+        /**
+         * @brief Position of the first symbol not released yet.
+         */
+        size_t theReleased;
+};
+
+#endif
@@ -0,0 +1,407 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ParametricLsystem.hpp                                       |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef PARAMETRICLSYSTEM_HPP
+#define PARAMETRICLSYSTEM_HPP
+
+#include "Expression.hpp"
+#include <string>
+#include <set>
+#include <map>
+#include <vector>
+#include <memory>
+#include <utility>
+
+using namespace std;
+
+/**
+ * @class UninitialisedAllocator
+ * @brief Heap allocator whose objects are left uninitialised when a
+ *     container grows, for the buffers that are written whole right
+ *     after.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+template <class T>
+class UninitialisedAllocator : public allocator<T> {
+    public:
+        /**
+         * @brief Allocator of another type.
+         */
+        template <class U>
+        struct rebind {
+            typedef UninitialisedAllocator<U> other;
+        };
+        /**
+         * @brief Uninitialised allocator constructor.
+         * @post Builds the allocator.
+         */
+        UninitialisedAllocator() {
+        }
+        /**
+         * @brief Rebinding constructor.
+         * @post Builds the allocator.
+         */
+        template <class U>
+        UninitialisedAllocator(const UninitialisedAllocator<U>&) {
+        }
+        /**
+         * @brief Leave an object uninitialised.
+         * @param object The memory of the object.
+         * @post The object is default-initialised, i.e., left as is if
+         *     it is a number.
+         */
+        template <class U>
+        void construct(U* object) {
+            ::new(static_cast<void*>(object)) U;
+        }
+        /**
+         * @brief Construct an object.
+         * @param object The memory of the object.
+         * @param args The arguments of its constructor.
+         * @post The object is constructed.
+         */
+        template <class U, class... Args>
+        void construct(U* object, Args&&... args) {
+            ::new(static_cast<void*>(object)) U(forward<Args>(args)...);
+        }
+};
+
+/**
+ * @class ParametricLsystem
+ * @brief L-system of modules, i.e., symbols with numeric parameters,
+ *     rewritten by context-sensitive and parametric rules.
+ *
+ * A rule is written as "left < predecessor > right : condition ->
+ * successor", where the contexts and the condition are optional, e.g.,
+ * "A < B > C -> D" or "F(l) : l > 2 -> F(l*0.5)pF(l*0.5)". The modules
+ * of the contexts and the predecessor name their parameters, which the
+ * condition and the parameters of the successor modules may use as
+ * expressions (see Expression). Every symbol takes the same number of
+ * parameters wherever it appears. The contexts are matched on the
+ * neighbouring modules of the predecessor, skipping the symbols to be
+ * ignored (e.g., the turns) and, as in "The Algorithmic Beauty of
+ * Plants", the branches: in "A[B]C", the left context of C is A, as is
+ * that of B, and the right context of A is C, while B has none. The
+ * contexts cannot hold the symbols that open or close a branch. The
+ * first rule of a module whose contexts
+ * and condition hold rewrites it, in the order of the definition, and a
+ * module that no rule rewrites is copied as is. Rules are deterministic.
+ *
+ * The rules are compiled once into a table of candidate rules indexed by
+ * predecessor symbol, with the condition and the parameters of the
+ * successor compiled into bytecode, so a derivation does not parse any
+ * text. The symbols whose replacement is fixed (no parameters, context
+ * or condition) are copied straight from the table, as the context-free
+ * derivation does. A production is kept as its symbols and, apart, the
+ * parameters of all its modules one after the other. The table also
+ * bounds the size that every module may grow to in two generations, so
+ * each generation is written in a single pass over the previous one,
+ * into buffers reserved for the bound and trimmed afterwards.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class ParametricLsystem {
+    public:
+        /**
+         * @brief Sequence of modules.
+         */
+        struct Modules {
+            /**
+             * @brief The symbols of the modules.
+             */
+            string symbols;
+            /**
+             * @brief The parameters of the modules, in order.
+             */
+            vector<double, UninitialisedAllocator<double> > params;
+        };
+        /**
+         * @brief Parametric L-system constructor.
+         * @post Initialises an empty L-system, whose axiom is empty.
+         */
+        ParametricLsystem();
+        /**
+         * @brief Compile the definition of the L-system.
+         * @param axiom The initial axiom, whose parameters are numbers.
+         * @param rules The context-free rules, which apply after the
+         *     others.
+         * @param moduleRules The context-sensitive and parametric rules.
+         * @param ignored The symbols skipped by the contexts.
+         * @param opening The symbols that open a branch.
+         * @param closing The symbols that close a branch.
+         * @param error Where to describe the first error, if any.
+         * @return False if some rule or module is malformed, or a symbol
+         *     takes different numbers of parameters.
+         * @pre The context-free rules must be deterministic.
+         * @post The axiom and the rule table are built.
+         */
+        bool compile(const string &axiom,
+                const multimap<char, pair<string, double> > &rules,
+                const vector<string> &moduleRules,
+                const set<char> &ignored, const set<char> &opening,
+                const set<char> &closing, string &error);
+        /**
+         * @brief Generate a production by iterating the system on the
+         *     initial axiom.
+         * @param numIter The number of iterations to run.
+         * @return Sequence of modules by the end of the iteration.
+         * @pre The L-system must be compiled.
+         * @post Produces a sequence of modules by iteration.
+         */
+        Modules produce(const int numIter) const;
+        /**
+         * @brief Text of some modules, e.g., "F(0.5)pF(0.5)".
+         * @param modules The modules.
+         * @return The text.
+         * @pre The modules must be produced by the L-system.
+         * @post The modules are written with their parameters.
+         */
+        string format(const Modules &modules) const;
+        /**
+         * @brief Number of parameters of a symbol.
+         * @param symbol The symbol.
+         * @return The number of parameters.
+         * @pre The L-system must be compiled.
+         * @post The number of parameters is returned.
+         */
+        unsigned int getArity(const char symbol) const;
+    private:
+        /**
+         * @brief Compiled rule.
+         */
+        struct Rule {
+            /**
+             * @brief Symbols of the left context, in order.
+             */
+            string left;
+            /**
+             * @brief Symbols of the right context, in order.
+             */
+            string right;
+            /**
+             * @brief True if the rule has some context.
+             */
+            bool contextual;
+            /**
+             * @brief Slot of the first parameter of the predecessor.
+             */
+            unsigned int predecessorSlot;
+            /**
+             * @brief True if the rule has a condition.
+             */
+            bool conditional;
+            /**
+             * @brief The condition.
+             */
+            Expression condition;
+            /**
+             * @brief Symbols of the successor.
+             */
+            string successor;
+            /**
+             * @brief Distinct expressions of the successor parameters.
+             */
+            vector<Expression> expressions;
+            /**
+             * @brief Parameters of the successor modules, in order, as
+             *     indices of their expressions.
+             */
+            vector<unsigned int> arguments;
+            /**
+             * @brief Most symbols that may replace those of the
+             *     successor.
+             */
+            size_t nextLength;
+            /**
+             * @brief Most parameters that may replace the modules of the
+             *     successor.
+             */
+            size_t nextParams;
+        };
+        /**
+         * @brief Rule table entry of a symbol.
+         */
+        struct RuleEntry {
+            /**
+             * @brief Index of the first candidate rule.
+             */
+            unsigned int first;
+            /**
+             * @brief Number of candidate rules.
+             */
+            unsigned int count;
+            /**
+             * @brief True if the symbol takes no parameters and is always
+             *     replaced by the same symbols, i.e., its first rule has
+             *     no context, condition or parameters, or it has no rule.
+             */
+            bool fixed;
+            /**
+             * @brief True if the symbol is rewritten without matching,
+             *     i.e., its first rule has no context or condition, or it
+             *     has no rule.
+             */
+            bool direct;
+            /**
+             * @brief Offset of the replacement of a fixed symbol in the
+             *     pool.
+             */
+            size_t offset;
+            /**
+             * @brief Most symbols that may replace the symbol, i.e., the
+             *     length of the longest successor of its rules, or of
+             *     the module itself if it may be copied.
+             */
+            size_t length;
+            /**
+             * @brief Most parameters that may replace the module.
+             */
+            size_t numParams;
+            /**
+             * @brief Most symbols that may replace those that replace a
+             *     fixed or direct symbol, or the symbol if copied.
+             */
+            size_t nextLength;
+            /**
+             * @brief Most parameters that may replace the modules that
+             *     replace a fixed or direct symbol, or the module if
+             *     copied.
+             */
+            size_t nextParams;
+        };
+        /**
+         * @brief Compile a context-sensitive or parametric rule.
+         * @param text The rule.
+         * @param rule The compiled rule.
+         * @param predecessor Where to put the predecessor symbol.
+         * @param error Where to describe the error, if any.
+         * @return False if the rule is malformed.
+         * @pre The symbols of the branches must be set.
+         * @post The rule is compiled and the arities are checked.
+         */
+        bool compileRule(const string &text, Rule &rule, char &predecessor,
+                string &error);
+        /**
+         * @brief Split the text of some modules.
+         * @param text The modules, e.g., "F(l*0.5,2)X".
+         * @param symbols Where to put the symbols.
+         * @param args Where to put the texts of the parameters of every
+         *     module.
+         * @param error Where to describe the error, if any.
+         * @return False if the parentheses do not match, or the arity of
+         *     some symbol is inconsistent.
+         * @pre None.
+         * @post The modules are split and their arities recorded.
+         */
+        bool split(const string &text, string &symbols,
+                vector<vector<string> > &args, string &error);
+        /**
+         * @brief Match the contexts of a rule and bind its parameters.
+         * @param in The production.
+         * @param index The position of the predecessor.
+         * @param offset The position of its first parameter.
+         * @param rule The rule.
+         * @param slots Where to bind the parameters.
+         * @return True if the contexts match.
+         * @pre The predecessor must be that of the rule.
+         * @post The parameters of the matched modules are bound.
+         */
+        bool match(const Modules &in, const size_t index,
+                const size_t offset, const Rule &rule, double* slots) const;
+        /**
+         * @brief Most symbols and parameters that may replace some
+         *     symbols.
+         * @param symbols The symbols.
+         * @param length Where to set the number of symbols.
+         * @param numParams Where to set the number of parameters.
+         * @pre The rule table must be built.
+         * @post The bounds are set.
+         */
+        void measure(const string &symbols, size_t &length,
+                size_t &numParams) const;
+        /**
+         * @brief Derivation of one generation.
+         * @param in The current generation.
+         * @param out The next generation.
+         * @param length Most symbols of the next generation, and then
+         *     of the generation after it.
+         * @param numParams Most parameters of the next generation, and
+         *     then of the generation after it.
+         * @pre The L-system must be compiled.
+         * @post The next generation is written, in a single pass.
+         */
+        void rewrite(const Modules &in, Modules &out, size_t &length,
+                size_t &numParams) const;
+        /**
+         * @brief The initial axiom.
+         */
+        Modules theAxiom;
+        /**
+         * @brief Compiled rules, grouped by predecessor symbol.
+         */
+        vector<Rule> theRules;
+        /**
+         * @brief Replacements of the fixed symbols, one after the other.
+         */
+        string thePool;
+        /**
+         * @brief Rule table indexed by symbol.
+         */
+        RuleEntry theTable[256];
+        /**
+         * @brief Number of parameters by symbol (negative while unknown).
+         */
+        int theArity[256];
+        /**
+         * @brief Symbols skipped by the contexts.
+         */
+        bool theIgnored[256];
+        /**
+         * @brief One if the symbol opens a branch, minus one if it
+         *     closes one, and zero otherwise.
+         */
+        int theBranch[256];
+        /**
+         * @brief Largest number of parameters bound by a rule.
+         */
+        unsigned int theNumSlots;
+        /**
+         * @brief Largest number of distinct expressions of a rule.
+         */
+        unsigned int theNumValues;
+
+};
+
+#endif
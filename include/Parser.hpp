@@ -38,8 +38,9 @@
 #include <string>
 #include <set>
 #include <map>
-#include <fstream>
 #include <vector>
+#include <string_view>
+#include <cstddef>
 
 using namespace std;
 
@@ -52,6 +53,37 @@ using namespace std;
  * defined in the Wikipedia, but it avoids punctuation marks for
  * convenient parsing issues.
  *
+ * Each production rule is written as "(symbol -> successor)", and may
+ * be followed by a weight, e.g., "(F -> FpF 0.7)", to bias the choice
+ * among the rules of a stochastic grammar. Rules are equally weighted
+ * by default.
+ *
+ * Context-sensitive and parametric rules are written one per line, as
+ * "rule: left < predecessor > right : condition -> successor", and the
+ * symbols that their contexts skip as "ignore: p, m" (see
+ * ParametricLsystem). The symbols whose turtle instructions push or pop
+ * the position or the angle open or close the branches that the
+ * contexts skip over. The modules of the axiom may then take
+ * parameters, e.g., "start: F(100)X". Their symbols, parameters and
+ * expressions are checked as they are parsed, as are the number of
+ * parameters of every symbol, but the contexts and the weights are
+ * checked by the engine.
+ *
+ * Symbols may be named with more than one character, e.g.,
+ * "variables: stem, leaf, p, m", and are then written one after the
+ * other in the axiom and the rules, the longest declared name that
+ * matches being taken, e.g., "(stem -> stempleaf)". Every symbol must be
+ * declared before it is used. Each name is given a character of its
+ * own, beyond the ASCII range, so the rest of the system still handles
+ * one character per symbol.
+ *
+ * The definition is parsed in one pass over the memory-mapped file,
+ * without copying its lines, and it is validated as it is parsed: the
+ * first error is reported with its line and column.
+ *
+ * The getters return references to the definition held by the parser,
+ * so it must outlive their use, but nothing is copied.
+ *
  * @author Alexandre Trilla (atrilla)
  */
 class Parser {
@@ -63,32 +95,45 @@ class Parser {
         Parser();
         /**
          * @brief Parse the L-system definition file.
-         * @param file The file.
-         * @pre File must be open.
-         * @post Parser loaded with definition. Does not close file.
+         * @param path The path of the file.
+         * @param error The message of the error, as "path:line:column:
+         *     message", if it fails.
+         * @return True if the definition is valid.
+         * @post Parser loaded with definition.
          */
-        void parse(ifstream& file);
+        bool parse(const string &path, string &error);
+        /**
+         * @brief Parse an L-system definition held in memory.
+         * @param text The definition.
+         * @param size The number of characters of the definition.
+         * @param error The message of the error, as "line:column:
+         *     message", if it fails.
+         * @return True if the definition is valid.
+         * @post Parser loaded with definition.
+         */
+        bool parse(const char* text, const size_t size, string &error);
         /**
          * @brief Alphabet getter.
          * @return The alphabet of the L-system definition.
          * @pre Parser has to be loaded.
          * @post The alphabet is returned.
          */
-        set<char> getAlphabet() const;
+        const set<char>& getAlphabet() const;
         /**
          * @brief Axiom getter.
          * @return The axiom of the L-system definition.
          * @pre Parser has to be loaded.
          * @post The axiom is returned.
          */
-        string getAxiom() const;
+        const string& getAxiom() const;
         /**
          * @brief Production rules getter.
-         * @return The production rules of the L-system definition.
+         * @return The production rules of the L-system definition, i.e.,
+         *     the successor and the weight of every rule by predecessor.
          * @pre Parser has to be loaded.
          * @post The production rules are returned.
          */
-        multimap<char, string> getRules() const;
+        const multimap<char, pair<string, double> >& getRules() const;
         /**
          * @brief Number of iterations to run getter.
          * @return The number of iterations to run.
@@ -102,29 +147,215 @@ class Parser {
          * @pre Parser has to be loaded.
          * @post The correspondence of symbol-drawing instruction.
          */
-        map<char, string> getTurtle() const;
+        const map<char, string>& getTurtle() const;
+        /**
+         * @brief Context-sensitive and parametric rules getter.
+         * @return The text of the rules, in order.
+         * @pre Parser has to be loaded.
+         * @post The rules are returned.
+         */
+        const vector<string>& getModuleRules() const;
+        /**
+         * @brief Getter of the symbols skipped by the contexts.
+         * @return The ignored symbols.
+         * @pre Parser has to be loaded.
+         * @post The ignored symbols are returned.
+         */
+        const set<char>& getIgnored() const;
+        /**
+         * @brief Getter of the symbols that open a branch, i.e., whose
+         *     turtle instructions push the position or the angle.
+         * @return The opening symbols.
+         * @pre Parser has to be loaded.
+         * @post The opening symbols are returned.
+         */
+        const set<char>& getOpening() const;
+        /**
+         * @brief Getter of the symbols that close a branch, i.e., whose
+         *     turtle instructions pop the position or the angle.
+         * @return The closing symbols.
+         * @pre Parser has to be loaded.
+         * @post The closing symbols are returned.
+         */
+        const set<char>& getClosing() const;
         /**
          * @brief Drawing reduction scale getter.
          * @return The drawing reduction scale.
          * @pre Parser has to be loaded.
          * @post The reduction rate applied to the drawing.
          */
-        string getReductionScale() const;
+        const string& getReductionScale() const;
         /**
          * @brief Initial position getter.
          * @return The initial position of the turtle.
          * @pre Parser has to be loaded.
          * @post The initial position of the turtle.
          */
-        vector<string> getInitPos() const;
+        const vector<string>& getInitPos() const;
         /**
          * @brief Initial angle getter.
          * @return The initial angle of the turtle.
          * @pre Parser has to be loaded.
          * @post The initial angle of the turtle.
          */
-        string getInitAng() const;
+        const string& getInitAng() const;
     private:
+        /**
+         * @brief Reading position in the definition.
+         */
+        struct Cursor {
+            const char* at;
+            const char* end;
+            const char* line;
+            unsigned int number;
+        };
+        /**
+         * @brief Parse one line of the definition.
+         * @param cursor The position, at the keyword.
+         * @param rules The production rules read so far, in order.
+         * @param error The message of the error, if it fails.
+         * @return True if the line is valid.
+         * @post The cursor is at the end of the line.
+         */
+        bool statement(Cursor &cursor,
+            vector<pair<char, pair<string, double> > > &rules,
+            string &error);
+        /**
+         * @brief Report an error.
+         * @param cursor The position in the line.
+         * @param where The character where the error is.
+         * @param message The message.
+         * @param error The message, prefixed with the line and column.
+         * @return False.
+         */
+        bool fail(const Cursor &cursor, const char* where,
+            const string &message, string &error) const;
+        /**
+         * @brief Skip the blanks of the line.
+         * @param cursor The position.
+         */
+        void skipBlanks(Cursor &cursor) const;
+        /**
+         * @brief Skip a comma, and the blanks around it, between items.
+         * @param cursor The position.
+         */
+        void skipSeparator(Cursor &cursor) const;
+        /**
+         * @brief Check the end of the line, or of a trailing comment.
+         * @param cursor The position.
+         * @return True at the end of the line.
+         */
+        bool atLineEnd(const Cursor &cursor) const;
+        /**
+         * @brief Read a word, i.e., the characters up to a blank, any of
+         *     ",():#" or "->".
+         * @param cursor The position, moved past the word.
+         * @return The word, in the definition, empty if there is none.
+         */
+        string_view token(Cursor &cursor) const;
+        /**
+         * @brief Read an expected character.
+         * @param cursor The position.
+         * @param expected The character.
+         * @param error The message of the error, if it is missing.
+         * @return True if the character is found.
+         */
+        bool expect(Cursor &cursor, const char expected,
+            string &error) const;
+        /**
+         * @brief Read a number.
+         * @param cursor The position.
+         * @param text The number, as written.
+         * @param value The number.
+         * @param error The message of the error, if it fails.
+         * @return True if a number is found.
+         */
+        bool number(Cursor &cursor, string &text, double &value,
+            string &error) const;
+        /**
+         * @brief Declare a symbol of the alphabet.
+         * @param cursor The position, at the name.
+         * @param name The name.
+         * @param error The message of the error, if it fails.
+         * @return True if the symbol may be declared.
+         */
+        bool declare(const Cursor &cursor, const string_view name,
+            string &error);
+        /**
+         * @brief Read the name of a declared symbol.
+         * @param cursor The position.
+         * @param symbol The character of the symbol.
+         * @param error The message of the error, if it fails.
+         * @return True if the symbol is declared.
+         */
+        bool lookup(Cursor &cursor, char &symbol, string &error) const;
+        /**
+         * @brief Translate a word of symbol names into their characters.
+         * @param cursor The position in the line.
+         * @param word The first character of the word.
+         * @param name The names, one after the other.
+         * @param symbols The characters, appended.
+         * @param error The message of the error, if it fails.
+         * @return True if all the symbols are declared.
+         */
+        bool translate(const Cursor &cursor, const char* word,
+            const string_view name, string &symbols, string &error) const;
+        /**
+         * @brief Read a context-sensitive or parametric rule.
+         * @param cursor The position, after the keyword.
+         * @param error The message of the error, if it fails.
+         * @return True if the rule is valid.
+         * @post The cursor is at the end of the rule.
+         */
+        bool rule(Cursor &cursor, string &error);
+        /**
+         * @brief Read modules, i.e., symbols that may be followed by
+         *     their parameters in parentheses.
+         * @param cursor The position, moved past the modules.
+         * @param head Whether the modules stop at "<", ">", ":" or "->",
+         *     as in the head of a rule, or at the end of the line.
+         * @param formals Where to append the parameters, which must then
+         *     be names, or NULL if they are expressions.
+         * @param scope The names that the expressions may use.
+         * @param count Where to put the number of modules.
+         * @param error The message of the error, if it fails.
+         * @return True if the modules are valid.
+         */
+        bool modules(Cursor &cursor, const bool head,
+            vector<string>* formals, const vector<string> &scope,
+            unsigned int &count, string &error);
+        /**
+         * @brief Read the longest declared symbol name at the position.
+         * @param cursor The position, moved past the name.
+         * @param symbol The character of the symbol.
+         * @param error The message of the error, if it fails.
+         * @return True if a symbol is declared there.
+         */
+        bool name(Cursor &cursor, char &symbol, string &error) const;
+        /**
+         * @brief Translate the symbol names of modules, outside their
+         *     parameters and conditions, into their characters.
+         * @param text The modules, as written.
+         * @return The modules, with a character per symbol.
+         */
+        string translate(const string &text) const;
+        /**
+         * @brief The character of every symbol with a longer name.
+         */
+        map<string, char, less<> > theCodes;
+        /**
+         * @brief The length of the longest symbol name.
+         */
+        size_t theLongest;
+        /**
+         * @brief Declared symbols by character.
+         */
+        bool theDeclared[256];
+        /**
+         * @brief Number of parameters by character, negative until the
+         *     symbol is written as a module.
+         */
+        int theArity[256];
         /**
          * @brief The alphabet.
          */
@@ -136,7 +367,7 @@ class Parser {
         /**
          * @brief The production rules.
          */
-        multimap<char, string> theP;
+        multimap<char, pair<string, double> > theP;
         /**
          * @brief Number of running iterations.
          */
@@ -145,6 +376,22 @@ class Parser {
          * @brief Symbol-drawing instruction correspondence.
          */
         map<char, string> theTurtle;
+        /**
+         * @brief The context-sensitive and parametric rules.
+         */
+        vector<string> theModuleRules;
+        /**
+         * @brief The symbols skipped by the contexts.
+         */
+        set<char> theIgnored;
+        /**
+         * @brief The symbols that open a branch.
+         */
+        set<char> theOpening;
+        /**
+         * @brief The symbols that close a branch.
+         */
+        set<char> theClosing;
         /**
          * @brief The drawing scale.
          */
@@ -0,0 +1,147 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : PlyWriter.hpp                                               |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef PLYWRITER_HPP
+#define PLYWRITER_HPP
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <streambuf>
+
+using namespace std;
+
+/**
+ * @class PlyWriter
+ * @brief Polygon File Format output of 3D segments, written as they are
+ *     drawn.
+ *
+ * The segments are written as a binary little-endian PLY file with two
+ * single-precision vertices per segment, followed by the edges that join
+ * them. The vertices are gathered in blocks of coordinate arrays and
+ * written out whenever a block fills up, so the memory does not depend on
+ * the number of segments. The edges are implied by the order of the
+ * vertices and only written once all of them are known.
+ *
+ * The header announces the number of segments, which must be known
+ * beforehand (e.g., counted with Growth, or by a first pass over the
+ * symbols), so the file is written front to back and may be a pipe.
+ * The vertices are indexed by 32-bit integers, so a file holds at most
+ * UINT32_MAX/2 segments, which are checked with fits() before writing.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class PlyWriter {
+    public:
+        /**
+         * @brief PLY writer constructor.
+         * @param out Where to write the PLY file.
+         * @param numSegs The number of segments.
+         * @post The header is written.
+         */
+        PlyWriter(ostream &out, const unsigned long long numSegs);
+        /**
+         * @brief Whether the vertices of some segments may be indexed.
+         * @param numSegs The number of segments.
+         * @param error Where to tell why they may not.
+         * @return False if a vertex index does not fit in 32 bits.
+         * @pre None.
+         * @post The number of segments is checked.
+         */
+        static bool fits(const unsigned long long numSegs, string &error);
+        /**
+         * @brief Append a segment.
+         * @param x0 The abscissa of the start point.
+         * @param y0 The ordinate of the start point.
+         * @param z0 The height of the start point.
+         * @param x1 The abscissa of the end point.
+         * @param y1 The ordinate of the end point.
+         * @param z1 The height of the end point.
+         * @pre The writer must not be closed.
+         * @post The segment is the last one.
+         */
+        void add(const double x0, const double y0, const double z0,
+                const double x1, const double y1, const double z1);
+        /**
+         * @brief Write the rest of the file.
+         * @param error Where to tell why the file is not valid.
+         * @return False if the segments added are not those announced,
+         *     their vertices may not be indexed (and no edge is
+         *     written), or the output failed.
+         * @pre The writer must not be closed.
+         * @post The pending vertices and the edges are written.
+         */
+        bool close(string &error);
+        /**
+         * @brief Number of segments.
+         * @return The number of segments added.
+         */
+        unsigned long long size() const;
+    private:
+        /**
+         * @brief Write the pending vertices.
+         * @pre None.
+         * @post The coordinate arrays are empty.
+         */
+        void flush();
+        /**
+         * @brief Write the header.
+         * @param numSegs The number of segments.
+         * @pre None.
+         * @post The header is written.
+         */
+        void header(const unsigned long long numSegs);
+        /**
+         * @brief The output.
+         */
+        ostream &theOut;
+        /**
+         * @brief The number of segments announced.
+         */
+        unsigned long long theAnnounced;
+        /**
+         * @brief The number of segments added.
+         */
+        unsigned long long theSize;
+        /**
+         * @brief Coordinates of the pending vertices.
+         */
+        vector<float> theX, theY, theZ;
+        /**
+         * @brief Scratch of the encoded vertices.
+         */
+        vector<char> theBytes;
+};
+
+#endif
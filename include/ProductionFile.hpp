@@ -0,0 +1,224 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ProductionFile.hpp                                          |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef PRODUCTIONFILE_HPP
+#define PRODUCTIONFILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class ProductionFile
+ * @brief Production held in a memory-mapped file.
+ *
+ * The file consists of a fixed header (see Header) followed by the
+ * symbols of the production, one byte each, with no terminator:
+ *
+ * <br/>offset  0: "LSYSPROD" signature (8 bytes)
+ * <br/>offset  8: version of the format, 1 (32 bits)
+ * <br/>offset 12: generation of the symbols (32 bits)
+ * <br/>offset 16: seed of the stochastic choices (64 bits)
+ * <br/>offset 24: fingerprint of the axiom and the rules (64 bits)
+ * <br/>offset 32: number of symbols (64 bits)
+ * <br/>offset 40: the symbols
+ *
+ * <br/>The integers are in the byte order of the machine that wrote the
+ * file. The symbols are mapped, not loaded, so a production larger than
+ * the memory is paged in and out by the system as it is scanned. The
+ * mapping is advised for sequential access, and the pages already
+ * scanned may be released early.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class ProductionFile {
+    public:
+        /**
+         * @brief Header of a production file.
+         */
+        struct Header {
+            /**
+             * @brief File signature, "LSYSPROD".
+             */
+            char magic[8];
+            /**
+             * @brief Version of the format.
+             */
+            uint32_t version;
+            /**
+             * @brief Generation of the symbols.
+             */
+            uint32_t epoch;
+            /**
+             * @brief Seed of the stochastic choices.
+             */
+            uint64_t seed;
+            /**
+             * @brief Fingerprint of the axiom and the rules.
+             */
+            uint64_t grammar;
+            /**
+             * @brief Number of symbols that follow the header.
+             */
+            uint64_t length;
+        };
+        /**
+         * @brief Production file constructor.
+         * @post Builds a closed file, with no mapping.
+         */
+        ProductionFile();
+        /**
+         * @brief Production file destructor.
+         * @post The file is unmapped and closed.
+         */
+        ~ProductionFile();
+        /**
+         * @brief Map an existing production file for reading.
+         * @param path The file.
+         * @param error Where to describe the error, if any.
+         * @return False if the file cannot be mapped, or it is not a
+         *     complete production file.
+         * @pre None.
+         * @post The header and the symbols are mapped.
+         */
+        bool open(const string &path, string &error);
+        /**
+         * @brief Create a production file and map it for writing.
+         * @param path The file.
+         * @param header The header, which tells the number of symbols.
+         * @param error Where to describe the error, if any.
+         * @return False if the file cannot be created.
+         * @pre None.
+         * @post The file is sized for the symbols, which are to be
+         *     written through getSymbols().
+         */
+        bool create(const string &path, const Header &header,
+                string &error);
+        /**
+         * @brief Unmap and close the file.
+         * @pre None.
+         * @post The symbols written are left to the system to flush.
+         */
+        void close();
+        /**
+         * @brief Header getter.
+         * @return The header.
+         * @pre The file must be mapped.
+         * @post The header is returned.
+         */
+        const Header& getHeader() const;
+        /**
+         * @brief Symbols getter.
+         * @return The mapped symbols.
+         * @pre The file must be mapped.
+         * @post The symbols are returned.
+         */
+        const char* getSymbols() const;
+        /**
+         * @brief Symbols getter, for writing.
+         * @return The mapped symbols.
+         * @pre The file must be created.
+         * @post The symbols are returned.
+         */
+        char* getSymbols();
+        /**
+         * @brief Release the pages of some symbols that are done with.
+         * @param offset The first symbol.
+         * @param length The number of symbols.
+         * @pre The file must be mapped.
+         * @post The written pages are scheduled for writing back, and the
+         *     whole pages of the range are dropped from the mapping
+         *     (they are read again from the file if accessed).
+         */
+        void release(const size_t offset, const size_t length);
+        /**
+         * @brief Fill in a header.
+         * @param header The header.
+         * @param epoch The generation of the symbols.
+         * @param seed The seed of the stochastic choices.
+         * @param grammar The fingerprint of the axiom and the rules.
+         * @param length The number of symbols.
+         * @pre None.
+         * @post The header is signed with the current version.
+         */
+        static void stamp(Header &header, const unsigned int epoch,
+                const unsigned long long seed,
+                const unsigned long long grammar, const size_t length);
+        /**
+         * @brief Check the signature and the version of a header.
+         * @param header The header.
+         * @return True if the header is of the current format.
+         * @pre None.
+         * @post The header is checked.
+         */
+        static bool isValid(const Header &header);
+    private:
+        /**
+         * @brief Copy constructor, disabled.
+         */
+        ProductionFile(const ProductionFile &other);
+        /**
+         * @brief Assignment, disabled.
+         */
+        ProductionFile& operator=(const ProductionFile &other);
+        /**
+         * @brief Map the whole file.
+         * @param size The size of the file.
+         * @param writable True to write the symbols.
+         * @return False if the file cannot be mapped.
+         * @pre The descriptor must be open.
+         * @post The file is mapped for sequential access.
+         */
+        bool map(const size_t size, const bool writable);
+        /**
+         * @brief File descriptor (negative if closed).
+         */
+        int theDescriptor;
+        /**
+         * @brief The mapping (NULL if unmapped).
+         */
+        char* theMapping;
+        /**
+         * @brief Size of the mapping.
+         */
+        size_t theSize;
+        /**
+         * @brief True if the mapping is writable.
+         */
+        bool theWritable;
+};
+
+#endif
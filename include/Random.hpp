@@ -0,0 +1,85 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Random.hpp                                                  |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+using namespace std;
+
+/**
+ * @class Random
+ * @brief Counter-based random number generator (Philox4x32-10).
+ *
+ * Unlike a sequential generator, each draw is a pure function of the
+ * seed and a counter, so there is no hidden state to share between
+ * threads. The L-system keys its draws by generation and symbol
+ * position, which makes a derivation reproducible for a given seed
+ * regardless of the order (or the number of threads) in which the
+ * symbols are rewritten.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Random {
+    public:
+        /**
+         * @brief Random generator constructor.
+         * @param seed The seed, i.e., the key of the generator.
+         * @post Builds the random generator.
+         */
+        Random(const unsigned long long seed = 0);
+        /**
+         * @brief Seed getter.
+         * @return The seed of the generator.
+         * @pre None.
+         * @post The seed is returned.
+         */
+        unsigned long long getSeed() const;
+        /**
+         * @brief Uniform draw in [0, 1).
+         * @param epoch The generation.
+         * @param position The position of the symbol in the generation.
+         * @return A real number with 53 random bits.
+         * @pre None.
+         * @post The same counter always yields the same number.
+         */
+        double uniform(const unsigned int epoch,
+                const unsigned long long position) const;
+    private:
+        /**
+         * @brief The seed.
+         */
+        unsigned long long theSeed;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : RasterWriter.hpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef RASTERWRITER_HPP
+#define RASTERWRITER_HPP
+
+#include "SegmentWriter.hpp"
+#include "Segments.hpp"
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class RasterWriter
+ * @brief Raster image output of the segments, as a Portable Pixmap or a
+ *     Portable Network Graphics image.
+ *
+ * The segments are drawn white on black, fitted to the image as in
+ * SvgWriter, whose longest side takes the given number of pixels. The
+ * image is split into square tiles and every segment is binned into the
+ * tiles it crosses. The tiles of a band (a row of tiles) are drawn in
+ * parallel, and the band is written out while the next one is drawn, so
+ * only two bands are ever held in memory whatever the resolution.
+ *
+ * A pixel is lit by the same rule whichever tile draws it, so the tiles
+ * join without seams.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class RasterWriter : public SegmentWriter {
+    public:
+        /**
+         * @brief Image formats.
+         */
+        enum Format {
+            PPM,
+            PNG
+        };
+        /**
+         * @brief Raster writer constructor.
+         * @param size The number of pixels of the longest side.
+         * @param format The image format.
+         * @param numThreads The number of threads that draw the tiles.
+         * @post Builds the raster writer.
+         */
+        RasterWriter(const unsigned int size, const Format format,
+                const unsigned int numThreads = 1);
+        /**
+         * @brief Write the segments.
+         * @param segs The segments.
+         * @param out Where to write the image.
+         * @pre None.
+         * @post The segments are written as an image.
+         */
+        void write(const Segments &segs, ostream &out) const;
+    private:
+        /**
+         * @brief Frame of the image.
+         */
+        struct Frame {
+            /**
+             * @brief The width, in pixels.
+             */
+            unsigned int width;
+            /**
+             * @brief The height, in pixels.
+             */
+            unsigned int height;
+            /**
+             * @brief The pixels per unit.
+             */
+            double scale;
+            /**
+             * @brief The abscissa of the left side.
+             */
+            double left;
+            /**
+             * @brief The ordinate of the top side.
+             */
+            double top;
+        };
+        /**
+         * @brief Segments binned into tiles, in compressed rows: those of
+         *     tile t are theIndices[theFirst[t]] to
+         *     theIndices[theFirst[t + 1] - 1].
+         */
+        struct Bins {
+            /**
+             * @brief The number of tile columns.
+             */
+            unsigned int columns;
+            /**
+             * @brief The number of tile rows.
+             */
+            unsigned int rows;
+            /**
+             * @brief Position of the first segment of every tile.
+             */
+            vector<size_t> first;
+            /**
+             * @brief The segments of all the tiles.
+             */
+            vector<uint32_t> indices;
+        };
+        /**
+         * @brief Fit the drawing to the image.
+         * @param segs The segments.
+         * @return The frame of the image.
+         * @pre None.
+         * @post The longest side of the image is the given size.
+         */
+        Frame frame(const Segments &segs) const;
+        /**
+         * @brief Bin the segments into tiles.
+         * @param segs The segments.
+         * @param image The frame of the image.
+         * @param bins Where to put the segments of every tile.
+         * @pre None.
+         * @post Every segment is in every tile where it lights a pixel.
+         */
+        void bin(const Segments &segs, const Frame &image, Bins &bins) const;
+        /**
+         * @brief Draw the segments of a tile.
+         * @param segs The segments.
+         * @param image The frame of the image.
+         * @param bins The segments of every tile.
+         * @param tile The index of the tile.
+         * @param band The pixels of the band of the tile, a row after
+         *     another.
+         * @pre The band must be cleared.
+         * @post The pixels of the tile are lit where segments cross.
+         */
+        void draw(const Segments &segs, const Frame &image, const Bins &bins,
+                const size_t tile, uint8_t* band) const;
+        /**
+         * @brief The number of pixels of the longest side.
+         */
+        unsigned int theSize;
+        /**
+         * @brief The image format.
+         */
+        Format theFormat;
+        /**
+         * @brief The number of threads that draw the tiles.
+         */
+        unsigned int theNumThreads;
+};
+
+#endif
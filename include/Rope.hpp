@@ -0,0 +1,167 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Rope.hpp                                                    |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef ROPE_HPP
+#define ROPE_HPP
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class Rope
+ * @brief Production stored as a straight-line grammar.
+ *
+ * Every node of the rope is either a short run of symbols stored flat,
+ * or the concatenation of other nodes, which may be shared: the nodes of
+ * a generation refer to the nodes of the next one, and a deterministic
+ * subtree is built once and referred to wherever it appears. The rope is
+ * thus a directed acyclic graph whose size grows with the number of
+ * iterations rather than with the length of the production.
+ *
+ * Each concatenation keeps the offsets of its parts, so a symbol is
+ * located with a binary search per level, i.e., in logarithmic time for
+ * productions that grow exponentially. Sequential reading is provided by
+ * RopeSource.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Rope {
+    friend class RopeSource;
+    public:
+        /**
+         * @brief Rope constructor.
+         * @post Initialises an empty rope, with a node for every single
+         *     symbol.
+         */
+        Rope();
+        /**
+         * @brief Node of a single symbol.
+         * @param symbol The symbol.
+         * @return The node.
+         * @pre None.
+         * @post The node is returned.
+         */
+        size_t symbol(const char symbol) const;
+        /**
+         * @brief Add the concatenation of some nodes.
+         * @param parts The nodes, in order.
+         * @param count The number of nodes.
+         * @return The new node.
+         * @pre The parts must belong to the rope.
+         * @post The node is added, stored flat if it is short.
+         */
+        size_t concatenate(const size_t* parts, const size_t count);
+        /**
+         * @brief Set the node of the whole production.
+         * @param node The node.
+         * @pre The node must belong to the rope.
+         * @post The rope spells the node.
+         */
+        void setRoot(const size_t node);
+        /**
+         * @brief Length of the production.
+         * @return The number of symbols.
+         * @pre None.
+         * @post The length is returned.
+         */
+        unsigned long long length() const;
+        /**
+         * @brief Symbol at a position.
+         * @param position The position.
+         * @return The symbol.
+         * @pre The position must be below the length.
+         * @post The symbol is located from the root down.
+         */
+        char at(const unsigned long long position) const;
+        /**
+         * @brief Number of nodes.
+         * @return The number of nodes, including the single symbols.
+         * @pre None.
+         * @post The number of nodes is returned.
+         */
+        size_t getNodes() const;
+        /**
+         * @brief Memory taken by the rope.
+         * @return The number of bytes of the nodes, parts and symbols.
+         * @pre None.
+         * @post The footprint is returned.
+         */
+        size_t getFootprint() const;
+    private:
+        /**
+         * @brief Node of the rope.
+         */
+        struct Node {
+            /**
+             * @brief The number of symbols it spells.
+             */
+            unsigned long long length;
+            /**
+             * @brief Index of its first part in the part table.
+             */
+            size_t first;
+            /**
+             * @brief Number of parts (zero if stored flat).
+             */
+            size_t count;
+            /**
+             * @brief Offset of its symbols in the pool, if stored flat.
+             */
+            size_t offset;
+        };
+        /**
+         * @brief The nodes.
+         */
+        vector<Node> theNodes;
+        /**
+         * @brief Parts of the concatenations.
+         */
+        vector<size_t> theParts;
+        /**
+         * @brief Offset of every part within its concatenation.
+         */
+        vector<unsigned long long> theOffsets;
+        /**
+         * @brief Symbols of the flat nodes.
+         */
+        string thePool;
+        /**
+         * @brief The node of the whole production.
+         */
+        size_t theRoot;
+};
+
+#endif
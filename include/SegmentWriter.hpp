@@ -0,0 +1,65 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : SegmentWriter.hpp                                           |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef SEGMENTWRITER_HPP
+#define SEGMENTWRITER_HPP
+
+#include "Segments.hpp"
+#include <ostream>
+
+using namespace std;
+
+/**
+ * @class SegmentWriter
+ * @brief Output format of the segments drawn by the turtle.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class SegmentWriter {
+    public:
+        /**
+         * @brief Segment writer destructor.
+         */
+        virtual ~SegmentWriter();
+        /**
+         * @brief Write the segments.
+         * @param segs The segments.
+         * @param out Where to write the segments.
+         * @pre None.
+         * @post The segments are written in the format of the writer.
+         */
+        virtual void write(const Segments &segs, ostream &out) const = 0;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Segments.hpp                                                |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef SEGMENTS_HPP
+#define SEGMENTS_HPP
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class Segments
+ * @brief Line segments drawn by the turtle.
+ *
+ * The segments are kept as a structure of arrays, one array for each
+ * coordinate of the end points (x0, y0) and (x1, y1), in drawing order.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Segments {
+    public:
+        /**
+         * @brief Segments constructor.
+         * @post Builds an empty set of segments.
+         */
+        Segments();
+        /**
+         * @brief Append a segment.
+         * @param x0 The abscissa of the start point.
+         * @param y0 The ordinate of the start point.
+         * @param x1 The abscissa of the end point.
+         * @param y1 The ordinate of the end point.
+         * @pre None.
+         * @post The segment is the last one.
+         */
+        void add(const double x0, const double y0, const double x1,
+                const double y1);
+        /**
+         * @brief Append room for some segments, to be written in bulk
+         *     through the coordinate arrays.
+         * @param count The number of segments.
+         * @return The index of the first new segment.
+         * @pre None.
+         * @post The new segments are the last ones, with zero
+         *     coordinates.
+         */
+        size_t extend(const size_t count);
+        /**
+         * @brief Make room for some segments at once.
+         * @param count The expected number of segments.
+         * @pre None.
+         * @post No memory is reallocated until there are more segments.
+         */
+        void reserve(const size_t count);
+        /**
+         * @brief Keep the first segments only.
+         * @param count The number of segments to keep.
+         * @pre The count must not exceed the number of segments.
+         * @post The segments after the count are removed.
+         */
+        void truncate(const size_t count);
+        /**
+         * @brief Remove all the segments.
+         * @pre None.
+         * @post There are no segments.
+         */
+        void clear();
+        /**
+         * @brief Number of segments.
+         * @return The number of segments.
+         * @pre None.
+         * @post The number of segments is returned.
+         */
+        size_t size() const;
+        /**
+         * @brief Start abscissas getter.
+         * @return The abscissas of the start points.
+         * @pre None.
+         * @post The abscissas of the start points are returned.
+         */
+        const vector<double>& getX0() const;
+        /**
+         * @brief Start ordinates getter.
+         * @return The ordinates of the start points.
+         * @pre None.
+         * @post The ordinates of the start points are returned.
+         */
+        const vector<double>& getY0() const;
+        /**
+         * @brief End abscissas getter.
+         * @return The abscissas of the end points.
+         * @pre None.
+         * @post The abscissas of the end points are returned.
+         */
+        const vector<double>& getX1() const;
+        /**
+         * @brief End ordinates getter.
+         * @return The ordinates of the end points.
+         * @pre None.
+         * @post The ordinates of the end points are returned.
+         */
+        const vector<double>& getY1() const;
+        /**
+         * @brief Writable start abscissas.
+         * @return The array of the abscissas of the start points.
+         * @pre There must be some segment.
+         * @post Valid until the segments are added or removed.
+         */
+        double* dataX0();
+        /**
+         * @brief Writable start ordinates.
+         * @return The array of the ordinates of the start points.
+         * @pre There must be some segment.
+         * @post Valid until the segments are added or removed.
+         */
+        double* dataY0();
+        /**
+         * @brief Writable end abscissas.
+         * @return The array of the abscissas of the end points.
+         * @pre There must be some segment.
+         * @post Valid until the segments are added or removed.
+         */
+        double* dataX1();
+        /**
+         * @brief Writable end ordinates.
+         * @return The array of the ordinates of the end points.
+         * @pre There must be some segment.
+         * @post Valid until the segments are added or removed.
+         */
+        double* dataY1();
+    private:
+        /**
+         * @brief The abscissas of the start points.
+         */
+        vector<double> theX0;
+        /**
+         * @brief The ordinates of the start points.
+         */
+        vector<double> theY0;
+        /**
+         * @brief The abscissas of the end points.
+         */
+        vector<double> theX1;
+        /**
+         * @brief The ordinates of the end points.
+         */
+        vector<double> theY1;
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Simplifier.hpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef SIMPLIFIER_HPP
+#define SIMPLIFIER_HPP
+
+#include "Segments.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class Simplifier
+ * @brief Output optimisation of the segments drawn by the turtle.
+ *
+ * Segments drawn more than once, in either direction, are kept only the
+ * first time, found with a spatial hash of their end points snapped to a
+ * grid. Runs of consecutive segments that continue each other in the
+ * same direction, as those of "F -> FF", are then merged into a single
+ * segment, and the merged segments deduplicated again. The drawing
+ * looks the same with a fraction of the segments, and the writers chain
+ * what is left into polylines as before.
+ *
+ * The grid and the collinearity test are relative to the size of the
+ * drawing, so the result does not depend on its scale.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class Simplifier {
+    public:
+        /**
+         * @brief Simplifier constructor.
+         * @param tolerance The snapping grid and the largest sine between
+         *     merged directions, relative to the size of the drawing.
+         * @post Builds the simplifier.
+         */
+        Simplifier(const double tolerance = 1e-9);
+        /**
+         * @brief Simplify the segments.
+         * @param segs The segments.
+         * @pre None.
+         * @post Duplicate segments are removed and collinear runs
+         *     merged, in drawing order.
+         */
+        void simplify(Segments &segs) const;
+    private:
+        /**
+         * @brief Remove the segments drawn before.
+         * @param segs The segments.
+         * @param quantum The side of the snapping grid.
+         * @pre The quantum must be positive.
+         * @post The first of every set of equal segments is kept.
+         */
+        void deduplicate(Segments &segs, const double quantum) const;
+        /**
+         * @brief Merge the runs of collinear segments.
+         * @param segs The segments.
+         * @param quantum The side of the snapping grid.
+         * @pre The quantum must be positive.
+         * @post No segment continues the previous one in its direction.
+         */
+        void merge(Segments &segs, const double quantum) const;
+        /**
+         * @brief The relative tolerance.
+         */
+        double theTolerance;
+};
+
+#endif
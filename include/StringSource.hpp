@@ -0,0 +1,78 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : StringSource.hpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef STRINGSOURCE_HPP
+#define STRINGSOURCE_HPP
+
+#include "SymbolSource.hpp"
+#include <string>
+
+using namespace std;
+
+/**
+ * @class StringSource
+ * @brief Symbol source over a production held in memory.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class StringSource : public SymbolSource {
+    public:
+        /**
+         * @brief String source constructor.
+         * @param prod The production.
+         * @pre The production must outlive the source.
+         * @post The source is positioned at the first symbol.
+         */
+        StringSource(const string &prod);
+        /**
+         * @brief Read the next block of symbols.
+         * @param buffer Where to write the symbols.
+         * @param size The capacity of the buffer.
+         * @return The number of symbols read, zero at the end.
+         * @pre The buffer must hold size symbols.
+         * @post The symbols are consumed from the source.
+         */
+        size_t read(char* buffer, const size_t size);
+    private:
+        /**
+         * @brief The production.
+         */
+        const string &theProd;
+        /**
+         * @brief Position of the next symbol.
+         */
+        size_t theOffset;
+};
+
+#endif
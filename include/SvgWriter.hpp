@@ -0,0 +1,71 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : SvgWriter.hpp                                               |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef SVGWRITER_HPP
+#define SVGWRITER_HPP
+
+#include "SegmentWriter.hpp"
+#include "Segments.hpp"
+#include <ostream>
+
+using namespace std;
+
+/**
+ * @class SvgWriter
+ * @brief Scalable Vector Graphics output of the segments.
+ *
+ * The segments are written as a single path, fitted to the view box of
+ * the drawing, with the ordinate axis pointing up as in Logo. A segment
+ * that starts where the previous one ends continues the same subpath.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class SvgWriter : public SegmentWriter {
+    public:
+        /**
+         * @brief SVG writer constructor.
+         * @post Builds the SVG writer.
+         */
+        SvgWriter();
+        /**
+         * @brief Write the segments.
+         * @param segs The segments.
+         * @param out Where to write the SVG document.
+         * @pre None.
+         * @post The segments are written as an SVG document.
+         */
+        void write(const Segments &segs, ostream &out) const;
+};
+
+#endif
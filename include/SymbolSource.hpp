@@ -0,0 +1,68 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : SymbolSource.hpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef SYMBOLSOURCE_HPP
+#define SYMBOLSOURCE_HPP
+
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class SymbolSource
+ * @brief Sequential source of the symbols of a production.
+ *
+ * Lets the turtle scan a production front to back, block by block,
+ * whether it is held in memory or generated on demand.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class SymbolSource {
+    public:
+        /**
+         * @brief Symbol source destructor.
+         */
+        virtual ~SymbolSource();
+        /**
+         * @brief Read the next block of symbols.
+         * @param buffer Where to write the symbols.
+         * @param size The capacity of the buffer.
+         * @return The number of symbols read, zero at the end.
+         * @pre The buffer must hold size symbols.
+         * @post The symbols are consumed from the source.
+         */
+        virtual size_t read(char* buffer, const size_t size) = 0;
+};
+
+#endif
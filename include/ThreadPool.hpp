@@ -0,0 +1,161 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ThreadPool.hpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+/**
+ * @class ThreadPool
+ * @brief Work-stealing pool of threads.
+ *
+ * Every worker has its own queue of tasks. The tasks are handed out to
+ * the queues in turn, and each worker runs the tasks of its own queue
+ * newest first. A worker whose queue runs dry steals the oldest task of
+ * another queue, so uneven tasks keep all the workers busy until the
+ * end.
+ *
+ * @author Alexandre Trilla (atrilla)
+ */
+class ThreadPool {
+    public:
+        /**
+         * @brief Thread pool constructor.
+         * @param numThreads The number of workers (at least one).
+         * @post The workers are started and wait for tasks.
+         */
+        ThreadPool(const unsigned int numThreads);
+        /**
+         * @brief Thread pool destructor.
+         * @post The pending tasks are run and the workers are joined.
+         */
+        ~ThreadPool();
+        /**
+         * @brief Submit a task.
+         * @param task The task.
+         * @pre The task must be safe to run concurrently with the rest.
+         * @post The task is queued and a worker is woken up.
+         */
+        void submit(const function<void()> &task);
+        /**
+         * @brief Wait for all the submitted tasks.
+         * @pre None.
+         * @post All the submitted tasks have run.
+         */
+        void wait();
+    private:
+        /**
+         * @brief Copy constructor, disabled.
+         */
+        ThreadPool(const ThreadPool &other);
+        /**
+         * @brief Assignment, disabled.
+         */
+        ThreadPool& operator=(const ThreadPool &other);
+        /**
+         * @brief Tasks of a worker.
+         */
+        struct Queue {
+            /**
+             * @brief Guard of the tasks.
+             */
+            mutex lock;
+            /**
+             * @brief The tasks, the newest at the back.
+             */
+            deque<function<void()> > tasks;
+        };
+        /**
+         * @brief Loop of a worker.
+         * @param worker The index of the worker.
+         * @pre None.
+         * @post Returns once the pool is stopped and no task is left.
+         */
+        void work(const unsigned int worker);
+        /**
+         * @brief Take a task, from the own queue or stolen from another.
+         * @param worker The index of the worker.
+         * @param task Where to put the task.
+         * @return False if all the queues are empty.
+         * @pre None.
+         * @post The task is removed from its queue.
+         */
+        bool take(const unsigned int worker, function<void()> &task);
+        /**
+         * @brief The queues, one per worker.
+         */
+        vector<Queue*> theQueues;
+        /**
+         * @brief The workers.
+         */
+        vector<thread> theWorkers;
+        /**
+         * @brief Guard of the counters and the stop flag.
+         */
+        mutex theLock;
+        /**
+         * @brief Signalled when a task is queued or the pool stops.
+         */
+        condition_variable theWake;
+        /**
+         * @brief Signalled when the last pending task is done.
+         */
+        condition_variable theDone;
+        /**
+         * @brief Tasks queued and not taken yet.
+         */
+        size_t theQueued;
+        /**
+         * @brief Tasks submitted and not done yet.
+         */
+        size_t thePending;
+        /**
+         * @brief Queue of the next submitted task.
+         */
+        unsigned int theNext;
+        /**
+         * @brief Whether the workers must stop.
+         */
+        bool theStop;
+};
+
+#endif
@@ -35,12 +35,19 @@
 #ifndef TURTLE_HPP
 #define TURTLE_HPP
 
+#include "SymbolSource.hpp"
+#include "Segments.hpp"
+#include "PlyWriter.hpp"
+#include "ParametricLsystem.hpp"
 #include <string>
 #include <map>
 #include <vector>
+#include <ostream>
 
 using namespace std;
 
+class Lsystem;
+
 /**
  * @class Turtle
  * @brief Turtle graphics interface (Logo code generator).
@@ -52,9 +59,68 @@ using namespace std;
  * <a href="http://www.cs.berkeley.edu/~bh/logo.html">ucblogo</a>,
  * which is available in common user GNU/Linux software repos.
  *
+ * The drawing instructions of every symbol are compiled once into a
+ * short program of opcodes with numeric operands, so the interpretation
+ * of a production is a table dispatch per symbol. The Logo code of
+ * every symbol is rendered from its program once, and the code is
+ * written to the output stream through a small buffer as the symbols
+ * arrive, so the memory does not depend on the size of the drawing.
+ *
+ * Alternatively, the turtle can be run natively in double precision to
+ * trace the line segments of the drawing, without a Logo interpreter.
+ * The native turtle follows the Logo conventions: the heading is
+ * measured in degrees clockwise from the ordinate axis, and positions
+ * and headings are saved in two separate stacks.
+ *
+ * If all the turns are whole multiples of a common angle (e.g., 25 or 60
+ * degrees), the headings are kept as an index into a table of their
+ * sines and cosines, and the positions in fixed point, as integers of
+ * 2^-64 drawing units, so that every move adds an exact integer taken
+ * from a table of the moves along every heading. The coordinates of the
+ * segments are those positions rounded to double precision, and they
+ * agree with a step by step interpretation in double precision within
+ * 1e-9 drawing units for drawings of the size of the shipped examples
+ * (the rounding error of the latter). Otherwise, the positions are kept
+ * in double precision, and the runs of symbols that just draw forward,
+ * like the chains of F from "F -> FF", keep the heading, so their
+ * segments are computed in batches from the cumulative distances, with
+ * AVX or SSE2 when available and a scalar loop otherwise.
+ *
+ * A production held in memory may also be traced by several threads, if
+ * the turns are whole multiples of a common angle. The production is
+ * split into chunks, and every thread first sums up the chunks it takes
+ * as their changes of the heading index, relative to the heading they
+ * start with and to the headings they pop from below the stack they
+ * start with, and as the headings they leave pushed. A quick scan over
+ * those summaries gives the heading and the stack of headings at the
+ * start of every chunk. The threads then sum up the moves of the chunks
+ * the same way, from their known headings, into exact position deltas,
+ * and another scan gives the position and the stack of positions at
+ * their start. The chunks are finally drawn concurrently from those
+ * states. As the sums are exact in any order, the segments are those of
+ * the serial tracing bit for bit, and no pass over the whole production
+ * is serial.
+ *
+ * The turtle may also be run in space, with the pitch ("pitchDown",
+ * "pitchUp"), roll ("rollLeft", "rollRight") and reversal ("turnAround")
+ * instructions besides the turns, which yaw. Its orientation is a
+ * rotation matrix of three unit vectors, the heading, left and up
+ * directions, and every rotation is a plane rotation of two of them
+ * with a sine and cosine computed when the instructions are compiled.
+ * The segments are streamed to a PLY file (see PlyWriter). Drawn on the
+ * plane, the turtle ignores pitch and roll, and a space drawing without
+ * them lies on the plane as the plane one.
+ *
+ * The modules of a parametric L-system (see ParametricLsystem) move
+ * forward by their first parameter instead of the length of the
+ * instructions, e.g., "F(l)" draws a segment of length l, while their
+ * turns keep the angles of the instructions. Space drawings do not
+ * take the parameters.
+ *
  * @author Alexandre Trilla (atrilla)
  */
 class Turtle {
+    friend class Extent;
     public:
         /**
          * @brief Turtle constructor.
@@ -62,20 +128,522 @@ class Turtle {
          */
         Turtle();
         /**
-         * @brief Replace graphical instructions.
-         * @param L-system production by iteration.
+         * @brief Parametric turtle constructor.
          * @param corresp The correspondence between symbols and 
          *     drawing instructions.
+         * @pre The parser must deliver the correspondence.
+         * @post Builds the turtle graphics with the compiled drawing
+         *     instructions.
+         */
+        Turtle(const map<char, string> &corresp);
+        /**
+         * @brief Replace graphical instructions.
+         * @param prod L-system production by iteration.
          * @param scale Scale of the drawing.
          * @param iniPos The initial position.
          * @param iniAng The initial angle.
-         * @pre L-system must deliver production and parser must
-         *     deliver the correspondence.
-         * @post Generates the instructions to draw.
+         * @param out Where to write the instructions to draw.
+         * @pre L-system must deliver production.
+         * @post Writes the instructions to draw.
+         */
+        void rewrite(const string &prod, const string &scale,
+                const vector<string> &iniPos, const string &iniAng,
+                ostream &out) const;
+        /**
+         * @brief Replace graphical instructions of a production that is
+         *     read sequentially, e.g., derived on demand.
+         * @param prod Source of the L-system production.
+         * @param scale Scale of the drawing.
+         * @param iniPos The initial position.
+         * @param iniAng The initial angle.
+         * @param out Where to write the instructions to draw.
+         * @pre The source must deliver the production.
+         * @post Writes the instructions to draw. The source is consumed.
+         */
+        void rewrite(SymbolSource &prod, const string &scale,
+                const vector<string> &iniPos, const string &iniAng,
+                ostream &out) const;
+        /**
+         * @brief Replace graphical instructions of a production of
+         *     modules, whose first parameter is the length of their
+         *     forward moves.
+         * @param lsys The L-system of the modules.
+         * @param prod The production of modules.
+         * @param scale Scale of the drawing.
+         * @param iniPos The initial position.
+         * @param iniAng The initial angle.
+         * @param out Where to write the instructions to draw.
+         * @pre The L-system must deliver the production.
+         * @post Writes the instructions to draw.
+         */
+        void rewrite(const ParametricLsystem &lsys,
+                const ParametricLsystem::Modules &prod, const string &scale,
+                const vector<string> &iniPos, const string &iniAng,
+                ostream &out) const;
+        /**
+         * @brief Trace the line segments of the drawing.
+         * @param prod L-system production by iteration.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param out Where to append the segments.
+         * @pre L-system must deliver production.
+         * @post The segments are drawn in order.
+         */
+        void trace(const string &prod, const double scale,
+                const double iniX, const double iniY, const double iniAng,
+                Segments &out) const;
+        /**
+         * @brief Trace the line segments of a production that is read
+         *     sequentially, e.g., derived on demand.
+         * @param prod Source of the L-system production.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param out Where to append the segments.
+         * @pre The source must deliver the production.
+         * @post The segments are drawn in order. The source is consumed.
+         */
+        void trace(SymbolSource &prod, const double scale,
+                const double iniX, const double iniY, const double iniAng,
+                Segments &out) const;
+        /**
+         * @brief Trace the line segments of a production of modules,
+         *     whose first parameter is the length of their forward moves.
+         * @param lsys The L-system of the modules.
+         * @param prod The production of modules.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param out Where to append the segments.
+         * @pre The L-system must deliver the production.
+         * @post The segments are drawn in order.
+         */
+        void trace(const ParametricLsystem &lsys,
+                const ParametricLsystem::Modules &prod, const double scale,
+                const double iniX, const double iniY, const double iniAng,
+                Segments &out) const;
+        /**
+         * @brief Trace the line segments of the drawing with several
+         *     threads.
+         *
+         * The production is split into chunks of a fixed size, and the
+         * segments are exactly those of the serial tracing, whatever the
+         * number of threads. With a single thread, or turns that are not
+         * whole multiples of a common angle, the production is traced
+         * serially.
+         * @param prod L-system production by iteration.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param out Where to append the segments.
+         * @param numThreads The number of threads to use.
+         * @pre L-system must deliver production.
+         * @post The segments are drawn in order.
+         */
+        void trace(const string &prod, const double scale,
+                const double iniX, const double iniY, const double iniAng,
+                Segments &out, const unsigned int numThreads) const;
+        /**
+         * @brief Trace the line segments of a production held in a
+         *     buffer, e.g., a mapped file, with several threads.
+         * @param prod The symbols of the production.
+         * @param size The number of symbols.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param out Where to append the segments.
+         * @param numThreads The number of threads to use.
+         * @pre The buffer must hold the production.
+         * @post The segments are drawn in order, as by the tracing of the
+         *     same production in a string.
+         */
+        void trace(const char* prod, const size_t size,
+                const double scale, const double iniX, const double iniY,
+                const double iniAng, Segments &out,
+                const unsigned int numThreads) const;
+        /**
+         * @brief Whether some modules draw forward by their parameters.
+         * @param lsys The L-system of the modules.
+         * @return True if a symbol with parameters draws forward.
+         * @pre The L-system must be compiled.
+         * @post The symbols are checked.
+         */
+        bool isParametric(const ParametricLsystem &lsys) const;
+        /**
+         * @brief Number of segments drawn by a symbol.
+         * @param symbol The symbol.
+         * @return The number of forward moves of its instructions.
+         * @pre None.
+         * @post The number of segments is returned.
+         */
+        unsigned int getDraws(const char symbol) const;
+        /**
+         * @brief Number of segments drawn by a production.
+         * @param prod Source of the L-system production.
+         * @return The number of forward moves of its symbols.
+         * @pre The source must deliver the production.
+         * @post The number of segments is returned. The source is
+         *     consumed.
+         */
+        unsigned long long getDraws(SymbolSource &prod) const;
+        /**
+         * @brief Scale and initial position that fit the drawing in a
+         *     square view centred at the origin, from its bounding box
+         *     (see Extent), without rendering it.
+         * @param lsys The L-system.
+         * @param numIter The number of iterations to run.
+         * @param iniAng The initial angle.
+         * @param size The side of the view.
+         * @param scale Where to put the drawing reduction scale.
+         * @param iniX Where to put the initial abscissa.
+         * @param iniY Where to put the initial ordinate.
+         * @return False if nothing is drawn (and the outputs are left
+         *     untouched).
+         * @pre The L-system must be defined.
+         * @post The drawing is centred and its longest side spans the
+         *     view.
+         */
+        bool fit(const Lsystem &lsys, const int numIter, const double iniAng,
+                const double size, double &scale, double &iniX,
+                double &iniY) const;
+        /**
+         * @brief Trace the line segments of the drawing down to a level of
+         *     detail, deriving it as it is drawn (see Extent).
+         *
+         * The expansion of a symbol whose box is no larger than the
+         * tolerance is drawn as a single segment from where it starts to
+         * where it ends. Grammars that are stochastic or whose turns are
+         * not discrete are traced in full.
+         * @param lsys The L-system.
+         * @param numIter The number of iterations to run.
+         * @param tolerance The largest side of the box of an expansion
+         *     drawn as a single segment, in drawing units.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param out Where to append the segments.
+         * @pre The L-system must be defined.
+         * @post The segments are drawn in order, each one within a box
+         *     no larger than the tolerance around the part of the whole
+         *     drawing that it stands for.
+         */
+        void trace(const Lsystem &lsys, const int numIter,
+                const double tolerance, const double scale,
+                const double iniX, const double iniY, const double iniAng,
+                Segments &out) const;
+        /**
+         * @brief Trace the line segments of the drawing in space, read
+         *     sequentially, e.g., derived on demand.
+         *
+         * The turtle starts on the plane of the ordinary drawing, at
+         * zero height, with the up direction out of it.
+         * @param prod Source of the L-system production.
+         * @param scale Scale of the drawing.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param out Where to write the segments.
+         * @pre The source must deliver the production.
+         * @post The segments are written in order. The source is
+         *     consumed.
          */
-        string rewrite(const string prod, map<char, string> corresp,
-                string scale, vector<string> iniPos, string iniAng) const;
+        void trace(SymbolSource &prod, const double scale,
+                const double iniX, const double iniY, const double iniAng,
+                PlyWriter &out) const;
     private:
+        /**
+         * @brief Turtle opcodes.
+         */
+        enum Opcode {
+            DRAW_FORWARD,
+            TURN_LEFT,
+            TURN_RIGHT,
+            PUSH_POS,
+            POP_POS,
+            PUSH_ANG,
+            POP_ANG,
+            PITCH_DOWN,
+            PITCH_UP,
+            ROLL_LEFT,
+            ROLL_RIGHT
+        };
+        /**
+         * @brief Compiled program of a symbol.
+         */
+        struct Program {
+            /**
+             * @brief Index of the first instruction.
+             */
+            unsigned int first;
+            /**
+             * @brief Number of instructions.
+             */
+            unsigned int count;
+        };
+        /**
+         * @brief Fixed-point coordinate, in units of 2^-64 drawing units.
+         */
+        typedef __int128 Fixed;
+        /**
+         * @brief Point in fixed point.
+         */
+        struct Point {
+            /**
+             * @brief The coordinates.
+             */
+            Fixed x, y;
+        };
+        /**
+         * @brief Value relative to the one before some symbols, or to one
+         *     that they pop from below the stack they start with.
+         */
+        template <class T>
+        struct Relative {
+            /**
+             * @brief Minus one for the value before the symbols, or the
+             *     number of pops from below before the one of the base.
+             */
+            int base;
+            /**
+             * @brief The change since the base.
+             */
+            T delta;
+        };
+        /**
+         * @brief Effect of some symbols on a value that they save and
+         *     restore on a stack, e.g., the heading index, relative to
+         *     the value and the stack before them.
+         */
+        template <class T>
+        struct Summary {
+            /**
+             * @brief The value after the symbols.
+             */
+            Relative<T> last;
+            /**
+             * @brief The values left pushed, from the bottom up.
+             */
+            vector<Relative<T> > pushed;
+            /**
+             * @brief The value before every pop from below, which it
+             *     keeps if the stack is empty.
+             */
+            vector<Relative<T> > below;
+        };
+        /**
+         * @brief State of the native turtle.
+         */
+        struct Pen {
+            /**
+             * @brief The position.
+             */
+            double x, y;
+            /**
+             * @brief The position in fixed point, if the heading is
+             *     discrete, which the position rounds.
+             */
+            Point fixed;
+            /**
+             * @brief The heading in degrees, if it is continuous.
+             */
+            double heading;
+            /**
+             * @brief The heading index, if it is discrete.
+             */
+            int index;
+            /**
+             * @brief The unit vector of the heading.
+             */
+            double dirX, dirY;
+            /**
+             * @brief The saved positions, as pairs of coordinates, if the
+             *     heading is continuous.
+             */
+            vector<double> posStack;
+            /**
+             * @brief The saved positions in fixed point, if the heading
+             *     is discrete.
+             */
+            vector<Point> fixedStack;
+            /**
+             * @brief The saved headings (or heading indices).
+             */
+            vector<double> angStack;
+            /**
+             * @brief Sines and cosines of the discrete headings (empty if
+             *     the heading is continuous).
+             */
+            vector<double> lutSin, lutCos;
+            /**
+             * @brief Move of every instruction along every discrete
+             *     heading, one heading after the other (zero if the
+             *     instruction does not draw), held by the tracing.
+             */
+            const Point* moves;
+            /**
+             * @brief Scratch buffer of cumulative distances.
+             */
+            vector<double> offsets;
+        };
+        /**
+         * @brief Set the pen at the initial state.
+         * @param iniX The initial abscissa.
+         * @param iniY The initial ordinate.
+         * @param iniAng The initial angle.
+         * @param scale Scale of the drawing.
+         * @param moves Where to build the table of the moves, for the
+         *     pen.
+         * @param pen The pen.
+         * @pre The correspondence must be compiled.
+         * @post The pen is ready to draw, with the heading table and the
+         *     table of the moves built if the turns are discrete.
+         */
+        void setup(const double iniX, const double iniY,
+                const double iniAng, const double scale,
+                vector<Point> &moves, Pen &pen) const;
+        /**
+         * @brief Draw some symbols.
+         * @param symbols The symbols.
+         * @param count The number of symbols.
+         * @param scale Scale of the drawing.
+         * @param pen The pen.
+         * @param out Where to append the segments.
+         * @pre The pen must be set up.
+         * @post The segments are drawn and the pen is moved.
+         */
+        void draw(const char* symbols, const size_t count,
+                const double scale, Pen &pen, Segments &out) const;
+        /**
+         * @brief Sum up the turns of some symbols.
+         * @param symbols The symbols.
+         * @param count The number of symbols.
+         * @param numHeadings The number of discrete headings.
+         * @param turns The changes of the heading index, relative to the
+         *     heading and the saved headings before the symbols.
+         * @pre The turns must be discrete.
+         * @post The turns are summed up.
+         */
+        void summarise(const char* symbols, const size_t count,
+                const int numHeadings, Summary<int> &turns) const;
+        /**
+         * @brief Sum up the moves of some symbols.
+         * @param symbols The symbols.
+         * @param count The number of symbols.
+         * @param pen The pen, at the heading and with the saved headings
+         *     before the symbols.
+         * @param moves The changes of the position, relative to the
+         *     position and the saved positions before the symbols.
+         * @pre The pen must be set up, with discrete turns.
+         * @post The moves are summed up, and the pen is turned as the
+         *     symbols turn it.
+         */
+        void summarise(const char* symbols, const size_t count, Pen &pen,
+                Summary<Point> &moves) const;
+        /**
+         * @brief Apply a summary to a value and its stack.
+         * @param summary The summary of some symbols.
+         * @param start The value before the symbols.
+         * @param stack The stack before the symbols, and then after them.
+         * @param add The sum of a base and a change.
+         * @return The value after the symbols.
+         * @pre None.
+         * @post The pops from below take the values on top of the stack,
+         *     or keep the value if it is empty, and the values left
+         *     pushed are pushed.
+         */
+        template <class T, class Add>
+        static T settle(const Summary<T> &summary, const T &start,
+                vector<T> &stack, const Add &add);
+        /**
+         * @brief Run a turn or a stack instruction.
+         * @param pc Index of the instruction.
+         * @param pen The pen.
+         * @pre The pen must be set up.
+         * @post The pen is turned, or its state saved or restored.
+         */
+        void steer(const unsigned int pc, Pen &pen) const;
+        /**
+         * @brief Compile the drawing instructions of a symbol.
+         * @param symbol The symbol.
+         * @param instros The drawing instructions.
+         * @pre None.
+         * @post The program of the symbol is appended to the code.
+         */
+        void compile(const char symbol, const string &instros);
+        /**
+         * @brief Render the Logo code of a symbol.
+         * @param symbol The symbol.
+         * @param scale Scale of the drawing.
+         * @param length The length of the forward moves, if not the one
+         *     of the instructions.
+         * @return The Logo code of the program of the symbol.
+         * @pre The correspondence must be compiled.
+         * @post The program is rendered.
+         */
+        string translate(const char symbol, const string &scale,
+                const string &length = "") const;
+        /**
+         * @brief Logo code that sets up the drawing.
+         * @param iniPos The initial position.
+         * @param iniAng The initial angle.
+         * @return The Logo code before the drawing instructions.
+         * @pre None.
+         * @post The setup is rendered.
+         */
+        string preamble(const vector<string> &iniPos,
+                const string &iniAng) const;
+        /**
+         * @brief Find the common angle of all the turns.
+         * @pre The correspondence must be compiled.
+         * @post Sets the angle step and the turn steps, or a zero angle
+         *     step if the turns are not whole multiples of a common
+         *     angle.
+         */
+        void discretise();
+        /**
+         * @brief Opcodes of all the programs, one after the other.
+         */
+        vector<unsigned char> theCode;
+        /**
+         * @brief Numeric operand of every opcode (zero if it has none).
+         */
+        vector<double> theOperands;
+        /**
+         * @brief Text of the numeric operand of every opcode, as defined,
+         *     for the Logo code.
+         */
+        vector<string> theTexts;
+        /**
+         * @brief Program table indexed by symbol.
+         */
+        Program thePrograms[256];
+        /**
+         * @brief Whether the program of a symbol is a single forward
+         *     move, indexed by symbol.
+         */
+        bool theStraight[256];
+        /**
+         * @brief Common angle of all the turns in degrees (zero if there
+         *     is none).
+         */
+        double theAngleStep;
+        /**
+         * @brief Number of angle steps of every turn opcode.
+         */
+        vector<int> theTurnSteps;
+        /**
+         * @brief Cosine and sine of the rotation of every turn, pitch
+         *     and roll opcode, signed by its direction (no rotation if it
+         *     is not one).
+         */
+        vector<double> theCosines, theSines;
         /**
          * @brief Starter Logo code.
          */
@@ -83,4 +651,3 @@ class Turtle {
 };
 
 #endif
-
@@ -1,5 +1,5 @@
 solution "lsystem"
-    configurations { "debug", "release" }
+    configurations { "debug", "release", "profile" }
 
 project "lsystem"
     kind "ConsoleApp"
@@ -8,6 +8,9 @@ project "lsystem"
     includedirs { "include" }
     -- Sources
     files { "src/**.cpp" }
+    -- Options
+    buildoptions { "-std=c++17", "-pthread" }
+    linkoptions { "-pthread" }
     -- Libraries
     libdirs { os.findlib("boost_iostreams") }
     links { "boost_iostreams" }
@@ -20,5 +23,48 @@ project "lsystem"
     configuration "release"
         defines { "NDEBUG" }
         flags { "Optimize" }
+        -- Vector extensions of the building machine (AVX, FMA...)
+        buildoptions { "-march=native" }
         targetdir "bin/release"
 
+    configuration "profile"
+        defines { "NDEBUG" }
+        flags { "Optimize", "Symbols" }
+        -- Frame pointers, for the call stacks of the profilers
+        buildoptions { "-march=native", "-fno-omit-frame-pointer" }
+        targetdir "bin/profile"
+
+
+project "bench"
+    kind "ConsoleApp"
+    language "C++"
+    -- Includes
+    includedirs { "include", "bench" }
+    -- Sources
+    files { "src/**.cpp", "bench/**.cpp" }
+    excludes { "src/main.cpp" }
+    -- Options
+    buildoptions { "-std=c++17", "-pthread" }
+    linkoptions { "-pthread" }
+    -- Libraries
+    libdirs { os.findlib("boost_iostreams") }
+    links { "boost_iostreams" }
+
+    configuration "debug"
+        defines { "DEBUG" }
+        flags { "Symbols" }
+        targetdir "bin/debug"
+
+    configuration "release"
+        defines { "NDEBUG" }
+        flags { "Optimize" }
+        -- Vector extensions of the building machine (AVX, FMA...)
+        buildoptions { "-march=native" }
+        targetdir "bin/release"
+
+    configuration "profile"
+        defines { "NDEBUG" }
+        flags { "Optimize", "Symbols" }
+        -- Frame pointers, for the call stacks of the profilers
+        buildoptions { "-march=native", "-fno-omit-frame-pointer" }
+        targetdir "bin/profile"
@@ -0,0 +1,283 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Batch.cpp                                                   |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Batch.hpp"
+#include "Parser.hpp"
+#include "Lsystem.hpp"
+#include "Turtle.hpp"
+#include "ExpansionCache.hpp"
+#include "Random.hpp"
+#include "Segments.hpp"
+#include "SvgWriter.hpp"
+#include "BinaryWriter.hpp"
+#include "RasterWriter.hpp"
+#include "PlyWriter.hpp"
+#include "StringSource.hpp"
+#include "ThreadPool.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <istream>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+
+using namespace std;
+
+/**
+ * @brief Read a whole number, which must be all of the text.
+ */
+template <class T>
+static bool whole(const string &text, T &value) {
+    from_chars_result result = from_chars(text.data(),
+        text.data() + text.size(), value);
+    return !text.empty() && (result.ec == errc()) &&
+        (result.ptr == text.data() + text.size());
+}
+
+Batch::Batch(const unsigned int pixels) : thePixels(pixels) {
+}
+
+bool Batch::load(istream &manifest, string &error) {
+    string line, iterations, seed, extra, reason;
+    unsigned int number = 0;
+    bool valid = true;
+    Job job;
+    map<string, int> depths;
+    map<string, int>::const_iterator depth;
+    size_t index;
+    while (valid && manifest.good()) {
+        getline(manifest, line);
+        number++;
+        istringstream fields(line);
+        // Skip blank lines and comments
+        if ((fields >> job.definition) && (job.definition.at(0) != '#')) {
+            valid = (fields >> iterations >> seed >> job.backend >>
+                job.output) && !(fields >> extra) &&
+                (!job.backend.compare("logo") ||
+                !job.backend.compare("svg") || !job.backend.compare("bin") ||
+                !job.backend.compare("ppm") || !job.backend.compare("png") ||
+                !job.backend.compare("ply"));
+            job.iterations = -1;
+            if (!valid) {
+                ostringstream message;
+                message << "manifest line " << number << ": expected " <<
+                    "\"definition iterations seed " <<
+                    "logo|svg|bin|ppm|png|ply output\"";
+                error = message.str();
+            } else if (iterations.compare("-") &&
+                    (!whole(iterations, job.iterations) ||
+                    (job.iterations < 0))) {
+                ostringstream message;
+                message << "manifest line " << number << ": expected " <<
+                    "a number of iterations or \"-\"";
+                error = message.str();
+                valid = false;
+            } else if (!whole(seed, job.seed)) {
+                ostringstream message;
+                message << "manifest line " << number << ": expected a seed";
+                error = message.str();
+                valid = false;
+            } else if (theGrammars.find(job.definition) ==
+                    theGrammars.end()) {
+                // Every definition is parsed and compiled only once
+                Grammar &grammar = theGrammars[job.definition];
+                valid = grammar.parser.parse(job.definition, reason);
+                if (valid) {
+                    grammar.lsys = Lsystem(grammar.parser.getAlphabet(),
+                        grammar.parser.getAxiom(),
+                        grammar.parser.getRules());
+                    grammar.ninja = Turtle(grammar.parser.getTurtle());
+                    grammar.modular =
+                        !grammar.parser.getModuleRules().empty();
+                    valid = !grammar.modular || grammar.modules.compile(
+                        grammar.parser.getAxiom(), grammar.parser.getRules(),
+                        grammar.parser.getModuleRules(),
+                        grammar.parser.getIgnored(),
+                        grammar.parser.getOpening(),
+                        grammar.parser.getClosing(), reason);
+                    if (!valid) {
+                        reason = job.definition + ": " + reason;
+                    }
+                }
+                if (!valid) {
+                    ostringstream message;
+                    message << "manifest line " << number << ": " << reason;
+                    error = message.str();
+                }
+            }
+            if (valid && !job.backend.compare("ply")) {
+                const Grammar &grammar = theGrammars[job.definition];
+                valid = !grammar.modular ||
+                    !grammar.ninja.isParametric(grammar.modules);
+                if (!valid) {
+                    ostringstream message;
+                    message << "manifest line " << number << ": ply " <<
+                        "does not draw modules by their parameters";
+                    error = message.str();
+                }
+            }
+            if (valid) {
+                theJobs.push_back(job);
+            }
+        }
+    }
+    // The subtrees of a definition are cached as deep as its deepest job
+    if (valid) {
+        for (index = 0; index < theJobs.size(); index++) {
+            const Job &queued = theJobs[index];
+            const Grammar &grammar =
+                theGrammars.find(queued.definition)->second;
+            if (!grammar.modular) {
+                int &deepest = depths[queued.definition];
+                deepest = max(deepest, queued.iterations >= 0 ?
+                    queued.iterations : grammar.parser.getIterations());
+            }
+        }
+        theCaches.clear();
+        for (depth = depths.begin(); depth != depths.end(); depth++) {
+            theCaches.emplace(piecewise_construct,
+                forward_as_tuple(depth->first),
+                forward_as_tuple(theGrammars.find(depth->first)->second.lsys,
+                depth->second));
+        }
+    }
+    return valid;
+}
+
+unsigned int Batch::run(const unsigned int numThreads) const {
+    atomic<unsigned int> failures(0);
+    mutex report;
+    size_t index;
+    ThreadPool pool(numThreads);
+    for (index = 0; index < theJobs.size(); index++) {
+        pool.submit([this, index, &failures, &report]() {
+            string error;
+            if (!render(theJobs[index], error)) {
+                lock_guard<mutex> guard(report);
+                cout << error << endl;
+                failures++;
+            }
+        });
+    }
+    pool.wait();
+    return failures;
+}
+
+size_t Batch::getJobs() const {
+    return theJobs.size();
+}
+
+bool Batch::render(const Job &job, string &error) const {
+    const Grammar &grammar = theGrammars.find(job.definition)->second;
+    const Parser &p = grammar.parser;
+    int iterations = job.iterations >= 0 ? job.iterations :
+        p.getIterations();
+    ParametricLsystem::Modules modules;
+    string prod, reason;
+    ofstream out(job.output.c_str(), ios::out | ios::binary);
+    if (out.is_open()) {
+        if (grammar.modular) {
+            modules = grammar.modules.produce(iterations);
+        } else {
+            // Shares the compiled rules and their cached subtrees, with
+            // the seed of the job
+            prod = grammar.lsys.produce(iterations, Random(job.seed), 1,
+                &theCaches.find(job.definition)->second);
+        }
+        if (!job.backend.compare("logo") && grammar.modular) {
+            grammar.ninja.rewrite(grammar.modules, modules,
+                p.getReductionScale(), p.getInitPos(), p.getInitAng(), out);
+        } else if (!job.backend.compare("logo")) {
+            grammar.ninja.rewrite(prod, p.getReductionScale(),
+                p.getInitPos(), p.getInitAng(), out);
+        } else if (!job.backend.compare("ply")) {
+            StringSource counting(grammar.modular ? modules.symbols : prod);
+            StringSource source(grammar.modular ? modules.symbols : prod);
+            unsigned long long numSegs = grammar.ninja.getDraws(counting);
+            if (!PlyWriter::fits(numSegs, reason)) {
+                error = job.output + ": " + reason;
+                return false;
+            }
+            PlyWriter ply(out, numSegs);
+            grammar.ninja.trace(source, atof(p.getReductionScale().c_str()),
+                atof(p.getInitPos()[0].c_str()),
+                atof(p.getInitPos()[1].c_str()),
+                atof(p.getInitAng().c_str()), ply);
+            if (!ply.close(reason)) {
+                error = job.output + ": " + reason;
+                return false;
+            }
+        } else {
+            Segments segs;
+            if (grammar.modular) {
+                grammar.ninja.trace(grammar.modules, modules,
+                    atof(p.getReductionScale().c_str()),
+                    atof(p.getInitPos()[0].c_str()),
+                    atof(p.getInitPos()[1].c_str()),
+                    atof(p.getInitAng().c_str()), segs);
+            } else {
+                grammar.ninja.trace(prod,
+                    atof(p.getReductionScale().c_str()),
+                    atof(p.getInitPos()[0].c_str()),
+                    atof(p.getInitPos()[1].c_str()),
+                    atof(p.getInitAng().c_str()), segs);
+            }
+            if (!job.backend.compare("svg")) {
+                SvgWriter().write(segs, out);
+            } else if (!job.backend.compare("ppm")) {
+                RasterWriter(thePixels, RasterWriter::PPM).write(segs, out);
+            } else if (!job.backend.compare("png")) {
+                RasterWriter(thePixels, RasterWriter::PNG).write(segs, out);
+            } else {
+                BinaryWriter().write(segs, out);
+            }
+        }
+        out.close();
+    } else {
+        error = "error opening file " + job.output;
+        return false;
+    }
+    if (out.fail()) {
+        error = "error writing file " + job.output;
+        return false;
+    }
+    return true;
+}
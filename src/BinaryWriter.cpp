@@ -0,0 +1,95 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : BinaryWriter.cpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "BinaryWriter.hpp"
+#include "Segments.hpp"
+#include <vector>
+#include <ostream>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Number of values encoded before writing them out.
+ */
+static const size_t BLOCK_SIZE = 4096;
+
+/**
+ * @brief Encode an unsigned integer in little-endian byte order.
+ */
+static void encode(char* bytes, unsigned long long value,
+        const int numBytes) {
+    int byte;
+    for (byte = 0; byte < numBytes; byte++) {
+        bytes[byte] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+/**
+ * @brief Write a coordinate array as little-endian doubles.
+ */
+static void writeArray(ostream &out, const vector<double> &coords) {
+    char bytes[8*BLOCK_SIZE];
+    size_t coord, count = 0;
+    union {
+        double real;
+        unsigned long long bits;
+    } value;
+    for (coord = 0; coord < coords.size(); coord++) {
+        value.real = coords[coord];
+        encode(bytes + 8*count, value.bits, 8);
+        count++;
+        if (count == BLOCK_SIZE) {
+            out.write(bytes, 8*count);
+            count = 0;
+        }
+    }
+    out.write(bytes, 8*count);
+}
+
+BinaryWriter::BinaryWriter() {
+}
+
+void BinaryWriter::write(const Segments &segs, ostream &out) const {
+    char header[16];
+    memcpy(header, "LSEG", 4);
+    encode(header + 4, 1, 4);
+    encode(header + 8, segs.size(), 8);
+    out.write(header, 16);
+    writeArray(out, segs.getX0());
+    writeArray(out, segs.getY0());
+    writeArray(out, segs.getX1());
+    writeArray(out, segs.getY1());
+}
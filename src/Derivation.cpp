@@ -0,0 +1,115 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Derivation.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Derivation.hpp"
+#include "Lsystem.hpp"
+#include "ExpansionCache.hpp"
+#include <vector>
+#include <cstring>
+
+using namespace std;
+
+Derivation::Derivation(const Lsystem &lsys, const int numIter,
+        const ExpansionCache *cache) : theLsystem(lsys), theCache(cache) {
+    Frame axiom;
+    theNumIter = numIter > 0 ? numIter : 0;
+    theStack.reserve(theNumIter + 1);
+    theCounters.resize(theNumIter + 1, 0);
+    axiom.symbols = lsys.getAxiom().data();
+    axiom.length = lsys.getAxiom().size();
+    axiom.offset = 0;
+    theStack.push_back(axiom);
+    theCopy.symbols = NULL;
+    theCopy.length = 0;
+    theCopy.offset = 0;
+}
+
+size_t Derivation::read(char* buffer, const size_t size) {
+    size_t count = 0;
+    size_t chunk;
+    unsigned int epoch, later;
+    Frame next;
+    char symbol;
+    // A cached subtree is copied before its frame may be popped
+    while ((count < size) && !theStack.empty()) {
+        Frame &top = theStack.back();
+        epoch = theStack.size() - 1;
+        if (theCopy.offset < theCopy.length) {
+            chunk = theCopy.length - theCopy.offset;
+            if (chunk > size - count) {
+                chunk = size - count;
+            }
+            memcpy(buffer + count, theCopy.symbols + theCopy.offset, chunk);
+            theCopy.offset += chunk;
+            count += chunk;
+        } else if (top.offset == top.length) {
+            theStack.pop_back();
+        } else if (epoch == theNumIter) {
+            // Last generation: copy as much as fits
+            chunk = top.length - top.offset;
+            if (chunk > size - count) {
+                chunk = size - count;
+            }
+            memcpy(buffer + count, top.symbols + top.offset, chunk);
+            top.offset += chunk;
+            theCounters[epoch] += chunk;
+            count += chunk;
+        } else {
+            symbol = top.symbols[top.offset];
+            top.offset++;
+            next.offset = 0;
+            if ((theCache != NULL) && theCache->lookup(symbol,
+                    theNumIter - epoch, theCopy.symbols, theCopy.length)) {
+                // Stored subtree: copied, and only measured below
+                theCopy.offset = 0;
+                for (later = epoch + 1; later <= theNumIter; later++) {
+                    theCounters[later] += theCache->length(symbol,
+                        later - epoch);
+                }
+            } else if (theLsystem.expand(symbol, epoch, theCounters[epoch],
+                    next.symbols, next.length)) {
+                theStack.push_back(next);
+            } else {
+                // Constants keep their place in every later generation
+                for (later = epoch + 1; later <= theNumIter; later++) {
+                    theCounters[later]++;
+                }
+                buffer[count] = symbol;
+                count++;
+            }
+            theCounters[epoch]++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,122 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : DerivationSession.cpp                                       |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "DerivationSession.hpp"
+#include "Lsystem.hpp"
+#include "ProductionFile.hpp"
+#include <string>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace std;
+
+DerivationSession::DerivationSession(const Lsystem &lsys,
+        const unsigned int numThreads) : theLsystem(lsys) {
+    theNumThreads = numThreads;
+    theProduction = lsys.getAxiom();
+    theEpoch = 0;
+    theCheckpointEpoch = -1;
+}
+
+void DerivationSession::advance(const unsigned int count) {
+    unsigned int step;
+    for (step = 0; step < count; step++) {
+        theLsystem.rewriteParallel(theProduction, theLsystem.theRandom,
+            theEpoch, theNext, theNumThreads);
+        theProduction.swap(theNext);
+        theEpoch++;
+    }
+}
+
+void DerivationSession::checkpoint() {
+    theCheckpoint = theProduction;
+    theCheckpointEpoch = theEpoch;
+}
+
+bool DerivationSession::rollback() {
+    if (theCheckpointEpoch < 0) {
+        return false;
+    }
+    theProduction = theCheckpoint;
+    theEpoch = theCheckpointEpoch;
+    return true;
+}
+
+bool DerivationSession::save(const string &path, string &error) const {
+    ProductionFile::Header header;
+    string temporary = path + ".tmp";
+    FILE* f;
+    bool written;
+    ProductionFile::stamp(header, theEpoch, theLsystem.getSeed(),
+        theLsystem.getFingerprint(), theProduction.size());
+    f = fopen(temporary.c_str(), "wb");
+    written = (f != NULL) &&
+        (fwrite(&header, sizeof(header), 1, f) == 1) &&
+        (fwrite(theProduction.data(), 1, theProduction.size(), f) ==
+        theProduction.size()) && (fflush(f) == 0) &&
+        (fsync(fileno(f)) == 0);
+    if ((f != NULL) && (fclose(f) != 0)) {
+        written = false;
+    }
+    // Replace the previous checkpoint only once this one is on disk
+    if (!written || (rename(temporary.c_str(), path.c_str()) != 0)) {
+        remove(temporary.c_str());
+        error = "error writing file " + path;
+        return false;
+    }
+    return true;
+}
+
+bool DerivationSession::load(const string &path, string &error) {
+    ProductionFile saved;
+    if (!saved.open(path, error)) {
+        return false;
+    }
+    if ((saved.getHeader().seed != theLsystem.getSeed()) ||
+            (saved.getHeader().grammar != theLsystem.getFingerprint())) {
+        error = path + ": checkpoint of another grammar or seed";
+        return false;
+    }
+    theProduction.assign(saved.getSymbols(), saved.getHeader().length);
+    theEpoch = saved.getHeader().epoch;
+    return true;
+}
+
+const string& DerivationSession::getProduction() const {
+    return theProduction;
+}
+
+unsigned int DerivationSession::getEpoch() const {
+    return theEpoch;
+}
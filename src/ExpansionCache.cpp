@@ -0,0 +1,165 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ExpansionCache.cpp                                          |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "ExpansionCache.hpp"
+#include "Lsystem.hpp"
+#include <string>
+#include <vector>
+#include <climits>
+
+using namespace std;
+
+ExpansionCache::ExpansionCache(const Lsystem &lsys, const int maxDepth,
+        const size_t budget) : theLsystem(lsys) {
+    const char* successors[256];
+    size_t lengths[256];
+    unsigned long long total;
+    size_t position, used = 0;
+    unsigned int depth;
+    bool changed = true;
+    int symbol;
+    Entry entry;
+    theMaxDepth = maxDepth > 0 ? maxDepth : 0;
+    // Successors of the deterministic variables (any position will do)
+    for (symbol = 0; symbol < 256; symbol++) {
+        lengths[symbol] = 0;
+        theClosed[symbol] = lsys.getAlternatives(symbol) <= 1;
+        if (lsys.getAlternatives(symbol) == 1) {
+            lsys.expand(symbol, 0, 0, successors[symbol], lengths[symbol]);
+        }
+    }
+    // Greatest fixed point: closed if all the successor symbols are
+    while (changed) {
+        changed = false;
+        for (symbol = 0; symbol < 256; symbol++) {
+            for (position = 0; theClosed[symbol] &&
+                    (position < lengths[symbol]); position++) {
+                if (!theClosed[static_cast<unsigned char>(
+                        successors[symbol][position])]) {
+                    theClosed[symbol] = false;
+                    changed = true;
+                }
+            }
+        }
+    }
+    // Lengths, and the expansions that fit in the budget, shallowest
+    // first, as they are built from the expansions one level below
+    entry.length = 1;
+    entry.offset = 0;
+    entry.stored = false;
+    theEntries.assign((theMaxDepth + 1)*256, entry);
+    for (depth = 1; depth <= theMaxDepth; depth++) {
+        for (symbol = 0; symbol < 256; symbol++) {
+            Entry &current = theEntries[depth*256 + symbol];
+            if (theClosed[symbol] && (lsys.getAlternatives(symbol) == 1)) {
+                total = 0;
+                current.stored = true;
+                for (position = 0; position < lengths[symbol]; position++) {
+                    const Entry &below = theEntries[(depth - 1)*256 +
+                        static_cast<unsigned char>(
+                        successors[symbol][position])];
+                    total = below.length > ULLONG_MAX - total ?
+                        ULLONG_MAX : total + below.length;
+                    // Symbols one level below are stored or themselves
+                    current.stored = current.stored && (below.stored ||
+                        (depth == 1) || (lsys.getAlternatives(
+                        successors[symbol][position]) == 0));
+                }
+                current.length = total;
+                current.stored = current.stored && (total <= budget - used);
+                if (current.stored) {
+                    current.offset = used;
+                    used += total;
+                }
+            }
+        }
+    }
+    // The pool is reserved at once, so it may be appended to itself
+    thePool.reserve(used);
+    for (depth = 1; depth <= theMaxDepth; depth++) {
+        for (symbol = 0; symbol < 256; symbol++) {
+            if (theEntries[depth*256 + symbol].stored) {
+                for (position = 0; position < lengths[symbol]; position++) {
+                    const Entry &below = theEntries[(depth - 1)*256 +
+                        static_cast<unsigned char>(
+                        successors[symbol][position])];
+                    if (below.stored) {
+                        thePool.append(thePool, below.offset, below.length);
+                    } else {
+                        thePool += successors[symbol][position];
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool ExpansionCache::isClosed(const char symbol) const {
+    return theClosed[static_cast<unsigned char>(symbol)];
+}
+
+unsigned long long ExpansionCache::length(const char symbol,
+        const unsigned int depth) const {
+    return theEntries[depth*256 + static_cast<unsigned char>(symbol)].length;
+}
+
+bool ExpansionCache::lookup(const char symbol, const unsigned int depth,
+        const char* &expansion, size_t &length) const {
+    if ((depth > 0) && (depth <= theMaxDepth) &&
+            theEntries[depth*256 + static_cast<unsigned char>(symbol)].stored) {
+        const Entry &entry =
+            theEntries[depth*256 + static_cast<unsigned char>(symbol)];
+        expansion = thePool.data() + entry.offset;
+        length = entry.length;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool ExpansionCache::covers(const string &symbols,
+        const unsigned int depth) const {
+    bool covered[256];
+    bool all = (depth > 0) && (depth <= theMaxDepth);
+    size_t position;
+    int symbol;
+    for (symbol = 0; all && (symbol < 256); symbol++) {
+        covered[symbol] = theEntries[depth*256 + symbol].stored ||
+            (theLsystem.getAlternatives(symbol) == 0);
+    }
+    for (position = 0; all && (position < symbols.size()); position++) {
+        all = covered[static_cast<unsigned char>(symbols[position])];
+    }
+    return all;
+}
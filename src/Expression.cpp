@@ -0,0 +1,430 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Expression.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Expression.hpp"
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @brief Size of the evaluation stack.
+ */
+static const unsigned int MAX_DEPTH = 32;
+
+Expression::Expression() {
+    emit(CONSTANT);
+    theShort = true;
+}
+
+bool Expression::compile(const string &text, const vector<string> &formals,
+        string &error) {
+    size_t pc;
+    int depth, maxDepth;
+    theCode.clear();
+    theText = text;
+    thePosition = 0;
+    theFormals = formals;
+    theError.clear();
+    if (parseOr() && !accept("")) {
+        theError = "unexpected \"" + theText.substr(thePosition) + "\"";
+    }
+    // The stack depth is known from the bytecode alone
+    depth = 0;
+    maxDepth = 0;
+    for (pc = 0; pc < theCode.size(); pc++) {
+        if ((theCode[pc].opcode == CONSTANT) ||
+                (theCode[pc].opcode == SLOT)) {
+            depth++;
+        } else if ((theCode[pc].opcode != NEGATE) &&
+                (theCode[pc].opcode != NOT) &&
+                (theCode[pc].opcode < ADD_CONSTANT)) {
+            depth--;
+        }
+        maxDepth = depth > maxDepth ? depth : maxDepth;
+    }
+    if (theError.empty() && (maxDepth > static_cast<int>(MAX_DEPTH))) {
+        theError = "too deep";
+    }
+    theShort = (theCode.size() == 1) || ((theCode.size() == 2) &&
+        (theCode[1].opcode >= ADD_CONSTANT));
+    theText.clear();
+    theFormals.clear();
+    if (!theError.empty()) {
+        error = "expression \"" + text + "\": " + theError;
+        theCode.clear();
+        emit(CONSTANT);
+        theShort = true;
+        return false;
+    }
+    return true;
+}
+
+double Expression::evaluate(const double* slots) const {
+    const Instruction &first = theCode[0];
+    double top;
+    // A parameter or a constant, with at most an immediate operand, as
+    // most expressions are, is evaluated without the stack
+    if (!theShort) {
+        return run(slots);
+    }
+    top = first.opcode == SLOT ? slots[first.slot] : first.value;
+    if (theCode.size() > 1) {
+        switch (theCode[1].opcode) {
+            case ADD_CONSTANT:
+                top += theCode[1].value;
+                break;
+            case SUBTRACT_CONSTANT:
+                top -= theCode[1].value;
+                break;
+            case MULTIPLY_CONSTANT:
+                top *= theCode[1].value;
+                break;
+            case DIVIDE_CONSTANT:
+                top /= theCode[1].value;
+                break;
+            case LESS_CONSTANT:
+                top = top < theCode[1].value;
+                break;
+            case GREATER_CONSTANT:
+                top = top > theCode[1].value;
+                break;
+            case LESS_EQUAL_CONSTANT:
+                top = top <= theCode[1].value;
+                break;
+            case GREATER_EQUAL_CONSTANT:
+                top = top >= theCode[1].value;
+                break;
+            case EQUAL_CONSTANT:
+                top = top == theCode[1].value;
+                break;
+            default:
+                top = top != theCode[1].value;
+                break;
+        }
+    }
+    return top;
+}
+
+double Expression::run(const double* slots) const {
+    double stack[MAX_DEPTH];
+    const Instruction* pc = theCode.data();
+    const Instruction* end = pc + theCode.size();
+    // The top of the stack is kept in a register, the values below it
+    // in the array
+    double top = 0;
+    int below = 0;
+    for (; pc < end; pc++) {
+        switch (pc->opcode) {
+            case CONSTANT:
+                stack[below++] = top;
+                top = pc->value;
+                break;
+            case SLOT:
+                stack[below++] = top;
+                top = slots[pc->slot];
+                break;
+            case ADD:
+                top = stack[--below] + top;
+                break;
+            case SUBTRACT:
+                top = stack[--below] - top;
+                break;
+            case MULTIPLY:
+                top = stack[--below]*top;
+                break;
+            case DIVIDE:
+                top = stack[--below]/top;
+                break;
+            case POWER:
+                top = pow(stack[--below], top);
+                break;
+            case NEGATE:
+                top = -top;
+                break;
+            case LESS:
+                top = stack[--below] < top;
+                break;
+            case GREATER:
+                top = stack[--below] > top;
+                break;
+            case LESS_EQUAL:
+                top = stack[--below] <= top;
+                break;
+            case GREATER_EQUAL:
+                top = stack[--below] >= top;
+                break;
+            case EQUAL:
+                top = stack[--below] == top;
+                break;
+            case NOT_EQUAL:
+                top = stack[--below] != top;
+                break;
+            case AND:
+                top = (stack[--below] != 0) && (top != 0);
+                break;
+            case OR:
+                top = (stack[--below] != 0) || (top != 0);
+                break;
+            case NOT:
+                top = top == 0;
+                break;
+            case ADD_CONSTANT:
+                top += pc->value;
+                break;
+            case SUBTRACT_CONSTANT:
+                top -= pc->value;
+                break;
+            case MULTIPLY_CONSTANT:
+                top *= pc->value;
+                break;
+            case DIVIDE_CONSTANT:
+                top /= pc->value;
+                break;
+            case LESS_CONSTANT:
+                top = top < pc->value;
+                break;
+            case GREATER_CONSTANT:
+                top = top > pc->value;
+                break;
+            case LESS_EQUAL_CONSTANT:
+                top = top <= pc->value;
+                break;
+            case GREATER_EQUAL_CONSTANT:
+                top = top >= pc->value;
+                break;
+            case EQUAL_CONSTANT:
+                top = top == pc->value;
+                break;
+            case NOT_EQUAL_CONSTANT:
+                top = top != pc->value;
+                break;
+        }
+    }
+    return top;
+}
+
+bool Expression::parseOr() {
+    bool valid = parseAnd();
+    while (valid && accept("||")) {
+        valid = parseAnd();
+        emit(OR);
+    }
+    return valid;
+}
+
+bool Expression::parseAnd() {
+    bool valid = parseComparison();
+    while (valid && accept("&&")) {
+        valid = parseComparison();
+        emit(AND);
+    }
+    return valid;
+}
+
+bool Expression::parseComparison() {
+    bool valid = parseSum();
+    // The two-character operators are tried first
+    if (valid && accept("<=")) {
+        valid = parseSum();
+        emit(LESS_EQUAL);
+    } else if (valid && accept(">=")) {
+        valid = parseSum();
+        emit(GREATER_EQUAL);
+    } else if (valid && accept("==")) {
+        valid = parseSum();
+        emit(EQUAL);
+    } else if (valid && accept("!=")) {
+        valid = parseSum();
+        emit(NOT_EQUAL);
+    } else if (valid && accept("<")) {
+        valid = parseSum();
+        emit(LESS);
+    } else if (valid && accept(">")) {
+        valid = parseSum();
+        emit(GREATER);
+    }
+    return valid;
+}
+
+bool Expression::parseSum() {
+    bool valid = parseProduct();
+    bool more = true;
+    while (valid && more) {
+        if (accept("+")) {
+            valid = parseProduct();
+            emit(ADD);
+        } else if (accept("-")) {
+            valid = parseProduct();
+            emit(SUBTRACT);
+        } else {
+            more = false;
+        }
+    }
+    return valid;
+}
+
+bool Expression::parseProduct() {
+    bool valid = parseUnary();
+    bool more = true;
+    while (valid && more) {
+        if (accept("*")) {
+            valid = parseUnary();
+            emit(MULTIPLY);
+        } else if (accept("/")) {
+            valid = parseUnary();
+            emit(DIVIDE);
+        } else {
+            more = false;
+        }
+    }
+    return valid;
+}
+
+bool Expression::parseUnary() {
+    bool valid;
+    if (accept("-")) {
+        valid = parseUnary();
+        emit(NEGATE);
+    } else if (accept("!")) {
+        valid = parseUnary();
+        emit(NOT);
+    } else {
+        valid = parsePrimary();
+        // Right associative, and tighter than the negation on its left
+        if (valid && accept("^")) {
+            valid = parseUnary();
+            emit(POWER);
+        }
+    }
+    return valid;
+}
+
+bool Expression::parsePrimary() {
+    const char* begin;
+    char* end;
+    size_t length, slot;
+    double value;
+    accept("");
+    begin = theText.c_str() + thePosition;
+    if (accept("(")) {
+        if (!parseOr()) {
+            return false;
+        }
+        if (!accept(")")) {
+            theError = "missing \")\"";
+            return false;
+        }
+    } else if (isdigit(*begin) || (*begin == '.')) {
+        value = strtod(begin, &end);
+        thePosition += end - begin;
+        emit(CONSTANT, 0, value);
+    } else if (isalpha(*begin) || (*begin == '_')) {
+        length = 1;
+        while (isalnum(begin[length]) || (begin[length] == '_')) {
+            length++;
+        }
+        slot = 0;
+        while ((slot < theFormals.size()) &&
+                theFormals[slot].compare(0, string::npos, begin, length)) {
+            slot++;
+        }
+        if (slot == theFormals.size()) {
+            theError = "unknown parameter \"" + string(begin, length) +
+                "\"";
+            return false;
+        }
+        thePosition += length;
+        emit(SLOT, slot);
+    } else {
+        theError = *begin == '\0' ? "missing operand" :
+            "unexpected \"" + string(begin) + "\"";
+        return false;
+    }
+    return true;
+}
+
+bool Expression::accept(const char* op) {
+    size_t length = strlen(op);
+    while ((thePosition < theText.size()) &&
+            isspace(theText[thePosition])) {
+        thePosition++;
+    }
+    if (length == 0) {
+        return thePosition == theText.size();
+    }
+    if (theText.compare(thePosition, length, op)) {
+        return false;
+    }
+    thePosition += length;
+    return true;
+}
+
+void Expression::emit(const Opcode opcode, const unsigned int slot,
+        const double value) {
+    Instruction instruction;
+    size_t size = theCode.size(), first = size;
+    bool unary = (opcode == NEGATE) || (opcode == NOT);
+    bool binary = !unary && (opcode != CONSTANT) && (opcode != SLOT);
+    instruction.opcode = opcode;
+    instruction.slot = slot;
+    instruction.value = value;
+    if (unary && (size >= 1) && (theCode[size - 1].opcode == CONSTANT)) {
+        first = size - 1;
+    } else if (binary && (size >= 2) &&
+            (theCode[size - 1].opcode == CONSTANT) &&
+            (theCode[size - 2].opcode == CONSTANT)) {
+        first = size - 2;
+    }
+    theCode.push_back(instruction);
+    if (first < size) {
+        // Constant operands, folded into their value
+        Expression folded;
+        folded.theCode.assign(theCode.begin() + first, theCode.end());
+        theCode.resize(first + 1);
+        theCode[first].opcode = CONSTANT;
+        theCode[first].value = folded.run(NULL);
+    } else if (binary && ((opcode <= DIVIDE) || ((opcode >= LESS) &&
+            (opcode <= NOT_EQUAL))) && (size >= 1) &&
+            (theCode[size - 1].opcode == CONSTANT)) {
+        // Constant right operand, taken as an immediate
+        theCode.pop_back();
+        theCode[size - 1].opcode = static_cast<Opcode>(opcode <= DIVIDE ?
+            ADD_CONSTANT + (opcode - ADD) : LESS_CONSTANT + (opcode - LESS));
+    }
+}
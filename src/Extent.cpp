@@ -0,0 +1,414 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Extent.cpp                                                  |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Extent.hpp"
+#include "Derivation.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static const double DEG_TO_RAD = M_PI/180.0;
+
+/**
+ * @brief Size of the blocks of a streamed production.
+ */
+static const size_t BLOCK_SIZE = 4096;
+
+Extent::Extent(const Lsystem &lsys, const Turtle &ninja, const int numIter,
+        const double iniAng) : theLsystem(lsys), theTurtle(ninja) {
+    const string &axiom = lsys.getAxiom();
+    char block[BLOCK_SIZE];
+    size_t count, position;
+    int numHeadings = 0, index, symbol;
+    State state;
+    theMemoised = isMemoisable(lsys, ninja);
+    theNumIter = numIter;
+    theIniAng = iniAng;
+    theNumVariables = 0;
+    for (symbol = 0; symbol < 256; symbol++) {
+        theIndex[symbol] = -1;
+        if (lsys.getAlternatives(symbol) == 1) {
+            theIndex[symbol] = theNumVariables;
+            theNumVariables++;
+        }
+    }
+    if (ninja.theAngleStep > 0) {
+        numHeadings = static_cast<int>(floor(360/ninja.theAngleStep + 0.5));
+        for (index = 0; index < numHeadings; index++) {
+            theSin.push_back(sin((iniAng + index*ninja.theAngleStep)*
+                DEG_TO_RAD));
+            theCos.push_back(cos((iniAng + index*ninja.theAngleStep)*
+                DEG_TO_RAD));
+        }
+    }
+    state.x = 0;
+    state.y = 0;
+    state.index = 0;
+    state.heading = iniAng;
+    state.box.drawn = false;
+    if (theMemoised) {
+        Balance unknown;
+        Transform missing;
+        unknown.known = false;
+        missing.known = false;
+        theBalances.assign((numIter + 1)*256, unknown);
+        theTransforms.assign((numIter + 1)*theNumVariables*numHeadings,
+            missing);
+        for (position = 0; position < axiom.size(); position++) {
+            walk(axiom[position], numIter, state);
+        }
+    } else {
+        Derivation derivation(lsys, numIter);
+        while ((count = derivation.read(block, BLOCK_SIZE)) > 0) {
+            for (position = 0; position < count; position++) {
+                run(block[position], state);
+            }
+        }
+    }
+    theBox = state.box;
+}
+
+bool Extent::isEmpty() const {
+    return !theBox.drawn;
+}
+
+bool Extent::isMemoised() const {
+    return theMemoised;
+}
+
+double Extent::getMinX() const {
+    return theBox.minX;
+}
+
+double Extent::getMaxX() const {
+    return theBox.maxX;
+}
+
+double Extent::getMinY() const {
+    return theBox.minY;
+}
+
+double Extent::getMaxY() const {
+    return theBox.maxY;
+}
+
+void Extent::fit(const double size, double &scale, double &iniX,
+        double &iniY) const {
+    double span = max(theBox.maxX - theBox.minX,
+        theBox.maxY - theBox.minY);
+    scale = span > 0 ? span/size : 1;
+    iniX = -(theBox.minX + theBox.maxX)/2/scale;
+    iniY = -(theBox.minY + theBox.maxY)/2/scale;
+}
+
+void Extent::trace(const double tolerance, const double scale,
+        const double iniX, const double iniY, Segments &out) {
+    const string &axiom = theLsystem.getAxiom();
+    size_t position, first = out.size(), seg;
+    double* x0;
+    double* y0;
+    double* x1;
+    double* y1;
+    State state;
+    state.x = 0;
+    state.y = 0;
+    state.index = 0;
+    state.heading = theIniAng;
+    state.box.drawn = false;
+    for (position = 0; position < axiom.size(); position++) {
+        detail(axiom[position], theNumIter, tolerance*scale, state, out);
+    }
+    // From unit scale to the drawing
+    if (out.size() > first) {
+        x0 = out.dataX0();
+        y0 = out.dataY0();
+        x1 = out.dataX1();
+        y1 = out.dataY1();
+        for (seg = first; seg < out.size(); seg++) {
+            x0[seg] = iniX + x0[seg]/scale;
+            y0[seg] = iniY + y0[seg]/scale;
+            x1[seg] = iniX + x1[seg]/scale;
+            y1[seg] = iniY + y1[seg]/scale;
+        }
+    }
+}
+
+bool Extent::isMemoisable(const Lsystem &lsys, const Turtle &ninja) {
+    bool memoisable = ninja.theAngleStep > 0;
+    int symbol;
+    // Stochastic expansions depend on where they are
+    for (symbol = 0; symbol < 256; symbol++) {
+        memoisable = memoisable && (lsys.getAlternatives(symbol) <= 1);
+    }
+    return memoisable;
+}
+
+void Extent::walk(const char symbol, const int depth, State &state) {
+    const char* successor;
+    size_t length, position;
+    if ((depth == 0) || (theIndex[static_cast<unsigned char>(symbol)] < 0)) {
+        run(symbol, state);
+    } else {
+        const Balance &effect = balance(symbol, depth);
+        if ((effect.posPops == 0) && (effect.posPushes == 0) &&
+                (effect.angPops == 0) && (effect.angPushes == 0)) {
+            // The expansion leaves the stacks as it finds them
+            const Transform &move = transform(symbol, depth, state.index);
+            if (move.box.drawn) {
+                include(state.box, state.x + move.box.minX,
+                    state.y + move.box.minY);
+                include(state.box, state.x + move.box.maxX,
+                    state.y + move.box.maxY);
+            }
+            state.x += move.x;
+            state.y += move.y;
+            state.index = move.index;
+        } else {
+            theLsystem.getAlternative(symbol, 0, successor, length);
+            for (position = 0; position < length; position++) {
+                walk(successor[position], depth - 1, state);
+            }
+        }
+    }
+}
+
+void Extent::detail(const char symbol, const int depth,
+        const double limit, State &state, Segments &out) {
+    const char* successor;
+    size_t length, position;
+    bool expand = true;
+    if ((depth == 0) || (theIndex[static_cast<unsigned char>(symbol)] < 0)) {
+        run(symbol, state, &out);
+        expand = false;
+    } else {
+        const Balance &effect = balance(symbol, depth);
+        if ((effect.posPops == 0) && (effect.posPushes == 0) &&
+                (effect.angPops == 0) && (effect.angPushes == 0)) {
+            const Transform &move = transform(symbol, depth, state.index);
+            // Too small to tell apart from a straight line
+            if (!move.box.drawn || (max(move.box.maxX - move.box.minX,
+                    move.box.maxY - move.box.minY) <= limit)) {
+                if (move.box.drawn) {
+                    out.add(state.x, state.y, state.x + move.x,
+                        state.y + move.y);
+                }
+                state.x += move.x;
+                state.y += move.y;
+                state.index = move.index;
+                expand = false;
+            }
+        }
+    }
+    if (expand) {
+        theLsystem.getAlternative(symbol, 0, successor, length);
+        for (position = 0; position < length; position++) {
+            detail(successor[position], depth - 1, limit, state, out);
+        }
+    }
+}
+
+void Extent::run(const char symbol, State &state, Segments* out) const {
+    const Turtle::Program &program =
+        theTurtle.thePrograms[static_cast<unsigned char>(symbol)];
+    unsigned int pc, end = program.first + program.count;
+    int numHeadings = theSin.size();
+    double operand, x, y;
+    for (pc = program.first; pc < end; pc++) {
+        operand = theTurtle.theOperands[pc];
+        switch (theTurtle.theCode[pc]) {
+            case Turtle::DRAW_FORWARD:
+                include(state.box, state.x, state.y);
+                x = state.x;
+                y = state.y;
+                if (numHeadings > 0) {
+                    state.x += operand*theSin[state.index];
+                    state.y += operand*theCos[state.index];
+                } else {
+                    state.x += operand*sin(state.heading*DEG_TO_RAD);
+                    state.y += operand*cos(state.heading*DEG_TO_RAD);
+                }
+                include(state.box, state.x, state.y);
+                if (out != NULL) {
+                    out->add(x, y, state.x, state.y);
+                }
+                break;
+            case Turtle::TURN_LEFT:
+            case Turtle::TURN_RIGHT:
+                if (numHeadings > 0) {
+                    state.index = (state.index + theTurtle.theTurnSteps[pc])%
+                        numHeadings;
+                    if (state.index < 0) {
+                        state.index += numHeadings;
+                    }
+                } else {
+                    state.heading = fmod(state.heading +
+                        (theTurtle.theCode[pc] == Turtle::TURN_LEFT ?
+                        -operand : operand), 360.0);
+                }
+                break;
+            case Turtle::PUSH_POS:
+                state.posStack.push_back(state.x);
+                state.posStack.push_back(state.y);
+                break;
+            case Turtle::POP_POS:
+                // Unbalanced pops leave the turtle in place
+                if (state.posStack.size() >= 2) {
+                    state.y = state.posStack.back();
+                    state.posStack.pop_back();
+                    state.x = state.posStack.back();
+                    state.posStack.pop_back();
+                }
+                break;
+            case Turtle::PUSH_ANG:
+                state.angStack.push_back(numHeadings > 0 ? state.index :
+                    state.heading);
+                break;
+            case Turtle::POP_ANG:
+                if (!state.angStack.empty()) {
+                    if (numHeadings > 0) {
+                        state.index = static_cast<int>(
+                            state.angStack.back());
+                    } else {
+                        state.heading = state.angStack.back();
+                    }
+                    state.angStack.pop_back();
+                }
+                break;
+        }
+    }
+}
+
+const Extent::Balance& Extent::balance(const char symbol,
+        const int depth) {
+    Balance &effect = theBalances[depth*256 +
+        static_cast<unsigned char>(symbol)];
+    const char* successor;
+    size_t length, position;
+    unsigned int pc, end, taken;
+    if (!effect.known) {
+        effect.posPops = 0;
+        effect.posPushes = 0;
+        effect.angPops = 0;
+        effect.angPushes = 0;
+        if ((depth == 0) ||
+                (theIndex[static_cast<unsigned char>(symbol)] < 0)) {
+            const Turtle::Program &program =
+                theTurtle.thePrograms[static_cast<unsigned char>(symbol)];
+            end = program.first + program.count;
+            for (pc = program.first; pc < end; pc++) {
+                switch (theTurtle.theCode[pc]) {
+                    case Turtle::PUSH_POS:
+                        effect.posPushes++;
+                        break;
+                    case Turtle::POP_POS:
+                        if (effect.posPushes > 0) {
+                            effect.posPushes--;
+                        } else {
+                            effect.posPops++;
+                        }
+                        break;
+                    case Turtle::PUSH_ANG:
+                        effect.angPushes++;
+                        break;
+                    case Turtle::POP_ANG:
+                        if (effect.angPushes > 0) {
+                            effect.angPushes--;
+                        } else {
+                            effect.angPops++;
+                        }
+                        break;
+                }
+            }
+        } else {
+            // The successors one after the other, matching their pops
+            theLsystem.getAlternative(symbol, 0, successor, length);
+            for (position = 0; position < length; position++) {
+                const Balance &next = balance(successor[position],
+                    depth - 1);
+                taken = min(effect.posPushes, next.posPops);
+                effect.posPops += next.posPops - taken;
+                effect.posPushes += next.posPushes - taken;
+                taken = min(effect.angPushes, next.angPops);
+                effect.angPops += next.angPops - taken;
+                effect.angPushes += next.angPushes - taken;
+            }
+        }
+        effect.known = true;
+    }
+    return effect;
+}
+
+const Extent::Transform& Extent::transform(const char symbol,
+        const int depth, const int index) {
+    Transform &move = theTransforms[(depth*theNumVariables +
+        theIndex[static_cast<unsigned char>(symbol)])*theSin.size() +
+        index];
+    const char* successor;
+    size_t length, position;
+    State state;
+    if (!move.known) {
+        state.x = 0;
+        state.y = 0;
+        state.index = index;
+        state.heading = 0;
+        state.box.drawn = false;
+        theLsystem.getAlternative(symbol, 0, successor, length);
+        for (position = 0; position < length; position++) {
+            walk(successor[position], depth - 1, state);
+        }
+        move.x = state.x;
+        move.y = state.y;
+        move.index = state.index;
+        move.box = state.box;
+        move.known = true;
+    }
+    return move;
+}
+
+void Extent::include(Box &box, const double x, const double y) {
+    if (!box.drawn) {
+        box.minX = x;
+        box.maxX = x;
+        box.minY = y;
+        box.maxY = y;
+        box.drawn = true;
+    } else {
+        box.minX = min(box.minX, x);
+        box.maxX = max(box.maxX, x);
+        box.minY = min(box.minY, y);
+        box.maxY = max(box.maxY, y);
+    }
+}
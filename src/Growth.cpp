@@ -0,0 +1,244 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Growth.cpp                                                  |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Growth.hpp"
+#include "Lsystem.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Largest exact count, which stands for any overflowed one.
+ */
+static const Growth::Count COUNT_MAX = ~static_cast<Growth::Count>(0);
+
+/**
+ * @brief Saturated sum of counts.
+ */
+static Growth::Count addCounts(const Growth::Count a, const Growth::Count b,
+        bool &overflow) {
+    if (a > COUNT_MAX - b) {
+        overflow = true;
+        return COUNT_MAX;
+    } else {
+        return a + b;
+    }
+}
+
+/**
+ * @brief Saturated product of counts.
+ */
+static Growth::Count multiplyCounts(const Growth::Count a,
+        const Growth::Count b, bool &overflow) {
+    if ((a != 0) && (b > COUNT_MAX/a)) {
+        overflow = true;
+        return COUNT_MAX;
+    } else {
+        return a*b;
+    }
+}
+
+/**
+ * @brief Product of square matrices stored by rows, in place of the
+ *     first one.
+ */
+template <class T, class Add, class Multiply>
+static void multiplyMatrices(vector<T> &a, const vector<T> &b,
+        const size_t size, Add add, Multiply multiply) {
+    vector<T> product(size*size, T());
+    size_t row, col, inner;
+    for (row = 0; row < size; row++) {
+        for (inner = 0; inner < size; inner++) {
+            if (a[row*size + inner] != T()) {
+                for (col = 0; col < size; col++) {
+                    product[row*size + col] = add(product[row*size + col],
+                        multiply(a[row*size + inner], b[inner*size + col]));
+                }
+            }
+        }
+    }
+    a.swap(product);
+}
+
+/**
+ * @brief Power of a square matrix by repeated squaring.
+ */
+template <class T, class Add, class Multiply>
+static vector<T> powerMatrix(vector<T> base, const size_t size,
+        unsigned int exponent, const T one, Add add, Multiply multiply) {
+    vector<T> power(size*size, T());
+    size_t diag;
+    for (diag = 0; diag < size; diag++) {
+        power[diag*size + diag] = one;
+    }
+    while (exponent > 0) {
+        if (exponent & 1) {
+            multiplyMatrices(power, base, size, add, multiply);
+        }
+        exponent >>= 1;
+        if (exponent > 0) {
+            multiplyMatrices(base, base, size, add, multiply);
+        }
+    }
+    return power;
+}
+
+Growth::Growth(const Lsystem &lsys, const int numIter) {
+    const string &axiom = lsys.getAxiom();
+    const char* successor;
+    size_t length, position, size, row, col;
+    unsigned int alt;
+    double probability;
+    int symbol;
+    theDeterministic = true;
+    theOverflow = false;
+    for (symbol = 0; symbol < 256; symbol++) {
+        theIndex[symbol] = -1;
+    }
+    // Symbols reached from the axiom, through any alternative
+    for (position = 0; position < axiom.size(); position++) {
+        if (theIndex[static_cast<unsigned char>(axiom[position])] < 0) {
+            theIndex[static_cast<unsigned char>(axiom[position])] =
+                theSymbols.size();
+            theSymbols += axiom[position];
+        }
+    }
+    for (row = 0; row < theSymbols.size(); row++) {
+        theDeterministic = theDeterministic &&
+            (lsys.getAlternatives(theSymbols[row]) <= 1);
+        for (alt = 0; alt < lsys.getAlternatives(theSymbols[row]); alt++) {
+            lsys.getAlternative(theSymbols[row], alt, successor, length);
+            for (position = 0; position < length; position++) {
+                if (theIndex[static_cast<unsigned char>(
+                        successor[position])] < 0) {
+                    theIndex[static_cast<unsigned char>(
+                        successor[position])] = theSymbols.size();
+                    theSymbols += successor[position];
+                }
+            }
+        }
+    }
+    // Production matrices: exact if deterministic, and expected
+    size = theSymbols.size();
+    vector<Count> exact(size*size, 0);
+    vector<double> expected(size*size, 0);
+    for (row = 0; row < size; row++) {
+        if (lsys.getAlternatives(theSymbols[row]) == 0) {
+            // Constants rewrite to themselves
+            exact[row*size + row] = 1;
+            expected[row*size + row] = 1;
+        }
+        for (alt = 0; alt < lsys.getAlternatives(theSymbols[row]); alt++) {
+            probability = lsys.getAlternative(theSymbols[row], alt,
+                successor, length);
+            for (position = 0; position < length; position++) {
+                col = theIndex[static_cast<unsigned char>(
+                    successor[position])];
+                exact[row*size + col]++;
+                expected[row*size + col] += probability;
+            }
+        }
+    }
+    bool &overflow = theOverflow;
+    exact = powerMatrix(exact, size, numIter > 0 ? numIter : 0,
+        static_cast<Count>(1),
+        [&overflow](const Count a, const Count b) {
+            return addCounts(a, b, overflow);
+        },
+        [&overflow](const Count a, const Count b) {
+            return multiplyCounts(a, b, overflow);
+        });
+    expected = powerMatrix(expected, size, numIter > 0 ? numIter : 0, 1.0,
+        [](const double a, const double b) { return a + b; },
+        [](const double a, const double b) { return a*b; });
+    // Counts of the axiom times the power of the matrix
+    theCounts.assign(size, 0);
+    theExpected.assign(size, 0);
+    for (position = 0; position < axiom.size(); position++) {
+        row = theIndex[static_cast<unsigned char>(axiom[position])];
+        for (col = 0; col < size; col++) {
+            theCounts[col] = addCounts(theCounts[col],
+                exact[row*size + col], theOverflow);
+            theExpected[col] += expected[row*size + col];
+        }
+    }
+    theLength = 0;
+    for (col = 0; col < size; col++) {
+        theLength = addCounts(theLength, theCounts[col], theOverflow);
+    }
+}
+
+bool Growth::isExact() const {
+    return theDeterministic && !theOverflow;
+}
+
+Growth::Count Growth::getLength() const {
+    return theLength;
+}
+
+Growth::Count Growth::getCount(const char symbol) const {
+    int index = theIndex[static_cast<unsigned char>(symbol)];
+    return index < 0 ? 0 : theCounts[index];
+}
+
+double Growth::getExpectedLength() const {
+    double length = 0;
+    size_t index;
+    for (index = 0; index < theExpected.size(); index++) {
+        length += theExpected[index];
+    }
+    return length;
+}
+
+double Growth::getExpectedCount(const char symbol) const {
+    int index = theIndex[static_cast<unsigned char>(symbol)];
+    return index < 0 ? 0 : theExpected[index];
+}
+
+const string& Growth::getSymbols() const {
+    return theSymbols;
+}
+
+string Growth::format(const Count value) {
+    string digits;
+    Count rest = value;
+    do {
+        digits += static_cast<char>('0' + static_cast<int>(rest%10));
+        rest /= 10;
+    } while (rest > 0);
+    reverse(digits.begin(), digits.end());
+    return digits;
+}
@@ -33,53 +33,481 @@
 |________________________________________________________________________*/
 
 #include "Lsystem.hpp"
+#include "Random.hpp"
+#include "ExpansionCache.hpp"
+#include "Rope.hpp"
+#include "ProductionFile.hpp"
 #include <string>
 #include <set>
 #include <map>
-#include <cstdlib>
-#include <ctime>
+#include <vector>
+#include <memory_resource>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <thread>
 
 using namespace std;
 
+/**
+ * @brief Minimum number of symbols handed to each thread.
+ */
+static const size_t PARALLEL_GRAIN = 1 << 16;
+
+/**
+ * @brief Number of symbols of every window of an out-of-core derivation.
+ */
+static const size_t FILE_WINDOW = 1 << 24;
+
+/**
+ * @brief Bytes of the scratch of a generation kept on the stack: the
+ *     chunk bounds and offsets, and the threads.
+ */
+static const size_t SCRATCH_SIZE = 2048;
+
 Lsystem::Lsystem() {
+    compile();
 }
 
 Lsystem::Lsystem(const set<char> &vars, const string start,
-        const multimap<char, string> &rules) {
+        const multimap<char, pair<string, double> > &rules,
+        const unsigned long long seed) : theRandom(seed) {
     theVariables = vars;
     theStart = start;
     theRules = rules;
-    srand(time(NULL));
+    compile();
 }
 
-string Lsystem::produce(const int numIter) const {
-    string production = theStart;
-    string aux;
-    string::const_iterator prodIter;
-    multimap<char, string>::const_iterator ruleIter;
-    int numRules, chance, epoch;
-    for (epoch = 0; epoch < numIter; epoch++) {
-        aux.clear();
-        for (prodIter = production.begin(); prodIter < production.end();
-                prodIter++) {
-            numRules = theRules.count(*prodIter);
-            if (numRules > 0) {
-                chance = rand()%numRules;
-                for (ruleIter = theRules.lower_bound(*prodIter);
-                        ruleIter != theRules.upper_bound(*prodIter);
-                        ruleIter++) {
-                    if (!chance) {
-                        aux += (*ruleIter).second;
-                        break;
-                    }
-                    chance--;
+void Lsystem::compile() {
+    multimap<char, pair<string, double> >::const_iterator ruleIter;
+    Span span;
+    double total, cumulative;
+    unsigned int alt;
+    int symbol;
+    thePool.clear();
+    theSpans.clear();
+    for (symbol = 0; symbol < 256; symbol++) {
+        theTable[symbol].first = 0;
+        theTable[symbol].count = 0;
+        theTable[symbol].length = 1;
+    }
+    // The multimap keeps the alternatives of a symbol contiguous
+    for (ruleIter = theRules.begin(); ruleIter != theRules.end();
+            ruleIter++) {
+        symbol = static_cast<unsigned char>((*ruleIter).first);
+        if (theTable[symbol].count == 0) {
+            theTable[symbol].first = theSpans.size();
+            theTable[symbol].length = (*ruleIter).second.first.size();
+        }
+        theTable[symbol].count++;
+        span.offset = thePool.size();
+        span.length = (*ruleIter).second.first.size();
+        span.threshold = (*ruleIter).second.second;
+        thePool += (*ruleIter).second.first;
+        theSpans.push_back(span);
+    }
+    // Weights into cumulative probabilities (uniform if not positive)
+    for (symbol = 0; symbol < 256; symbol++) {
+        RuleEntry &entry = theTable[symbol];
+        total = 0;
+        for (alt = 0; alt < entry.count; alt++) {
+            if (theSpans[entry.first + alt].threshold > 0) {
+                total += theSpans[entry.first + alt].threshold;
+            }
+        }
+        cumulative = 0;
+        for (alt = 0; alt < entry.count; alt++) {
+            Span &alternative = theSpans[entry.first + alt];
+            if (total > 0) {
+                if (alternative.threshold > 0) {
+                    cumulative += alternative.threshold/total;
                 }
             } else {
-                aux += *prodIter;
+                cumulative += 1.0/entry.count;
             }
+            alternative.threshold = cumulative;
         }
-        production = aux;
+    }
+}
+
+const Lsystem::Span& Lsystem::choose(const RuleEntry &entry,
+        const Random &random, const unsigned int epoch,
+        const unsigned long long position) const {
+    unsigned int alt = 0;
+    double chance;
+    if (entry.count > 1) {
+        chance = random.uniform(epoch, position);
+        // The last alternative takes the rounding slack of the sum
+        while ((alt + 1 < entry.count) &&
+                (chance >= theSpans[entry.first + alt].threshold)) {
+            alt++;
+        }
+    }
+    return theSpans[entry.first + alt];
+}
+
+size_t Lsystem::measure(const char* begin, const char* end,
+        const Random &random, const unsigned int epoch,
+        const unsigned long long position) const {
+    size_t length = 0;
+    const char* symbol;
+    for (symbol = begin; symbol < end; symbol++) {
+        const RuleEntry &entry =
+            theTable[static_cast<unsigned char>(*symbol)];
+        if (entry.count > 1) {
+            length += choose(entry, random, epoch,
+                position + (symbol - begin)).length;
+        } else {
+            length += entry.length;
+        }
+    }
+    return length;
+}
+
+void Lsystem::rewrite(const char* begin, const char* end,
+        const Random &random, const unsigned int epoch,
+        const unsigned long long position, char* out) const {
+    const char* symbol;
+    for (symbol = begin; symbol < end; symbol++) {
+        const RuleEntry &entry =
+            theTable[static_cast<unsigned char>(*symbol)];
+        if (entry.count > 0) {
+            const Span &span = choose(entry, random, epoch,
+                position + (symbol - begin));
+            memcpy(out, thePool.data() + span.offset, span.length);
+            out += span.length;
+        } else {
+            *out = *symbol;
+            out++;
+        }
+    }
+}
+
+size_t Lsystem::measure(const char* begin, const char* end,
+        const ExpansionCache &cache, const unsigned int depth) const {
+    size_t length = 0;
+    const char* symbol;
+    for (symbol = begin; symbol < end; symbol++) {
+        length += cache.length(*symbol, depth);
+    }
+    return length;
+}
+
+void Lsystem::rewrite(const char* begin, const char* end,
+        const ExpansionCache &cache, const unsigned int depth,
+        char* out) const {
+    const char* symbol;
+    const char* expansion;
+    size_t length;
+    for (symbol = begin; symbol < end; symbol++) {
+        if (cache.lookup(*symbol, depth, expansion, length)) {
+            memcpy(out, expansion, length);
+            out += length;
+        } else {
+            *out = *symbol;
+            out++;
+        }
+    }
+}
+
+void Lsystem::rewriteParallel(const string &production,
+        const Random &random, const unsigned int epoch, string &next,
+        const unsigned int numThreads, const ExpansionCache *cache,
+        const unsigned int depth) const {
+    // The scratch of a generation is kept on the stack, unless there
+    // are many threads
+    char buffer[SCRATCH_SIZE];
+    pmr::monotonic_buffer_resource scratch(buffer, sizeof(buffer));
+    unsigned int numChunks, chunk;
+    pmr::vector<size_t> bounds(&scratch), offsets(&scratch);
+    pmr::vector<thread> workers(&scratch);
+    const char* in = production.data();
+    size_t length;
+    numChunks = production.size()/PARALLEL_GRAIN;
+    if (numChunks > numThreads) {
+        numChunks = numThreads;
+    }
+    if (numChunks < 1) {
+        numChunks = 1;
+    }
+    for (chunk = 0; chunk <= numChunks; chunk++) {
+        bounds.push_back(production.size()*chunk/numChunks);
+    }
+    // First pass: chunk lengths, then output offsets by prefix sum
+    offsets.resize(numChunks + 1, 0);
+    for (chunk = 1; chunk < numChunks; chunk++) {
+        workers.push_back(thread([&, chunk]() {
+            offsets[chunk + 1] = cache != NULL ? measure(in + bounds[chunk],
+                in + bounds[chunk + 1], *cache, depth) :
+                measure(in + bounds[chunk], in + bounds[chunk + 1], random,
+                epoch, bounds[chunk]);
+        }));
+    }
+    offsets[1] = cache != NULL ? measure(in + bounds[0], in + bounds[1],
+        *cache, depth) : measure(in + bounds[0], in + bounds[1], random,
+        epoch, 0);
+    for (chunk = 0; chunk < workers.size(); chunk++) {
+        workers[chunk].join();
+    }
+    workers.clear();
+    for (chunk = 1; chunk <= numChunks; chunk++) {
+        offsets[chunk] += offsets[chunk - 1];
+    }
+    length = offsets[numChunks];
+    // Release the stale generation before growing, so that only the
+    // current and the next generations are held at once
+    if (next.capacity() < length) {
+        string().swap(next);
+    }
+    next.resize(length);
+    // Second pass: concurrent writing into the shared output. Stochastic
+    // choices are keyed by position, so they are drawn again identically.
+    char* out = &next[0];
+    for (chunk = 1; chunk < numChunks; chunk++) {
+        workers.push_back(thread([&, chunk]() {
+            if (cache != NULL) {
+                rewrite(in + bounds[chunk], in + bounds[chunk + 1], *cache,
+                    depth, out + offsets[chunk]);
+            } else {
+                rewrite(in + bounds[chunk], in + bounds[chunk + 1], random,
+                    epoch, bounds[chunk], out + offsets[chunk]);
+            }
+        }));
+    }
+    if (cache != NULL) {
+        rewrite(in + bounds[0], in + bounds[1], *cache, depth, out);
+    } else {
+        rewrite(in + bounds[0], in + bounds[1], random, epoch, 0, out);
+    }
+    for (chunk = 0; chunk < workers.size(); chunk++) {
+        workers[chunk].join();
+    }
+}
+
+string Lsystem::produce(const int numIter,
+        const unsigned int numThreads, const ExpansionCache *cache) const {
+    return produce(numIter, theRandom, numThreads, cache);
+}
+
+string Lsystem::produce(const int numIter, const Random &random,
+        const unsigned int numThreads, const ExpansionCache *cache) const {
+    string production = theStart;
+    string next;
+    int epoch = 0;
+    while (epoch < numIter) {
+        // Jump to the end once the cache holds all the subtrees left
+        if ((cache != NULL) && cache->covers(production, numIter - epoch)) {
+            rewriteParallel(production, random, epoch, next, numThreads,
+                cache, numIter - epoch);
+            epoch = numIter;
+        } else {
+            rewriteParallel(production, random, epoch, next, numThreads);
+            epoch++;
+        }
+        production.swap(next);
     }
     return production;
 }
 
+bool Lsystem::produceFile(const int numIter, const string &path,
+        string &error) const {
+    ProductionFile files[2];
+    ProductionFile::Header header;
+    vector<size_t> offsets;
+    const string names[2] = {path + ".gen0", path + ".gen1"};
+    unsigned long long fingerprint = getFingerprint();
+    size_t size, window, numWindows, begin, end;
+    int epoch, current;
+    bool written;
+    // Generation zero, the axiom
+    ProductionFile::stamp(header, 0, getSeed(), fingerprint,
+        theStart.size());
+    written = files[0].create(names[0], header, error);
+    if (written) {
+        memcpy(files[0].getSymbols(), theStart.data(), theStart.size());
+    }
+    for (epoch = 0; written && (epoch < numIter); epoch++) {
+        current = epoch%2;
+        ProductionFile &in = files[current];
+        ProductionFile &out = files[1 - current];
+        size = in.getHeader().length;
+        numWindows = (size + FILE_WINDOW - 1)/FILE_WINDOW;
+        // First pass: window lengths, then output offsets
+        offsets.assign(numWindows + 1, 0);
+        for (window = 0; window < numWindows; window++) {
+            begin = window*FILE_WINDOW;
+            end = min(size, begin + FILE_WINDOW);
+            offsets[window + 1] = offsets[window] + measure(
+                in.getSymbols() + begin, in.getSymbols() + end, theRandom,
+                epoch, begin);
+        }
+        ProductionFile::stamp(header, epoch + 1, getSeed(), fingerprint,
+            offsets[numWindows]);
+        written = out.create(names[1 - current], header, error);
+        // Second pass: rewrite, dropping the pages done with
+        for (window = 0; written && (window < numWindows); window++) {
+            begin = window*FILE_WINDOW;
+            end = min(size, begin + FILE_WINDOW);
+            rewrite(in.getSymbols() + begin, in.getSymbols() + end,
+                theRandom, epoch, begin, out.getSymbols() + offsets[window]);
+            in.release(begin, end - begin);
+            out.release(offsets[window],
+                offsets[window + 1] - offsets[window]);
+        }
+        in.close();
+        remove(names[current].c_str());
+    }
+    files[numIter%2].close();
+    if (written && (rename(names[numIter%2].c_str(), path.c_str()) != 0)) {
+        error = "error writing file " + path;
+        written = false;
+    }
+    if (!written) {
+        remove(names[0].c_str());
+        remove(names[1].c_str());
+    }
+    return written;
+}
+
+Rope Lsystem::produceRope(const int numIter,
+        pmr::memory_resource *memory) const {
+    unsigned int depth = numIter > 0 ? numIter : 0;
+    ExpansionCache closure(*this, depth, 0);
+    Nodes memo((depth + 1)*256, 0, memory);
+    Counters counters(depth + 1, 0, memory);
+    Nodes parts(theStart.size(), 0, memory);
+    size_t position;
+    Rope rope;
+    for (position = 0; position < theStart.size(); position++) {
+        parts[position] = grow(rope, closure, memo, counters,
+            theStart[position], 0, depth);
+    }
+    rope.setRoot(rope.concatenate(parts.data(), parts.size()));
+    return rope;
+}
+
+size_t Lsystem::growClosed(Rope &rope, Nodes &memo, const char symbol,
+        const unsigned int depth) const {
+    const RuleEntry &entry = theTable[static_cast<unsigned char>(symbol)];
+    size_t &node = memo[depth*256 + static_cast<unsigned char>(symbol)];
+    size_t position;
+    if ((depth == 0) || (entry.count == 0)) {
+        return rope.symbol(symbol);
+    } else {
+        // Single symbols are nodes below 256, so zero means not built
+        if (node == 0) {
+            const Span &span = theSpans[entry.first];
+            Nodes parts(span.length, 0, memo.get_allocator());
+            for (position = 0; position < span.length; position++) {
+                parts[position] = growClosed(rope, memo,
+                    thePool[span.offset + position], depth - 1);
+            }
+            node = rope.concatenate(parts.data(), parts.size());
+        }
+        return node;
+    }
+}
+
+size_t Lsystem::grow(Rope &rope, const ExpansionCache &closure,
+        Nodes &memo, Counters &counters, const char symbol,
+        const unsigned int epoch, const unsigned int numIter) const {
+    const RuleEntry &entry = theTable[static_cast<unsigned char>(symbol)];
+    unsigned int later;
+    size_t position;
+    if (closure.isClosed(symbol)) {
+        // Shared subtree: only its lengths move the counters
+        for (later = epoch; later <= numIter; later++) {
+            counters[later] += closure.length(symbol, later - epoch);
+        }
+        return growClosed(rope, memo, symbol, numIter - epoch);
+    } else if (epoch == numIter) {
+        counters[epoch]++;
+        return rope.symbol(symbol);
+    } else {
+        const Span &span = choose(entry, theRandom, epoch,
+            counters[epoch]);
+        Nodes parts(span.length, 0, memo.get_allocator());
+        counters[epoch]++;
+        for (position = 0; position < span.length; position++) {
+            parts[position] = grow(rope, closure, memo, counters,
+                thePool[span.offset + position], epoch + 1, numIter);
+        }
+        return rope.concatenate(parts.data(), parts.size());
+    }
+}
+
+const string& Lsystem::getAxiom() const {
+    return theStart;
+}
+
+unsigned long long Lsystem::getSeed() const {
+    return theRandom.getSeed();
+}
+
+unsigned long long Lsystem::getFingerprint() const {
+    unsigned long long hash = 14695981039346656037ULL;
+    unsigned int symbol, alt;
+    size_t index;
+    // FNV-1a of the axiom and every successor with its threshold
+    string bytes = theStart;
+    for (symbol = 0; symbol < 256; symbol++) {
+        const RuleEntry &entry = theTable[symbol];
+        bytes.append(reinterpret_cast<const char*>(&entry.count),
+            sizeof(entry.count));
+        for (alt = 0; alt < entry.count; alt++) {
+            const Span &span = theSpans[entry.first + alt];
+            bytes.append(reinterpret_cast<const char*>(&span.length),
+                sizeof(span.length));
+            bytes.append(thePool, span.offset, span.length);
+            bytes.append(reinterpret_cast<const char*>(&span.threshold),
+                sizeof(span.threshold));
+        }
+    }
+    for (index = 0; index < bytes.size(); index++) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[index]))*
+            1099511628211ULL;
+    }
+    return hash;
+}
+
+bool Lsystem::expand(const char symbol, const unsigned int epoch,
+        const unsigned long long position, const char* &successor,
+        size_t &length) const {
+    const RuleEntry &entry = theTable[static_cast<unsigned char>(symbol)];
+    if (entry.count > 0) {
+        const Span &span = choose(entry, theRandom, epoch, position);
+        successor = thePool.data() + span.offset;
+        length = span.length;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool Lsystem::isStochastic() const {
+    unsigned int symbol;
+    bool stochastic = false;
+    for (symbol = 0; (symbol < 256) && !stochastic; symbol++) {
+        stochastic = theTable[symbol].count > 1;
+    }
+    return stochastic;
+}
+
+unsigned int Lsystem::getAlternatives(const char symbol) const {
+    return theTable[static_cast<unsigned char>(symbol)].count;
+}
+
+double Lsystem::getAlternative(const char symbol, const unsigned int alt,
+        const char* &successor, size_t &length) const {
+    const RuleEntry &entry = theTable[static_cast<unsigned char>(symbol)];
+    const Span &span = theSpans[entry.first + alt];
+    successor = thePool.data() + span.offset;
+    length = span.length;
+    // The last alternative takes the rounding slack, as in choose()
+    if (alt + 1 == entry.count) {
+        return 1 - (alt > 0 ? theSpans[entry.first + alt - 1].threshold : 0);
+    } else {
+        return span.threshold -
+            (alt > 0 ? theSpans[entry.first + alt - 1].threshold : 0);
+    }
+}
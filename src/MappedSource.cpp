@@ -0,0 +1,62 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : MappedSource.cpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "MappedSource.hpp"
+#include "ProductionFile.hpp"
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Number of symbols read between releases of their pages.
+ */
+static const size_t RELEASE_SIZE = 1 << 24;
+
+MappedSource::MappedSource(ProductionFile &prod) : theProd(prod) {
+    theOffset = 0;
+    theReleased = 0;
+}
+
+size_t MappedSource::read(char* buffer, const size_t size) {
+    size_t count = min(size, static_cast<size_t>(
+        theProd.getHeader().length) - theOffset);
+    memcpy(buffer, theProd.getSymbols() + theOffset, count);
+    theOffset += count;
+    if (theOffset - theReleased >= RELEASE_SIZE) {
+        theProd.release(theReleased, theOffset - theReleased);
+        theReleased = theOffset;
+    }
+    return count;
+}
@@ -0,0 +1,692 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ParametricLsystem.cpp                                       |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "ParametricLsystem.hpp"
+#include "Expression.hpp"
+#include <string>
+#include <set>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdint>
+#include <sys/mman.h>
+
+using namespace std;
+
+/**
+ * @brief Position of a token out of any parenthesis.
+ */
+static size_t findOutside(const string &text, const char* token) {
+    size_t position, found = string::npos;
+    int depth = 0;
+    for (position = 0; (position < text.size()) && (found == string::npos);
+            position++) {
+        if (text[position] == '(') {
+            depth++;
+        } else if (text[position] == ')') {
+            depth--;
+        } else if ((depth == 0) && !text.compare(position,
+                char_traits<char>::length(token), token)) {
+            found = position;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Size of a huge page.
+ */
+static const uintptr_t HUGE_PAGE = 1 << 21;
+
+/**
+ * @brief Back a large generation with huge pages, if the system lends
+ *     them, as it is written once from end to end and would otherwise
+ *     take a page fault every 4 KB.
+ */
+static void adviseHuge(const void* memory, const size_t size) {
+#ifdef MADV_HUGEPAGE
+    uintptr_t first = (reinterpret_cast<uintptr_t>(memory) + HUGE_PAGE -
+        1) & ~(HUGE_PAGE - 1);
+    uintptr_t last = (reinterpret_cast<uintptr_t>(memory) + size) &
+        ~(HUGE_PAGE - 1);
+    if (last > first) {
+        madvise(reinterpret_cast<void*>(first), last - first,
+            MADV_HUGEPAGE);
+    }
+#endif
+}
+
+/**
+ * @brief Text without the surrounding blanks.
+ */
+static string trim(const string &text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    size_t last = text.find_last_not_of(" \t\r");
+    return first == string::npos ? string() :
+        text.substr(first, last - first + 1);
+}
+
+/**
+ * @brief True if the text is the name of a parameter.
+ */
+static bool isName(const string &text) {
+    size_t position;
+    bool valid = !text.empty() && (isalpha(text[0]) || (text[0] == '_'));
+    for (position = 1; valid && (position < text.size()); position++) {
+        valid = isalnum(text[position]) || (text[position] == '_');
+    }
+    return valid;
+}
+
+ParametricLsystem::ParametricLsystem() {
+    unsigned int symbol;
+    for (symbol = 0; symbol < 256; symbol++) {
+        theTable[symbol].first = 0;
+        theTable[symbol].count = 0;
+        theTable[symbol].fixed = false;
+        theTable[symbol].direct = false;
+        theTable[symbol].offset = 0;
+        theTable[symbol].length = 0;
+        theTable[symbol].numParams = 0;
+        theTable[symbol].nextLength = 0;
+        theTable[symbol].nextParams = 0;
+        theArity[symbol] = 0;
+        theIgnored[symbol] = false;
+        theBranch[symbol] = 0;
+    }
+    theNumSlots = 0;
+    theNumValues = 0;
+}
+
+bool ParametricLsystem::compile(const string &axiom,
+        const multimap<char, pair<string, double> > &rules,
+        const vector<string> &moduleRules, const set<char> &ignored,
+        const set<char> &opening, const set<char> &closing,
+        string &error) {
+    multimap<char, pair<string, double> >::const_iterator rule;
+    set<char>::const_iterator symbol;
+    vector<Rule> compiled;
+    vector<char> predecessors;
+    vector<vector<string> > args;
+    vector<string> formals;
+    string predecessor, successor;
+    size_t index, module, arg;
+    unsigned int entry, last;
+    bool valid = true;
+    Rule plain;
+    for (entry = 0; entry < 256; entry++) {
+        theArity[entry] = -1;
+        theIgnored[entry] = false;
+        theBranch[entry] = 0;
+    }
+    for (symbol = ignored.begin(); symbol != ignored.end(); symbol++) {
+        theIgnored[static_cast<unsigned char>(*symbol)] = true;
+    }
+    // A branch is never ignored, but skipped whole
+    for (symbol = opening.begin(); symbol != opening.end(); symbol++) {
+        theIgnored[static_cast<unsigned char>(*symbol)] = false;
+        theBranch[static_cast<unsigned char>(*symbol)] = 1;
+    }
+    for (symbol = closing.begin(); symbol != closing.end(); symbol++) {
+        theIgnored[static_cast<unsigned char>(*symbol)] = false;
+        theBranch[static_cast<unsigned char>(*symbol)] = -1;
+    }
+    theNumSlots = 0;
+    theNumValues = 0;
+    // Axiom, whose parameters are constant expressions
+    theAxiom.params.clear();
+    valid = split(axiom, theAxiom.symbols, args, error);
+    for (module = 0; valid && (module < args.size()); module++) {
+        for (arg = 0; valid && (arg < args[module].size()); arg++) {
+            Expression constant;
+            valid = constant.compile(args[module][arg], formals, error);
+            theAxiom.params.push_back(constant.evaluate(NULL));
+        }
+    }
+    if (!valid) {
+        error = "start: " + error;
+    }
+    // Rules in the order of the definition, the context-free ones last
+    for (index = 0; valid && (index < moduleRules.size()); index++) {
+        compiled.push_back(Rule());
+        predecessors.push_back(0);
+        valid = compileRule(moduleRules[index], compiled.back(),
+            predecessors.back(), error);
+        if (!valid) {
+            error = "rule \"" + trim(moduleRules[index]) + "\": " + error;
+        }
+    }
+    for (rule = rules.begin(); valid && (rule != rules.end()); rule++) {
+        plain.contextual = false;
+        plain.predecessorSlot = 0;
+        plain.conditional = false;
+        valid = rules.count(rule->first) == 1;
+        if (!valid) {
+            error = string("rules of \"") + rule->first + "\": stochastic " +
+                "rules cannot be mixed with rule lines";
+        } else {
+            valid = split(string(1, rule->first), predecessor, args,
+                error) && split(rule->second.first, plain.successor, args,
+                error);
+        }
+        if (valid) {
+            compiled.push_back(plain);
+            predecessors.push_back(rule->first);
+        }
+    }
+    // Candidates grouped by predecessor, in order
+    theRules.clear();
+    for (entry = 0; entry < 256; entry++) {
+        theTable[entry].first = theRules.size();
+        for (index = 0; index < compiled.size(); index++) {
+            if (static_cast<unsigned char>(predecessors[index]) == entry) {
+                theRules.push_back(compiled[index]);
+            }
+        }
+        theTable[entry].count = theRules.size() - theTable[entry].first;
+        if (theArity[entry] < 0) {
+            theArity[entry] = 0;
+        }
+    }
+    // Fixed replacements, copied without matching
+    thePool.clear();
+    for (entry = 0; entry < 256; entry++) {
+        RuleEntry &fixed = theTable[entry];
+        fixed.fixed = theArity[entry] == 0;
+        if (fixed.fixed && (fixed.count > 0)) {
+            const Rule &first = theRules[fixed.first];
+            fixed.fixed = !first.contextual && !first.conditional &&
+                first.arguments.empty();
+        }
+        fixed.offset = thePool.size();
+        if (fixed.fixed) {
+            thePool += fixed.count > 0 ? theRules[fixed.first].successor :
+                string(1, static_cast<char>(entry));
+        }
+        fixed.length = thePool.size() - fixed.offset;
+        fixed.numParams = 0;
+        fixed.direct = !fixed.fixed && ((fixed.count == 0) ||
+            (!theRules[fixed.first].contextual &&
+            !theRules[fixed.first].conditional));
+        // The longest successor of the rules that may apply, or the
+        // module itself if it may be copied
+        if (!fixed.fixed && (!fixed.direct || (fixed.count == 0))) {
+            fixed.length = 1;
+            fixed.numParams = theArity[entry];
+        }
+        last = fixed.first + (fixed.direct ? min(fixed.count, 1u) :
+            fixed.count);
+        for (index = fixed.first; !fixed.fixed && (index < last);
+                index++) {
+            fixed.length = max(fixed.length,
+                theRules[index].successor.size());
+            fixed.numParams = max(fixed.numParams,
+                theRules[index].arguments.size());
+        }
+    }
+    // Bounds of the generation after, from the symbols that replace
+    for (index = 0; index < theRules.size(); index++) {
+        measure(theRules[index].successor, theRules[index].nextLength,
+            theRules[index].nextParams);
+    }
+    for (entry = 0; entry < 256; entry++) {
+        RuleEntry &next = theTable[entry];
+        if (next.fixed) {
+            successor = thePool.substr(next.offset, next.length);
+        } else if (next.direct && (next.count > 0)) {
+            successor = theRules[next.first].successor;
+        } else {
+            successor = string(1, static_cast<char>(entry));
+        }
+        measure(successor, next.nextLength, next.nextParams);
+    }
+    return valid;
+}
+
+ParametricLsystem::Modules ParametricLsystem::produce(
+        const int numIter) const {
+    Modules production = theAxiom;
+    Modules next;
+    size_t length, numParams;
+    int epoch;
+    measure(theAxiom.symbols, length, numParams);
+    for (epoch = 0; epoch < numIter; epoch++) {
+        rewrite(production, next, length, numParams);
+        production.symbols.swap(next.symbols);
+        production.params.swap(next.params);
+    }
+    return production;
+}
+
+string ParametricLsystem::format(const Modules &modules) const {
+    ostringstream text;
+    size_t index, offset = 0;
+    int arg, count;
+    for (index = 0; index < modules.symbols.size(); index++) {
+        text << modules.symbols[index];
+        count = theArity[static_cast<unsigned char>(modules.symbols[index])];
+        for (arg = 0; arg < count; arg++) {
+            text << (arg == 0 ? "(" : ",") << modules.params[offset + arg];
+        }
+        if (count > 0) {
+            text << ")";
+        }
+        offset += count;
+    }
+    return text.str();
+}
+
+unsigned int ParametricLsystem::getArity(const char symbol) const {
+    return theArity[static_cast<unsigned char>(symbol)];
+}
+
+bool ParametricLsystem::compileRule(const string &text, Rule &rule,
+        char &predecessor, string &error) {
+    string head, condition, left, right, symbols;
+    vector<vector<string> > leftArgs, args, rightArgs, successorArgs;
+    vector<string> formals, texts;
+    size_t arrow, colon, less, greater, module, arg, unique;
+    bool valid = true;
+    arrow = findOutside(text, "->");
+    if (arrow == string::npos) {
+        error = "missing \"->\"";
+        return false;
+    }
+    // Head "left < predecessor > right : condition"
+    head = text.substr(0, arrow);
+    colon = findOutside(head, ":");
+    if (colon != string::npos) {
+        condition = trim(head.substr(colon + 1));
+        head = head.substr(0, colon);
+    }
+    less = findOutside(head, "<");
+    if (less != string::npos) {
+        left = head.substr(0, less);
+        head = head.substr(less + 1);
+    }
+    greater = findOutside(head, ">");
+    if (greater != string::npos) {
+        right = head.substr(greater + 1);
+        head = head.substr(0, greater);
+    }
+    valid = split(left, rule.left, leftArgs, error) &&
+        split(head, symbols, args, error) &&
+        split(right, rule.right, rightArgs, error);
+    if (valid && (symbols.size() != 1)) {
+        error = "expected a single predecessor module";
+        valid = false;
+    }
+    // The contexts skip over the branches, so they cannot name them
+    for (module = 0; valid && (module < rule.left.size() +
+            rule.right.size()); module++) {
+        valid = theBranch[static_cast<unsigned char>((rule.left +
+            rule.right)[module])] == 0;
+        if (!valid) {
+            error = "a context cannot hold a branch symbol";
+        }
+    }
+    // The formal parameters name the slots, from left to right
+    for (module = 0; valid && (module < leftArgs.size()); module++) {
+        formals.insert(formals.end(), leftArgs[module].begin(),
+            leftArgs[module].end());
+    }
+    if (valid) {
+        predecessor = symbols[0];
+        rule.predecessorSlot = formals.size();
+        formals.insert(formals.end(), args[0].begin(), args[0].end());
+    }
+    for (module = 0; valid && (module < rightArgs.size()); module++) {
+        formals.insert(formals.end(), rightArgs[module].begin(),
+            rightArgs[module].end());
+    }
+    for (arg = 0; valid && (arg < formals.size()); arg++) {
+        valid = isName(formals[arg]);
+        if (!valid) {
+            error = "\"" + formals[arg] + "\" is not a parameter name";
+        }
+    }
+    rule.conditional = valid && !condition.empty();
+    if (rule.conditional) {
+        valid = rule.condition.compile(condition, formals, error);
+    }
+    // Successor, whose parameters are expressions of the formal ones
+    if (valid) {
+        valid = split(text.substr(arrow + 2), rule.successor,
+            successorArgs, error);
+    }
+    // The same expression is compiled, and evaluated, once
+    rule.expressions.clear();
+    rule.arguments.clear();
+    for (module = 0; valid && (module < successorArgs.size()); module++) {
+        for (arg = 0; valid && (arg < successorArgs[module].size());
+                arg++) {
+            texts.push_back(trim(successorArgs[module][arg]));
+            unique = find(texts.begin(), texts.end(), texts.back()) -
+                texts.begin();
+            if (unique == texts.size() - 1) {
+                rule.expressions.push_back(Expression());
+                valid = rule.expressions.back().compile(texts.back(),
+                    formals, error);
+            } else {
+                texts.pop_back();
+            }
+            rule.arguments.push_back(unique);
+        }
+    }
+    rule.contextual = !rule.left.empty() || !rule.right.empty();
+    if (valid && (formals.size() > theNumSlots)) {
+        theNumSlots = formals.size();
+    }
+    if (valid && (rule.expressions.size() > theNumValues)) {
+        theNumValues = rule.expressions.size();
+    }
+    return valid;
+}
+
+bool ParametricLsystem::split(const string &text, string &symbols,
+        vector<vector<string> > &args, string &error) {
+    size_t position = 0, start, count;
+    unsigned char symbol;
+    int depth;
+    bool valid = true;
+    symbols.clear();
+    args.clear();
+    while (valid && (position < text.size())) {
+        symbol = text[position];
+        if (isspace(symbol)) {
+            position++;
+        } else if ((symbol == '(') || (symbol == ')') || (symbol == ',')) {
+            error = "misplaced \"" + string(1, symbol) + "\"";
+            valid = false;
+        } else {
+            symbols += symbol;
+            args.push_back(vector<string>());
+            position++;
+            // Parameters, split at the commas of the outer parenthesis
+            if ((position < text.size()) && (text[position] == '(')) {
+                depth = 1;
+                position++;
+                start = position;
+                while ((position < text.size()) && (depth > 0)) {
+                    if (text[position] == '(') {
+                        depth++;
+                    } else if (text[position] == ')') {
+                        depth--;
+                    }
+                    if ((depth == 0) || ((depth == 1) &&
+                            (text[position] == ','))) {
+                        args.back().push_back(text.substr(start,
+                            position - start));
+                        start = position + 1;
+                    }
+                    position++;
+                }
+                if (depth > 0) {
+                    error = "missing \")\"";
+                    valid = false;
+                }
+            }
+            count = args.back().size();
+            if (valid && (theArity[symbol] >= 0) &&
+                    (theArity[symbol] != static_cast<int>(count))) {
+                ostringstream message;
+                message << "symbol \"" << symbol << "\" takes " <<
+                    theArity[symbol] << " parameters";
+                error = message.str();
+                valid = false;
+            }
+            theArity[symbol] = count;
+        }
+    }
+    return valid;
+}
+
+inline bool ParametricLsystem::match(const Modules &in,
+        const size_t index, const size_t offset, const Rule &rule,
+        double* slots) const {
+    const unsigned char* symbols =
+        reinterpret_cast<const unsigned char*>(in.symbols.data());
+    const unsigned char* left =
+        reinterpret_cast<const unsigned char*>(rule.left.data());
+    const unsigned char* right =
+        reinterpret_cast<const unsigned char*>(rule.right.data());
+    const double* params = in.params.data();
+    const size_t size = in.symbols.size();
+    size_t position, at, slot, count, context, skip;
+    int depth;
+    count = theArity[symbols[index]];
+    copy(params + offset, params + offset + count,
+        slots + rule.predecessorSlot);
+    // Left context, backwards from the predecessor
+    position = index;
+    at = offset;
+    slot = rule.predecessorSlot;
+    for (context = rule.left.size(); context > 0; context--) {
+        do {
+            if (position == 0) {
+                return false;
+            }
+            position--;
+            at -= theArity[symbols[position]];
+            // A single ignored symbol, e.g., a turn between two modules,
+            // is skipped without branching
+            skip = theIgnored[symbols[position]] & (position > 0);
+            position -= skip;
+            at -= skip*theArity[symbols[position]];
+            // A branch is skipped whole, back to its opening symbol, and
+            // the opening symbol of the branch of the predecessor leads
+            // on to its parent
+            depth = theBranch[symbols[position]] < 0 ? 1 : 0;
+            while (depth > 0) {
+                if (position == 0) {
+                    return false;
+                }
+                position--;
+                at -= theArity[symbols[position]];
+                depth -= theBranch[symbols[position]];
+            }
+        } while (theIgnored[symbols[position]] ||
+            (theBranch[symbols[position]] != 0));
+        if (symbols[position] != left[context - 1]) {
+            return false;
+        }
+        count = theArity[symbols[position]];
+        slot -= count;
+        copy(params + at, params + at + count, slots + slot);
+    }
+    // Right context, forwards from the predecessor
+    position = index;
+    at = offset;
+    slot = rule.predecessorSlot + theArity[symbols[index]];
+    for (context = 0; context < rule.right.size(); context++) {
+        do {
+            if (position + 1 >= size) {
+                return false;
+            }
+            at += theArity[symbols[position]];
+            position++;
+            skip = theIgnored[symbols[position]] & (position + 1 < size);
+            at += skip*theArity[symbols[position]];
+            position += skip;
+            // A branch is skipped whole, up to its closing symbol, and
+            // the closing symbol of the branch of the predecessor ends it
+            if (theBranch[symbols[position]] < 0) {
+                return false;
+            }
+            depth = theBranch[symbols[position]];
+            while (depth > 0) {
+                if (position + 1 >= size) {
+                    return false;
+                }
+                at += theArity[symbols[position]];
+                position++;
+                depth += theBranch[symbols[position]];
+            }
+        } while (theIgnored[symbols[position]] ||
+            (theBranch[symbols[position]] != 0));
+        if (symbols[position] != right[context]) {
+            return false;
+        }
+        count = theArity[symbols[position]];
+        copy(params + at, params + at + count, slots + slot);
+        slot += count;
+    }
+    return true;
+}
+
+void ParametricLsystem::measure(const string &symbols, size_t &length,
+        size_t &numParams) const {
+    size_t index;
+    length = 0;
+    numParams = 0;
+    for (index = 0; index < symbols.size(); index++) {
+        const RuleEntry &entry =
+            theTable[static_cast<unsigned char>(symbols[index])];
+        length += entry.length;
+        numParams += entry.numParams;
+    }
+}
+
+void ParametricLsystem::rewrite(const Modules &in, Modules &out,
+        size_t &length, size_t &numParams) const {
+    vector<double> slots(theNumSlots + 1), values(theNumValues + 1);
+    const unsigned char* symbols =
+        reinterpret_cast<const unsigned char*>(in.symbols.data());
+    const double* params = in.params.data();
+    const double* bound;
+    const size_t size = in.symbols.size();
+    const char* pool = thePool.data();
+    size_t index, offset, arg, count, nextLength, nextParams;
+    unsigned int candidate, last;
+    bool applied;
+    char* begin;
+    char* write;
+    double* place;
+    double* value;
+    // Release the stale generation before growing
+    if (out.symbols.capacity() < length) {
+        string().swap(out.symbols);
+        out.symbols.reserve(length);
+        adviseHuge(out.symbols.data(), length);
+    }
+    if (out.params.capacity() < numParams) {
+        vector<double, UninitialisedAllocator<double> >().swap(
+            out.params);
+        out.params.reserve(numParams);
+        adviseHuge(out.params.data(), numParams*sizeof(double));
+    }
+    out.symbols.resize(length);
+    out.params.resize(numParams);
+    // The successors and their parameters, up to the bounds, and the
+    // bounds of the generation after. The sizes are read into locals, as
+    // every symbol written may alias them.
+    begin = &out.symbols[0];
+    write = begin;
+    place = out.params.data();
+    value = values.data();
+    offset = 0;
+    nextLength = 0;
+    nextParams = 0;
+    for (index = 0; index < size; index++) {
+        const RuleEntry &entry = theTable[symbols[index]];
+        if (entry.fixed && (entry.length == 1)) {
+            *write = pool[entry.offset];
+            write++;
+            nextLength += entry.nextLength;
+            nextParams += entry.nextParams;
+        } else if (entry.fixed) {
+            memcpy(write, pool + entry.offset, entry.length);
+            write += entry.length;
+            nextLength += entry.nextLength;
+            nextParams += entry.nextParams;
+        } else {
+            count = theArity[symbols[index]];
+            candidate = entry.first;
+            last = entry.first + entry.count;
+            bound = params + offset;
+            applied = entry.direct;
+            // The first rule whose contexts and condition hold
+            while (!applied && (candidate < last)) {
+                const Rule &rule = theRules[candidate];
+                // Without contexts, the parameters are bound in place
+                bound = params + offset;
+                applied = true;
+                if (rule.contextual) {
+                    applied = match(in, index, offset, rule, slots.data());
+                    bound = slots.data();
+                }
+                if (applied && rule.conditional) {
+                    applied = rule.condition.evaluate(bound) != 0;
+                }
+                if (!applied) {
+                    candidate++;
+                }
+            }
+            if (candidate < last) {
+                const Rule &rule = theRules[candidate];
+                const size_t numSymbols = rule.successor.size();
+                const size_t numValues = rule.expressions.size();
+                const size_t numArgs = rule.arguments.size();
+                const unsigned int* arguments = rule.arguments.data();
+                for (arg = 0; arg < numValues; arg++) {
+                    value[arg] = rule.expressions[arg].evaluate(bound);
+                }
+                for (arg = 0; arg < numArgs; arg++) {
+                    place[arg] = value[arguments[arg]];
+                }
+                place += numArgs;
+                memcpy(write, rule.successor.data(), numSymbols);
+                write += numSymbols;
+                nextLength += rule.nextLength;
+                nextParams += rule.nextParams;
+            } else {
+                // No rule applies, the module is copied
+                *write = symbols[index];
+                write++;
+                copy(params + offset, params + offset + count, place);
+                place += count;
+                nextLength += entry.nextLength;
+                nextParams += entry.nextParams;
+            }
+            offset += count;
+        }
+    }
+    out.symbols.resize(write - begin);
+    out.params.resize(place - out.params.data());
+    length = nextLength;
+    numParams = nextParams;
+}
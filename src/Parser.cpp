@@ -33,97 +33,666 @@
 |________________________________________________________________________*/
 
 #include "Parser.hpp"
+#include "Expression.hpp"
 #include <string>
 #include <set>
 #include <map>
-#include <fstream>
-#include <boost/tokenizer.hpp>
-#include <cstdlib>
 #include <vector>
+#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace std;
-using namespace boost;
+
+/**
+ * @brief Order of the production rules by predecessor.
+ */
+static bool bySymbol(const pair<char, pair<string, double> > &left,
+        const pair<char, pair<string, double> > &right) {
+    return left.first < right.first;
+}
+
+/**
+ * @brief Check whether a character may be part of a word.
+ * @param character The character.
+ * @return True if it is printable (or beyond ASCII) and none of ",():#".
+ */
+static inline bool isWordChar(const char character) {
+    unsigned char code = static_cast<unsigned char>(character);
+    return (code > ' ') && (code != 127) && (code != ',') && (code != '(') &&
+        (code != ')') && (code != ':') && (code != '#');
+}
+
+/**
+ * @brief Check whether a parameter is a name.
+ * @param text The parameter.
+ * @return True if it is a letter or "_", then letters, digits or "_".
+ */
+static bool isName(const string &text) {
+    size_t position;
+    bool valid = !text.empty() && (isalpha(text[0]) || (text[0] == '_'));
+    for (position = 1; valid && (position < text.size()); position++) {
+        valid = isalnum(text[position]) || (text[position] == '_');
+    }
+    return valid;
+}
+
+// Instructions of the turtle, and whether they take a number
+static const char* INSTRUCTIONS[] = {"drawForward", "turnLeft",
+    "turnRight", "pitchDown", "pitchUp", "rollLeft", "rollRight",
+    "pushPos", "pushAng", "popPos", "popAng", "turnAround"};
+static const unsigned int NUM_INSTRUCTIONS = 12;
+static const unsigned int NUM_OPERANDS = 7;
 
 Parser::Parser() {
+    int symbol;
+    theNumIters = 0;
     theScale = "1";
     theInitPos.push_back("0");
     theInitPos.push_back("0");
     theInitAng = "0";
+    theLongest = 1;
+    for (symbol = 0; symbol < 256; symbol++) {
+        theDeclared[symbol] = false;
+        theArity[symbol] = -1;
+    }
 }
 
-void Parser::parse(ifstream& file) {
-    string line, instros;
-    char cLine;
-    while (file.good()) {
-        getline(file, line);
-        if (!line.empty()) { // Skip blank lines
-            // Skip comments
-            if (line.at(0) != '#') {
-                tokenizer<> tok(line);
-                tokenizer<>::iterator lineChar = tok.begin();
-                if (!(*lineChar).compare("variables")) {
-                    lineChar++;
-                    for(lineChar; lineChar != tok.end(); lineChar++) {
-                        cLine = (*lineChar).at(0);
-                        theV.insert(cLine);
-                    }
-                } else if (!(*lineChar).compare("start")) {
-                    lineChar++;
-                    theW = *lineChar;
-                } else if (!(*lineChar).compare("rules")) {
-                    lineChar++;
-                    for(lineChar; lineChar != tok.end(); lineChar++) {
-                        cLine = (*lineChar).at(0);
-                        lineChar++;
-                        theP.insert(pair<char, string>(cLine,
-                            (*lineChar)));
-                    }
-                } else if (!(*lineChar).compare("runIters")) {
-                    lineChar++;
-                    theNumIters = atoi((*lineChar).c_str());
-                } else if (!(*lineChar).compare("tg")) {
-                    lineChar++;
-                    cLine = (*lineChar).at(0);
-                    lineChar++;
-                    instros.clear();
-                    for(lineChar; lineChar != tok.end(); lineChar++) {
-                        instros += *lineChar;
-                        instros += " ";
-                    }
-                    theTurtle[cLine] = instros;
-                } else if (!(*lineChar).compare("drawingReductionScale")) {
-                    lineChar++;
-                    theScale = *lineChar;
-                } else if (!(*lineChar).compare("drawingInitPos")) {
-                    lineChar++;
-                    theInitPos[0] = *lineChar;
-                    lineChar++;
-                    theInitPos[1] = *lineChar;
-                    // Check negatives
-                    if (line.find("-") < line.find(",")) {
-                        theInitPos[0].insert(0, "-");
-                    }
-                    if (line.rfind("-") > line.find(",")) {
-                        theInitPos[1].insert(0, "-");
+bool Parser::parse(const string &path, string &error) {
+    struct stat status;
+    void* mapping = MAP_FAILED;
+    bool opened, valid = true;
+    int descriptor = open(path.c_str(), O_RDONLY);
+    opened = (descriptor >= 0) && (fstat(descriptor, &status) == 0);
+    // An empty file cannot be mapped, but it is a valid definition
+    if (opened && (status.st_size > 0)) {
+        mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE,
+            descriptor, 0);
+        opened = mapping != MAP_FAILED;
+    }
+    if (opened && (mapping != MAP_FAILED)) {
+        madvise(mapping, status.st_size, MADV_SEQUENTIAL);
+        valid = parse(static_cast<const char*>(mapping), status.st_size,
+            error);
+        munmap(mapping, status.st_size);
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+    if (!opened) {
+        error = "error opening file " + path;
+    } else if (!valid) {
+        error = path + ":" + error;
+    }
+    return opened && valid;
+}
+
+bool Parser::parse(const char* text, const size_t size, string &error) {
+    vector<pair<char, pair<string, double> > > rules;
+    vector<pair<char, pair<string, double> > >::iterator rule;
+    Cursor cursor;
+    bool valid = true;
+    cursor.at = text;
+    cursor.end = text + size;
+    cursor.line = text;
+    cursor.number = 1;
+    while (valid && (cursor.at < cursor.end)) {
+        skipBlanks(cursor);
+        // Skip blank lines and comments
+        if (!atLineEnd(cursor)) {
+            valid = statement(cursor, rules, error);
+        }
+        if (valid) {
+            while ((cursor.at < cursor.end) && (*cursor.at != '\n')) {
+                cursor.at++;
+            }
+            if (cursor.at < cursor.end) {
+                cursor.at++;
+                cursor.line = cursor.at;
+                cursor.number++;
+            }
+        }
+    }
+    // Inserted by predecessor, in order, at the end of the rules
+    stable_sort(rules.begin(), rules.end(), bySymbol);
+    for (rule = rules.begin(); rule != rules.end(); rule++) {
+        theP.insert(theP.end(), move(*rule));
+    }
+    return valid;
+}
+
+bool Parser::statement(Cursor &cursor,
+        vector<pair<char, pair<string, double> > > &rules, string &error) {
+    const char* where = cursor.at;
+    const char* begin;
+    string_view keyword = token(cursor), word;
+    string text, written, axiom;
+    char symbol;
+    double value;
+    unsigned int instruction;
+    unsigned int count;
+    bool valid = true;
+    skipBlanks(cursor);
+    if (!keyword.compare("tg")) {
+        valid = lookup(cursor, symbol, error);
+        skipBlanks(cursor);
+    }
+    if (!valid || !expect(cursor, ':', error)) {
+        return false;
+    }
+    skipBlanks(cursor);
+    if (!keyword.compare("variables")) {
+        while (valid && !atLineEnd(cursor)) {
+            where = cursor.at;
+            word = token(cursor);
+            valid = word.empty() ? fail(cursor, where, "expected a symbol",
+                error) : declare(cursor, word, error);
+            skipSeparator(cursor);
+        }
+    } else if (!keyword.compare("start")) {
+        begin = cursor.at;
+        while ((cursor.at < cursor.end) && (*cursor.at != '\n') &&
+                (*cursor.at != '(')) {
+            cursor.at++;
+        }
+        theW.clear();
+        if ((cursor.at < cursor.end) && (*cursor.at == '(')) {
+            // Modules with constant parameters, kept without blanks
+            cursor.at = begin;
+            valid = modules(cursor, false, NULL, vector<string>(), count,
+                error);
+            for (; valid && (begin < cursor.at); begin++) {
+                if (!isspace(static_cast<unsigned char>(*begin))) {
+                    axiom += *begin;
+                }
+            }
+            theW = translate(axiom);
+        } else {
+            cursor.at = begin;
+            while (valid && !atLineEnd(cursor)) {
+                where = cursor.at;
+                word = token(cursor);
+                valid = word.empty() ? fail(cursor, where,
+                    "expected a symbol", error) :
+                    translate(cursor, where, word, theW, error);
+                skipSeparator(cursor);
+            }
+        }
+    } else if (!keyword.compare("rules")) {
+        // One rule in every parenthesis, weight is optional
+        while (valid && !atLineEnd(cursor)) {
+            valid = expect(cursor, '(', error);
+            skipBlanks(cursor);
+            valid = valid && lookup(cursor, symbol, error);
+            skipBlanks(cursor);
+            if (valid && ((cursor.end - cursor.at < 2) ||
+                    (cursor.at[0] != '-') || (cursor.at[1] != '>'))) {
+                valid = fail(cursor, cursor.at, "expected \"->\"", error);
+            }
+            text.clear();
+            if (valid) {
+                cursor.at += 2;
+                skipBlanks(cursor);
+                where = cursor.at;
+                word = token(cursor);
+                valid = translate(cursor, where, word, text, error);
+                skipBlanks(cursor);
+            }
+            value = 1;
+            if (valid && !atLineEnd(cursor) && (*cursor.at != ')')) {
+                where = cursor.at;
+                valid = number(cursor, written, value, error);
+                if (valid && (value < 0)) {
+                    valid = fail(cursor, where, "negative weight", error);
+                }
+                skipBlanks(cursor);
+            }
+            valid = valid && expect(cursor, ')', error);
+            if (valid) {
+                rules.push_back(pair<char, pair<string, double> >(symbol,
+                    pair<string, double>(move(text), value)));
+            }
+            skipSeparator(cursor);
+        }
+    } else if (!keyword.compare("rule")) {
+        // Checked here, compiled by the engine (see ParametricLsystem)
+        begin = cursor.at;
+        valid = rule(cursor, error);
+        if (valid) {
+            theModuleRules.push_back(translate(string(begin, cursor.at)));
+        }
+    } else if (!keyword.compare("ignore")) {
+        while (valid && !atLineEnd(cursor)) {
+            valid = lookup(cursor, symbol, error);
+            if (valid) {
+                theIgnored.insert(symbol);
+            }
+            skipSeparator(cursor);
+        }
+    } else if (!keyword.compare("runIters")) {
+        where = cursor.at;
+        word = token(cursor);
+        from_chars_result result = from_chars(word.data(),
+            word.data() + word.size(), theNumIters);
+        if (word.empty() || (result.ec != errc()) ||
+                (result.ptr != word.data() + word.size()) ||
+                (theNumIters < 0)) {
+            valid = fail(cursor, where, "expected a number of iterations",
+                error);
+        }
+    } else if (!keyword.compare("tg")) {
+        text.clear();
+        while (valid && !atLineEnd(cursor)) {
+            where = cursor.at;
+            word = token(cursor);
+            instruction = 0;
+            while ((instruction < NUM_INSTRUCTIONS) &&
+                    word.compare(INSTRUCTIONS[instruction])) {
+                instruction++;
+            }
+            if (instruction == NUM_INSTRUCTIONS) {
+                valid = fail(cursor, where, "unknown instruction \"" +
+                    string(word) + "\"", error);
+            }
+            text += word;
+            text += " ";
+            // Moves and turns take a numeric operand
+            if (valid && (instruction < NUM_OPERANDS)) {
+                skipBlanks(cursor);
+                valid = number(cursor, written, value, error);
+                text += written + " ";
+            }
+            skipSeparator(cursor);
+        }
+        if (valid) {
+            theTurtle[symbol] = text;
+            // Branches, for the contexts of the rules
+            theOpening.erase(symbol);
+            theClosing.erase(symbol);
+            if ((text.find("pushPos") != string::npos) ||
+                    (text.find("pushAng") != string::npos)) {
+                theOpening.insert(symbol);
+            } else if ((text.find("popPos") != string::npos) ||
+                    (text.find("popAng") != string::npos)) {
+                theClosing.insert(symbol);
+            }
+        }
+    } else if (!keyword.compare("drawingReductionScale")) {
+        valid = number(cursor, theScale, value, error);
+    } else if (!keyword.compare("drawingInitPos")) {
+        valid = number(cursor, theInitPos[0], value, error);
+        skipSeparator(cursor);
+        valid = valid && number(cursor, theInitPos[1], value, error);
+    } else if (!keyword.compare("drawingInitAng")) {
+        valid = number(cursor, theInitAng, value, error);
+    } else {
+        valid = fail(cursor, where, "unknown keyword \"" + string(keyword) +
+            "\"", error);
+    }
+    skipBlanks(cursor);
+    if (valid && !atLineEnd(cursor)) {
+        valid = fail(cursor, cursor.at, "unexpected \"" +
+            string(1, *cursor.at) + "\"", error);
+    }
+    return valid;
+}
+
+bool Parser::fail(const Cursor &cursor, const char* where,
+        const string &message, string &error) const {
+    ostringstream position;
+    position << cursor.number << ":" << where - cursor.line + 1 << ": ";
+    error = position.str() + message;
+    return false;
+}
+
+void Parser::skipBlanks(Cursor &cursor) const {
+    while ((cursor.at < cursor.end) && ((*cursor.at == ' ') ||
+            (*cursor.at == '\t') || (*cursor.at == '\r'))) {
+        cursor.at++;
+    }
+}
+
+void Parser::skipSeparator(Cursor &cursor) const {
+    skipBlanks(cursor);
+    if ((cursor.at < cursor.end) && (*cursor.at == ',')) {
+        cursor.at++;
+        skipBlanks(cursor);
+    }
+}
+
+bool Parser::atLineEnd(const Cursor &cursor) const {
+    return (cursor.at == cursor.end) || (*cursor.at == '\n') ||
+        (*cursor.at == '#');
+}
+
+string_view Parser::token(Cursor &cursor) const {
+    const char* begin = cursor.at;
+    while ((cursor.at < cursor.end) && isWordChar(*cursor.at) &&
+            !((*cursor.at == '-') && (cursor.at + 1 < cursor.end) &&
+            (cursor.at[1] == '>'))) {
+        cursor.at++;
+    }
+    return string_view(begin, cursor.at - begin);
+}
+
+bool Parser::expect(Cursor &cursor, const char expected,
+        string &error) const {
+    if ((cursor.at == cursor.end) || (*cursor.at != expected)) {
+        return fail(cursor, cursor.at, "expected \"" +
+            string(1, expected) + "\"", error);
+    }
+    cursor.at++;
+    return true;
+}
+
+bool Parser::number(Cursor &cursor, string &text, double &value,
+        string &error) const {
+    const char* where = cursor.at;
+    string_view word = token(cursor);
+    from_chars_result result = from_chars(word.data(),
+        word.data() + word.size(), value);
+    if (word.empty() || (result.ec != errc()) ||
+            (result.ptr != word.data() + word.size())) {
+        return fail(cursor, where, "expected a number", error);
+    }
+    text = word;
+    return true;
+}
+
+bool Parser::declare(const Cursor &cursor, const string_view name,
+        string &error) {
+    int code = 128;
+    if (name.size() == 1) {
+        theV.insert(name[0]);
+        theDeclared[static_cast<unsigned char>(name[0])] = true;
+    } else if (theCodes.find(name) == theCodes.end()) {
+        // The first character that no symbol takes
+        while ((code < 256) && theDeclared[code]) {
+            code++;
+        }
+        if (code == 256) {
+            return fail(cursor, cursor.at - name.size(),
+                "too many symbols", error);
+        }
+        theCodes[string(name)] = static_cast<char>(code);
+        theV.insert(static_cast<char>(code));
+        theDeclared[code] = true;
+        theLongest = max(theLongest, name.size());
+    }
+    return true;
+}
+
+bool Parser::lookup(Cursor &cursor, char &symbol, string &error) const {
+    const char* where = cursor.at;
+    string_view name = token(cursor);
+    map<string, char, less<> >::const_iterator code = theCodes.find(name);
+    if (name.empty()) {
+        return fail(cursor, where, "expected a symbol", error);
+    }
+    if ((name.size() == 1) &&
+            theDeclared[static_cast<unsigned char>(name[0])]) {
+        symbol = name[0];
+    } else if (code != theCodes.end()) {
+        symbol = (*code).second;
+    } else {
+        return fail(cursor, where, "undeclared symbol \"" + string(name) +
+            "\"", error);
+    }
+    return true;
+}
+
+bool Parser::rule(Cursor &cursor, string &error) {
+    vector<string> formals;
+    const char* predecessor = cursor.at;
+    const char* where;
+    string message;
+    unsigned int count;
+    int depth = 0;
+    bool valid;
+    // Head "left < predecessor > right", whose parameters are names
+    valid = modules(cursor, true, &formals, vector<string>(), count, error);
+    if (valid && (cursor.at < cursor.end) && (*cursor.at == '<')) {
+        cursor.at++;
+        skipBlanks(cursor);
+        predecessor = cursor.at;
+        valid = modules(cursor, true, &formals, vector<string>(), count,
+            error);
+    }
+    if (valid && (count != 1)) {
+        valid = fail(cursor, predecessor,
+            "expected a single predecessor module", error);
+    }
+    if (valid && (cursor.at < cursor.end) && (*cursor.at == '>')) {
+        cursor.at++;
+        valid = modules(cursor, true, &formals, vector<string>(), count,
+            error);
+    }
+    // Condition, up to the arrow outside the parentheses
+    if (valid && (cursor.at < cursor.end) && (*cursor.at == ':')) {
+        cursor.at++;
+        skipBlanks(cursor);
+        where = cursor.at;
+        while (!atLineEnd(cursor) && ((depth > 0) ||
+                (cursor.end - cursor.at < 2) || (cursor.at[0] != '-') ||
+                (cursor.at[1] != '>'))) {
+            if (*cursor.at == '(') {
+                depth++;
+            } else if (*cursor.at == ')') {
+                depth--;
+            }
+            cursor.at++;
+        }
+        Expression condition;
+        if (!condition.compile(string(where, cursor.at), formals,
+                message)) {
+            valid = fail(cursor, where, message, error);
+        }
+    }
+    if (valid && ((cursor.end - cursor.at < 2) || (cursor.at[0] != '-') ||
+            (cursor.at[1] != '>'))) {
+        valid = fail(cursor, cursor.at, "expected \"->\"", error);
+    }
+    // Successor, whose parameters are expressions of the formal ones
+    if (valid) {
+        cursor.at += 2;
+        valid = modules(cursor, false, NULL, formals, count, error);
+    }
+    return valid;
+}
+
+bool Parser::modules(Cursor &cursor, const bool head,
+        vector<string>* formals, const vector<string> &scope,
+        unsigned int &count, string &error) {
+    const char* where;
+    const char* open;
+    const char* start;
+    string parameter, message;
+    char symbol;
+    int depth, numParams;
+    bool valid = true;
+    count = 0;
+    skipBlanks(cursor);
+    while (valid && !atLineEnd(cursor) && !(head && ((*cursor.at == '<') ||
+            (*cursor.at == '>') || (*cursor.at == ':') ||
+            ((cursor.end - cursor.at >= 2) && (cursor.at[0] == '-') &&
+            (cursor.at[1] == '>'))))) {
+        where = cursor.at;
+        if ((*cursor.at == '(') || (*cursor.at == ')') ||
+                (*cursor.at == ',')) {
+            valid = fail(cursor, where, "misplaced \"" +
+                string(1, *cursor.at) + "\"", error);
+        } else {
+            valid = name(cursor, symbol, error);
+        }
+        numParams = 0;
+        if (valid && (cursor.at < cursor.end) && (*cursor.at == '(')) {
+            // Parameters, split at the commas of the outer parenthesis
+            open = cursor.at;
+            depth = 1;
+            cursor.at++;
+            start = cursor.at;
+            while (valid && (depth > 0) && (cursor.at < cursor.end) &&
+                    (*cursor.at != '\n')) {
+                if (*cursor.at == '(') {
+                    depth++;
+                } else if (*cursor.at == ')') {
+                    depth--;
+                }
+                if ((depth == 0) || ((depth == 1) && (*cursor.at == ','))) {
+                    parameter.assign(start, cursor.at);
+                    if ((formals != NULL) && !isName(parameter)) {
+                        valid = fail(cursor, start, "\"" + parameter +
+                            "\" is not a parameter name", error);
+                    } else if (formals != NULL) {
+                        formals->push_back(parameter);
+                    } else {
+                        Expression value;
+                        if (!value.compile(parameter, scope, message)) {
+                            valid = fail(cursor, start, message, error);
+                        }
                     }
-                } else if (!(*lineChar).compare("drawingInitAng")) {
-                    lineChar++;
-                    theInitAng = *lineChar;
+                    numParams++;
+                    start = cursor.at + 1;
                 }
+                cursor.at++;
+            }
+            if (valid && (depth > 0)) {
+                valid = fail(cursor, open, "missing \")\"", error);
             }
         }
+        // Every module of a symbol takes as many parameters
+        if (valid && (theArity[static_cast<unsigned char>(symbol)] >= 0) &&
+                (theArity[static_cast<unsigned char>(symbol)] !=
+                numParams)) {
+            ostringstream takes;
+            takes << "symbol \"" << string(where, 1) << "\" takes " <<
+                theArity[static_cast<unsigned char>(symbol)] <<
+                " parameters";
+            valid = fail(cursor, where, takes.str(), error);
+        }
+        if (valid) {
+            theArity[static_cast<unsigned char>(symbol)] = numParams;
+            count++;
+        }
+        skipBlanks(cursor);
+    }
+    return valid;
+}
+
+bool Parser::name(Cursor &cursor, char &symbol, string &error) const {
+    map<string, char, less<> >::const_iterator code;
+    size_t length = min(theLongest,
+        static_cast<size_t>(cursor.end - cursor.at));
+    bool found = false;
+    // The longest name that matches
+    while (!found && (length > 1)) {
+        code = theCodes.find(string_view(cursor.at, length));
+        found = code != theCodes.end();
+        length--;
+    }
+    if (found) {
+        symbol = (*code).second;
+        cursor.at += length + 1;
+    } else if (theDeclared[static_cast<unsigned char>(*cursor.at)]) {
+        symbol = *cursor.at;
+        cursor.at++;
+    } else {
+        return fail(cursor, cursor.at, "undeclared symbol \"" +
+            string(1, *cursor.at) + "\"", error);
+    }
+    return true;
+}
+
+bool Parser::translate(const Cursor &cursor, const char* word,
+        const string_view name, string &symbols, string &error) const {
+    map<string, char, less<> >::const_iterator code;
+    size_t position = 0, length;
+    bool found;
+    // One character per symbol, the word is appended as is
+    if (theCodes.empty()) {
+        while ((position < name.size()) &&
+                theDeclared[static_cast<unsigned char>(name[position])]) {
+            position++;
+        }
+        if (position == name.size()) {
+            symbols.append(name);
+        }
+    }
+    while (position < name.size()) {
+        // The longest name that matches
+        found = false;
+        length = min(theLongest, name.size() - position);
+        while (!found && (length > 1)) {
+            code = theCodes.find(name.substr(position, length));
+            found = code != theCodes.end();
+            length--;
+        }
+        if (found) {
+            symbols += (*code).second;
+            position += length + 1;
+        } else if (theDeclared[static_cast<unsigned char>(name[position])]) {
+            symbols += name[position];
+            position++;
+        } else {
+            return fail(cursor, word + position, "undeclared symbol \"" +
+                string(name.substr(position, 1)) + "\"", error);
+        }
     }
+    return true;
 }
 
-set<char> Parser::getAlphabet() const {
+string Parser::translate(const string &text) const {
+    map<string, char, less<> >::const_iterator code;
+    string symbols;
+    size_t position = 0, length;
+    int depth = 0;
+    bool condition = false;
+    bool found;
+    while (position < text.size()) {
+        // Parameters and conditions are left as written
+        found = false;
+        if ((depth == 0) && !condition && !theCodes.empty()) {
+            length = min(theLongest, text.size() - position);
+            while (!found && (length > 1)) {
+                code = theCodes.find(text.substr(position, length));
+                found = code != theCodes.end();
+                length--;
+            }
+        }
+        if (found) {
+            symbols += (*code).second;
+            position += length + 1;
+        } else {
+            if (text[position] == '(') {
+                depth++;
+            } else if (text[position] == ')') {
+                depth--;
+            } else if ((depth == 0) && (text[position] == ':')) {
+                condition = true;
+            } else if ((depth == 0) && (text.compare(position, 2, "->") ==
+                    0)) {
+                condition = false;
+            }
+            symbols += text[position];
+            position++;
+        }
+    }
+    return symbols;
+}
+
+const set<char>& Parser::getAlphabet() const {
     return theV;
 }
 
-string Parser::getAxiom() const {
+const string& Parser::getAxiom() const {
     return theW;
 }
 
-multimap<char, string> Parser::getRules() const {
+const multimap<char, pair<string, double> >& Parser::getRules() const {
     return theP;
 }
 
@@ -131,19 +700,35 @@ int Parser::getIterations() const {
     return theNumIters;
 }
 
-map<char, string> Parser::getTurtle() const {
+const map<char, string>& Parser::getTurtle() const {
     return theTurtle;
 }
 
-string Parser::getReductionScale() const {
+const vector<string>& Parser::getModuleRules() const {
+    return theModuleRules;
+}
+
+const set<char>& Parser::getIgnored() const {
+    return theIgnored;
+}
+
+const set<char>& Parser::getOpening() const {
+    return theOpening;
+}
+
+const set<char>& Parser::getClosing() const {
+    return theClosing;
+}
+
+const string& Parser::getReductionScale() const {
     return theScale;
 }
 
-vector<string> Parser::getInitPos() const {
+const vector<string>& Parser::getInitPos() const {
     return theInitPos;
 }
 
-string Parser::getInitAng() const {
+const string& Parser::getInitAng() const {
     return theInitAng;
 }
 
@@ -0,0 +1,163 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : PlyWriter.cpp                                               |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "PlyWriter.hpp"
+#include <vector>
+#include <string>
+#include <ostream>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Number of vertices gathered before writing them out.
+ */
+static const size_t BLOCK_SIZE = 8192;
+
+/**
+ * @brief Encode an unsigned integer in little-endian byte order.
+ */
+static void encode(char* bytes, uint32_t value) {
+    int byte;
+    for (byte = 0; byte < 4; byte++) {
+        bytes[byte] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+/**
+ * @brief Encode a single-precision coordinate in little-endian order.
+ */
+static void encode(char* bytes, const float coord) {
+    uint32_t bits;
+    memcpy(&bits, &coord, 4);
+    encode(bytes, bits);
+}
+
+PlyWriter::PlyWriter(ostream &out, const unsigned long long numSegs) :
+        theOut(out) {
+    theAnnounced = numSegs;
+    theSize = 0;
+    theX.reserve(BLOCK_SIZE);
+    theY.reserve(BLOCK_SIZE);
+    theZ.reserve(BLOCK_SIZE);
+    theBytes.resize(12*BLOCK_SIZE);
+    header(numSegs);
+}
+
+bool PlyWriter::fits(const unsigned long long numSegs, string &error) {
+    if (numSegs > UINT32_MAX/2) {
+        ostringstream message;
+        message << "PLY indexes at most " << UINT32_MAX/2 <<
+            " segments, " << numSegs << " drawn";
+        error = message.str();
+        return false;
+    }
+    return true;
+}
+
+void PlyWriter::add(const double x0, const double y0, const double z0,
+        const double x1, const double y1, const double z1) {
+    theX.push_back(x0);
+    theY.push_back(y0);
+    theZ.push_back(z0);
+    theX.push_back(x1);
+    theY.push_back(y1);
+    theZ.push_back(z1);
+    theSize++;
+    if (theX.size() >= BLOCK_SIZE) {
+        flush();
+    }
+}
+
+bool PlyWriter::close(string &error) {
+    unsigned long long seg;
+    size_t count = 0;
+    flush();
+    // The indices would wrap around and join the wrong vertices
+    if (!fits(theSize, error)) {
+        return false;
+    }
+    // Every segment joins its own pair of vertices
+    for (seg = 0; seg < theSize; seg++) {
+        encode(&theBytes[8*count], static_cast<uint32_t>(2*seg));
+        encode(&theBytes[8*count + 4], static_cast<uint32_t>(2*seg + 1));
+        count++;
+        if (8*(count + 1) > theBytes.size()) {
+            theOut.write(&theBytes[0], 8*count);
+            count = 0;
+        }
+    }
+    theOut.write(&theBytes[0], 8*count);
+    if (theSize != theAnnounced) {
+        ostringstream message;
+        message << "PLY header announces " << theAnnounced <<
+            " segments, " << theSize << " drawn";
+        error = message.str();
+        return false;
+    }
+    if (theOut.fail()) {
+        error = "error writing PLY output";
+        return false;
+    }
+    return true;
+}
+
+unsigned long long PlyWriter::size() const {
+    return theSize;
+}
+
+void PlyWriter::flush() {
+    size_t vertex;
+    for (vertex = 0; vertex < theX.size(); vertex++) {
+        encode(&theBytes[12*vertex], theX[vertex]);
+        encode(&theBytes[12*vertex + 4], theY[vertex]);
+        encode(&theBytes[12*vertex + 8], theZ[vertex]);
+    }
+    theOut.write(&theBytes[0], 12*theX.size());
+    theX.clear();
+    theY.clear();
+    theZ.clear();
+}
+
+void PlyWriter::header(const unsigned long long numSegs) {
+    theOut << "ply\nformat binary_little_endian 1.0\n" <<
+        "comment generated by L-system\n" <<
+        "element vertex " << 2*numSegs << "\n" <<
+        "property float x\nproperty float y\nproperty float z\n" <<
+        "element edge " << numSegs << "\n" <<
+        "property uint vertex1\nproperty uint vertex2\nend_header\n";
+}
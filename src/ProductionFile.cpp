@@ -0,0 +1,172 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ProductionFile.cpp                                          |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "ProductionFile.hpp"
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+/**
+ * @brief Signature of the production files.
+ */
+static const char MAGIC[8] = {'L', 'S', 'Y', 'S', 'P', 'R', 'O', 'D'};
+
+/**
+ * @brief Version of the production file format.
+ */
+static const uint32_t VERSION = 1;
+
+ProductionFile::ProductionFile() {
+    theDescriptor = -1;
+    theMapping = NULL;
+    theSize = 0;
+    theWritable = false;
+}
+
+ProductionFile::~ProductionFile() {
+    close();
+}
+
+bool ProductionFile::open(const string &path, string &error) {
+    struct stat status;
+    close();
+    theDescriptor = ::open(path.c_str(), O_RDONLY);
+    if ((theDescriptor < 0) || (fstat(theDescriptor, &status) != 0)) {
+        close();
+        error = "error opening file " + path;
+        return false;
+    }
+    if ((static_cast<size_t>(status.st_size) < sizeof(Header)) ||
+            !map(status.st_size, false) || !isValid(getHeader())) {
+        close();
+        error = path + ": not a production file";
+        return false;
+    }
+    if (getHeader().length != theSize - sizeof(Header)) {
+        close();
+        error = path + ": truncated production file";
+        return false;
+    }
+    return true;
+}
+
+bool ProductionFile::create(const string &path, const Header &header,
+        string &error) {
+    size_t size = sizeof(Header) + header.length;
+    close();
+    theDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    // The file is sized at once, its pages are filled in as written
+    if ((theDescriptor < 0) || (ftruncate(theDescriptor, size) != 0) ||
+            !map(size, true)) {
+        close();
+        error = "error writing file " + path;
+        return false;
+    }
+    memcpy(theMapping, &header, sizeof(Header));
+    return true;
+}
+
+void ProductionFile::close() {
+    if (theMapping != NULL) {
+        munmap(theMapping, theSize);
+        theMapping = NULL;
+    }
+    if (theDescriptor >= 0) {
+        ::close(theDescriptor);
+        theDescriptor = -1;
+    }
+    theSize = 0;
+    theWritable = false;
+}
+
+const ProductionFile::Header& ProductionFile::getHeader() const {
+    return *reinterpret_cast<const Header*>(theMapping);
+}
+
+const char* ProductionFile::getSymbols() const {
+    return theMapping + sizeof(Header);
+}
+
+char* ProductionFile::getSymbols() {
+    return theMapping + sizeof(Header);
+}
+
+void ProductionFile::release(const size_t offset, const size_t length) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    // Whole pages only, the neighbouring symbols may still be in use
+    size_t first = (sizeof(Header) + offset + page - 1)/page*page;
+    size_t last = (sizeof(Header) + offset + length)/page*page;
+    if (first < last) {
+        if (theWritable) {
+            msync(theMapping + first, last - first, MS_ASYNC);
+        }
+        madvise(theMapping + first, last - first, MADV_DONTNEED);
+    }
+}
+
+void ProductionFile::stamp(Header &header, const unsigned int epoch,
+        const unsigned long long seed, const unsigned long long grammar,
+        const size_t length) {
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.epoch = epoch;
+    header.seed = seed;
+    header.grammar = grammar;
+    header.length = length;
+}
+
+bool ProductionFile::isValid(const Header &header) {
+    return !memcmp(header.magic, MAGIC, sizeof(MAGIC)) &&
+        (header.version == VERSION);
+}
+
+bool ProductionFile::map(const size_t size, const bool writable) {
+    void* mapping = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE :
+        PROT_READ, MAP_SHARED, theDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    theMapping = static_cast<char*>(mapping);
+    theSize = size;
+    theWritable = writable;
+    // Read ahead aggressively, drop behind
+    madvise(theMapping, theSize, MADV_SEQUENTIAL);
+    return true;
+}
@@ -0,0 +1,80 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Random.cpp                                                  |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Random.hpp"
+
+using namespace std;
+
+/**
+ * @brief Philox multipliers and Weyl key increments.
+ */
+static const unsigned int PHILOX_M0 = 0xD2511F53u;
+static const unsigned int PHILOX_M1 = 0xCD9E8D57u;
+static const unsigned int PHILOX_W0 = 0x9E3779B9u;
+static const unsigned int PHILOX_W1 = 0xBB67AE85u;
+
+Random::Random(const unsigned long long seed) {
+    theSeed = seed;
+}
+
+unsigned long long Random::getSeed() const {
+    return theSeed;
+}
+
+double Random::uniform(const unsigned int epoch,
+        const unsigned long long position) const {
+    unsigned int ctr[4], key[2];
+    unsigned long long prod0, prod1;
+    unsigned long long bits;
+    int round;
+    ctr[0] = static_cast<unsigned int>(position);
+    ctr[1] = static_cast<unsigned int>(position >> 32);
+    ctr[2] = epoch;
+    ctr[3] = 0;
+    key[0] = static_cast<unsigned int>(theSeed);
+    key[1] = static_cast<unsigned int>(theSeed >> 32);
+    for (round = 0; round < 10; round++) {
+        prod0 = static_cast<unsigned long long>(PHILOX_M0)*ctr[0];
+        prod1 = static_cast<unsigned long long>(PHILOX_M1)*ctr[2];
+        ctr[0] = static_cast<unsigned int>(prod1 >> 32)^ctr[1]^key[0];
+        ctr[1] = static_cast<unsigned int>(prod1);
+        ctr[2] = static_cast<unsigned int>(prod0 >> 32)^ctr[3]^key[1];
+        ctr[3] = static_cast<unsigned int>(prod0);
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+    // Top 53 bits of the first two words, scaled to [0, 1)
+    bits = (static_cast<unsigned long long>(ctr[0]) << 32) | ctr[1];
+    return (bits >> 11)*(1.0/9007199254740992.0);
+}
@@ -0,0 +1,363 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : RasterWriter.cpp                                            |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "RasterWriter.hpp"
+#include "Segments.hpp"
+#include "ThreadPool.hpp"
+#include <vector>
+#include <ostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <boost/crc.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+using namespace std;
+using namespace boost;
+
+/**
+ * @brief Side of the tiles, in pixels.
+ */
+static const unsigned int TILE = 256;
+
+/**
+ * @brief Bytes of compressed pixels in every PNG data chunk.
+ */
+static const streamsize CHUNK_SIZE = 1 << 16;
+
+/**
+ * @brief Encode an unsigned integer in big-endian byte order, as PNG.
+ */
+static void encode(char* bytes, const uint32_t value) {
+    bytes[0] = static_cast<char>(value >> 24);
+    bytes[1] = static_cast<char>((value >> 16) & 0xff);
+    bytes[2] = static_cast<char>((value >> 8) & 0xff);
+    bytes[3] = static_cast<char>(value & 0xff);
+}
+
+/**
+ * @brief Write a PNG chunk: length, type, data and checksum.
+ */
+static void writeChunk(ostream &out, const char* type, const char* data,
+        const size_t length) {
+    char bytes[4];
+    crc_32_type crc;
+    crc.process_bytes(type, 4);
+    crc.process_bytes(data, length);
+    encode(bytes, static_cast<uint32_t>(length));
+    out.write(bytes, 4);
+    out.write(type, 4);
+    out.write(data, length);
+    encode(bytes, crc.checksum());
+    out.write(bytes, 4);
+}
+
+/**
+ * @brief Sink of the compressed pixels, which wraps them in PNG data
+ *     chunks as they come.
+ */
+class ChunkSink {
+    public:
+        typedef char char_type;
+        typedef iostreams::sink_tag category;
+        ChunkSink(ostream &out) : theOut(&out) {
+        }
+        streamsize write(const char* data, const streamsize length) {
+            writeChunk(*theOut, "IDAT", data, length);
+            return length;
+        }
+    private:
+        ostream *theOut;
+};
+
+RasterWriter::RasterWriter(const unsigned int size, const Format format,
+        const unsigned int numThreads) {
+    theSize = max(size, 1u);
+    theFormat = format;
+    theNumThreads = max(numThreads, 1u);
+}
+
+void RasterWriter::write(const Segments &segs, ostream &out) const {
+    Frame image = frame(segs);
+    Bins bins;
+    vector<uint8_t> bands[2];
+    vector<char> pixel;
+    char header[13];
+    iostreams::filtering_ostream png;
+    unsigned int band, row, rows, column;
+    size_t tile;
+    bin(segs, image, bins);
+    if (theFormat == PPM) {
+        out << "P6\n" << image.width << " " << image.height << "\n255\n";
+        pixel.resize(3*image.width);
+    } else {
+        out.write("\x89PNG\r\n\x1a\n", 8);
+        // Eight-bit greyscale, no interlace
+        encode(header, image.width);
+        encode(header + 4, image.height);
+        header[8] = 8;
+        header[9] = 0;
+        header[10] = header[11] = header[12] = 0;
+        writeChunk(out, "IHDR", header, 13);
+        png.push(iostreams::zlib_compressor(
+            iostreams::zlib::best_speed, CHUNK_SIZE));
+        png.push(ChunkSink(out), CHUNK_SIZE);
+        // Rows are stored without a filter
+        pixel.assign(1, 0);
+    }
+    bands[0].resize(static_cast<size_t>(image.width)*TILE);
+    bands[1].resize(static_cast<size_t>(image.width)*TILE);
+    ThreadPool pool(theNumThreads);
+    // A band is drawn while the previous one is written
+    for (band = 0; band <= bins.rows; band++) {
+        if (band < bins.rows) {
+            uint8_t* pixels = bands[band % 2].data();
+            memset(pixels, 0, bands[band % 2].size());
+            for (column = 0; column < bins.columns; column++) {
+                tile = static_cast<size_t>(band)*bins.columns + column;
+                pool.submit([this, &segs, &image, &bins, tile, pixels]() {
+                    draw(segs, image, bins, tile, pixels);
+                });
+            }
+        }
+        if (band > 0) {
+            const uint8_t* pixels = bands[(band - 1) % 2].data();
+            rows = min(TILE, image.height - (band - 1)*TILE);
+            for (row = 0; row < rows; row++) {
+                const uint8_t* line = pixels +
+                    static_cast<size_t>(row)*image.width;
+                if (theFormat == PPM) {
+                    for (column = 0; column < image.width; column++) {
+                        pixel[3*column] = pixel[3*column + 1] =
+                            pixel[3*column + 2] = line[column];
+                    }
+                    out.write(pixel.data(), pixel.size());
+                } else {
+                    png.write(pixel.data(), 1);
+                    png.write(reinterpret_cast<const char*>(line),
+                        image.width);
+                }
+            }
+        }
+        pool.wait();
+    }
+    if (theFormat == PNG) {
+        // Flush the compressor before the end of the image
+        png.reset();
+        writeChunk(out, "IEND", header, 0);
+    }
+}
+
+RasterWriter::Frame RasterWriter::frame(const Segments &segs) const {
+    const vector<double> &x0 = segs.getX0();
+    const vector<double> &y0 = segs.getY0();
+    const vector<double> &x1 = segs.getX1();
+    const vector<double> &y1 = segs.getY1();
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    double width, height, margin;
+    size_t seg;
+    Frame image;
+    // Same view box as the SVG document
+    if (segs.size() > 0) {
+        minX = maxX = x0[0];
+        minY = maxY = y0[0];
+    }
+    for (seg = 0; seg < segs.size(); seg++) {
+        minX = min(minX, min(x0[seg], x1[seg]));
+        maxX = max(maxX, max(x0[seg], x1[seg]));
+        minY = min(minY, min(y0[seg], y1[seg]));
+        maxY = max(maxY, max(y0[seg], y1[seg]));
+    }
+    margin = 0.02*max(max(maxX - minX, maxY - minY), 1.0);
+    width = maxX - minX + 2*margin;
+    height = maxY - minY + 2*margin;
+    image.scale = theSize/max(width, height);
+    image.width = max(1u, static_cast<unsigned int>(lround(width*
+        image.scale)));
+    image.height = max(1u, static_cast<unsigned int>(lround(height*
+        image.scale)));
+    image.left = minX - margin;
+    image.top = maxY + margin;
+    return image;
+}
+
+/**
+ * @brief Pixel of a coordinate, within the image.
+ */
+static inline long pixelOf(const double coord, const unsigned int limit) {
+    return min(max(static_cast<long>(floor(coord)), 0L),
+        static_cast<long>(limit) - 1);
+}
+
+/**
+ * @brief Pixels lit by a segment: one for every pixel along its major
+ *     axis, at the minor coordinate of the pixel centre, so a pixel is lit
+ *     the same whichever tile draws it.
+ */
+struct Scan {
+    /**
+     * @brief Scan constructor.
+     */
+    Scan(double ax, double ay, double bx, double by,
+            const unsigned int width, const unsigned int height) {
+        steep = !(fabs(bx - ax) >= fabs(by - ay));
+        if (steep) {
+            swap(ax, ay);
+            swap(bx, by);
+        }
+        if (ax > bx) {
+            swap(ax, bx);
+            swap(ay, by);
+        }
+        start = ax;
+        end = bx;
+        from = ay;
+        slope = bx > ax ? (by - ay)/(bx - ax) : 0;
+        limit = steep ? width : height;
+        first = pixelOf(ax, steep ? height : width);
+        last = pixelOf(bx, steep ? height : width);
+    }
+    /**
+     * @brief Pixel along the minor axis, which never goes back along the
+     *     major one.
+     */
+    long minor(const long major) const {
+        return pixelOf(from + (min(max(major + 0.5, start), end) - start)*
+            slope, limit);
+    }
+    bool steep;
+    double start, end, from, slope;
+    unsigned int limit;
+    long first, last;
+};
+
+void RasterWriter::bin(const Segments &segs, const Frame &image,
+        Bins &bins) const {
+    const vector<double> &x0 = segs.getX0();
+    const vector<double> &y0 = segs.getY0();
+    const vector<double> &x1 = segs.getX1();
+    const vector<double> &y1 = segs.getY1();
+    size_t seg, tile;
+    unsigned int pass;
+    long step, across, first, last;
+    bins.columns = (image.width + TILE - 1)/TILE;
+    bins.rows = (image.height + TILE - 1)/TILE;
+    bins.first.assign(static_cast<size_t>(bins.columns)*bins.rows + 1, 0);
+    // Count the segments of every tile, then place them
+    for (pass = 0; pass < 2; pass++) {
+        for (seg = 0; seg < segs.size(); seg++) {
+            Scan line((x0[seg] - image.left)*image.scale,
+                (image.top - y0[seg])*image.scale,
+                (x1[seg] - image.left)*image.scale,
+                (image.top - y1[seg])*image.scale, image.width,
+                image.height);
+            // Tile by tile along the major axis, where the pixels lit
+            // span the tiles between those of the first and the last one
+            for (step = line.first/TILE; step <= line.last/TILE; step++) {
+                first = line.minor(max(line.first, step*TILE))/TILE;
+                last = line.minor(min(line.last, (step + 1)*TILE - 1))/TILE;
+                if (first > last) {
+                    swap(first, last);
+                }
+                for (across = first; across <= last; across++) {
+                    tile = line.steep ?
+                        static_cast<size_t>(step)*bins.columns + across :
+                        static_cast<size_t>(across)*bins.columns + step;
+                    if (pass == 0) {
+                        bins.first[tile + 1]++;
+                    } else {
+                        bins.indices[bins.first[tile]++] =
+                            static_cast<uint32_t>(seg);
+                    }
+                }
+            }
+        }
+        if (pass == 0) {
+            for (tile = 1; tile < bins.first.size(); tile++) {
+                bins.first[tile] += bins.first[tile - 1];
+            }
+            bins.indices.resize(bins.first.back());
+        } else {
+            // Placing moved every start to the next tile
+            for (tile = bins.first.size() - 1; tile > 0; tile--) {
+                bins.first[tile] = bins.first[tile - 1];
+            }
+            bins.first[0] = 0;
+        }
+    }
+}
+
+void RasterWriter::draw(const Segments &segs, const Frame &image,
+        const Bins &bins, const size_t tile, uint8_t* band) const {
+    const vector<double> &x0 = segs.getX0();
+    const vector<double> &y0 = segs.getY0();
+    const vector<double> &x1 = segs.getX1();
+    const vector<double> &y1 = segs.getY1();
+    const long tileLeft = (tile % bins.columns)*TILE;
+    const long tileTop = (tile/bins.columns)*TILE;
+    const long tileRight = min(tileLeft + TILE,
+        static_cast<long>(image.width));
+    const long tileBottom = min(tileTop + TILE,
+        static_cast<long>(image.height));
+    long major, first, last, other;
+    size_t index, seg;
+    for (index = bins.first[tile]; index < bins.first[tile + 1]; index++) {
+        seg = bins.indices[index];
+        Scan line((x0[seg] - image.left)*image.scale,
+            (image.top - y0[seg])*image.scale,
+            (x1[seg] - image.left)*image.scale,
+            (image.top - y1[seg])*image.scale, image.width, image.height);
+        if (!line.steep) {
+            first = max(line.first, tileLeft);
+            last = min(line.last, tileRight - 1);
+            for (major = first; major <= last; major++) {
+                other = line.minor(major);
+                if ((other >= tileTop) && (other < tileBottom)) {
+                    band[(other - tileTop)*image.width + major] = 255;
+                }
+            }
+        } else {
+            first = max(line.first, tileTop);
+            last = min(line.last, tileBottom - 1);
+            for (major = first; major <= last; major++) {
+                other = line.minor(major);
+                if ((other >= tileLeft) && (other < tileRight)) {
+                    band[(major - tileTop)*image.width + other] = 255;
+                }
+            }
+        }
+    }
+}
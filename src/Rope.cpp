@@ -0,0 +1,131 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Rope.cpp                                                    |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Rope.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Longest node stored flat, which trades some memory for
+ *     fewer levels to walk.
+ */
+static const unsigned long long FLAT_SIZE = 1024;
+
+Rope::Rope() {
+    Node node;
+    int symbol;
+    node.length = 1;
+    node.first = 0;
+    node.count = 0;
+    for (symbol = 0; symbol < 256; symbol++) {
+        node.offset = symbol;
+        theNodes.push_back(node);
+        thePool += static_cast<char>(symbol);
+    }
+    // The empty production
+    node.length = 0;
+    node.offset = 0;
+    theNodes.push_back(node);
+    theRoot = 256;
+}
+
+size_t Rope::symbol(const char symbol) const {
+    return static_cast<unsigned char>(symbol);
+}
+
+size_t Rope::concatenate(const size_t* parts, const size_t count) {
+    Node node;
+    size_t part;
+    node.length = 0;
+    for (part = 0; part < count; part++) {
+        node.length += theNodes[parts[part]].length;
+    }
+    if (node.length <= FLAT_SIZE) {
+        // Short parts are flat themselves
+        node.first = 0;
+        node.count = 0;
+        node.offset = thePool.size();
+        for (part = 0; part < count; part++) {
+            const Node &flat = theNodes[parts[part]];
+            thePool.append(thePool, flat.offset, flat.length);
+        }
+    } else {
+        node.first = theParts.size();
+        node.count = count;
+        node.offset = 0;
+        node.length = 0;
+        for (part = 0; part < count; part++) {
+            theParts.push_back(parts[part]);
+            theOffsets.push_back(node.length);
+            node.length += theNodes[parts[part]].length;
+        }
+    }
+    theNodes.push_back(node);
+    return theNodes.size() - 1;
+}
+
+void Rope::setRoot(const size_t node) {
+    theRoot = node;
+}
+
+unsigned long long Rope::length() const {
+    return theNodes[theRoot].length;
+}
+
+char Rope::at(const unsigned long long position) const {
+    const Node* node = &theNodes[theRoot];
+    unsigned long long offset = position;
+    size_t part;
+    while (node->count > 0) {
+        // Last part that starts at or before the offset
+        part = upper_bound(theOffsets.begin() + node->first,
+            theOffsets.begin() + node->first + node->count, offset) -
+            theOffsets.begin() - 1;
+        offset -= theOffsets[part];
+        node = &theNodes[theParts[part]];
+    }
+    return thePool[node->offset + offset];
+}
+
+size_t Rope::getNodes() const {
+    return theNodes.size();
+}
+
+size_t Rope::getFootprint() const {
+    return theNodes.size()*sizeof(Node) + theParts.size()*sizeof(size_t) +
+        theOffsets.size()*sizeof(unsigned long long) + thePool.size();
+}
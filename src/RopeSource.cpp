@@ -0,0 +1,76 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : RopeSource.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "RopeSource.hpp"
+#include "Rope.hpp"
+#include <vector>
+#include <cstring>
+
+using namespace std;
+
+RopeSource::RopeSource(const Rope &rope) : theRope(rope) {
+    Frame root;
+    root.node = rope.theRoot;
+    root.next = 0;
+    theStack.push_back(root);
+}
+
+size_t RopeSource::read(char* buffer, const size_t size) {
+    size_t count = 0;
+    size_t chunk;
+    Frame part;
+    while ((count < size) && !theStack.empty()) {
+        Frame &top = theStack.back();
+        const Rope::Node &node = theRope.theNodes[top.node];
+        if ((node.count == 0) && (top.next < node.length)) {
+            // Flat node: copy as much as fits
+            chunk = node.length - top.next;
+            if (chunk > size - count) {
+                chunk = size - count;
+            }
+            memcpy(buffer + count, theRope.thePool.data() + node.offset +
+                top.next, chunk);
+            top.next += chunk;
+            count += chunk;
+        } else if ((node.count == 0) || (top.next == node.count)) {
+            theStack.pop_back();
+        } else {
+            part.node = theRope.theParts[node.first + top.next];
+            part.next = 0;
+            top.next++;
+            theStack.push_back(part);
+        }
+    }
+    return count;
+}
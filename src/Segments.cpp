@@ -0,0 +1,115 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Segments.cpp                                                |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Segments.hpp"
+#include <vector>
+
+using namespace std;
+
+Segments::Segments() {
+}
+
+void Segments::add(const double x0, const double y0, const double x1,
+        const double y1) {
+    theX0.push_back(x0);
+    theY0.push_back(y0);
+    theX1.push_back(x1);
+    theY1.push_back(y1);
+}
+
+size_t Segments::extend(const size_t count) {
+    size_t first = theX0.size();
+    theX0.resize(first + count);
+    theY0.resize(first + count);
+    theX1.resize(first + count);
+    theY1.resize(first + count);
+    return first;
+}
+
+void Segments::reserve(const size_t count) {
+    theX0.reserve(count);
+    theY0.reserve(count);
+    theX1.reserve(count);
+    theY1.reserve(count);
+}
+
+void Segments::truncate(const size_t count) {
+    theX0.resize(count);
+    theY0.resize(count);
+    theX1.resize(count);
+    theY1.resize(count);
+}
+
+void Segments::clear() {
+    theX0.clear();
+    theY0.clear();
+    theX1.clear();
+    theY1.clear();
+}
+
+size_t Segments::size() const {
+    return theX0.size();
+}
+
+const vector<double>& Segments::getX0() const {
+    return theX0;
+}
+
+const vector<double>& Segments::getY0() const {
+    return theY0;
+}
+
+const vector<double>& Segments::getX1() const {
+    return theX1;
+}
+
+const vector<double>& Segments::getY1() const {
+    return theY1;
+}
+
+double* Segments::dataX0() {
+    return &theX0[0];
+}
+
+double* Segments::dataY0() {
+    return &theY0[0];
+}
+
+double* Segments::dataX1() {
+    return &theX1[0];
+}
+
+double* Segments::dataY1() {
+    return &theY1[0];
+}
@@ -0,0 +1,186 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : Simplifier.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "Simplifier.hpp"
+#include "Segments.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Snap a coordinate to the grid.
+ */
+static inline int64_t snap(const double coord, const double quantum) {
+    return llround(coord/quantum);
+}
+
+/**
+ * @brief Hash of a segment snapped to the grid, whatever its direction.
+ */
+static uint64_t hashOf(const int64_t* key) {
+    uint64_t hash = 0x9e3779b97f4a7c15ULL;
+    int coord;
+    for (coord = 0; coord < 4; coord++) {
+        hash = (hash ^ static_cast<uint64_t>(key[coord]))*
+            0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+/**
+ * @brief Snapped end points of a segment, the lowest one first.
+ */
+static void keyOf(const Segments &segs, const size_t seg,
+        const double quantum, int64_t* key) {
+    key[0] = snap(segs.getX0()[seg], quantum);
+    key[1] = snap(segs.getY0()[seg], quantum);
+    key[2] = snap(segs.getX1()[seg], quantum);
+    key[3] = snap(segs.getY1()[seg], quantum);
+    if ((key[2] < key[0]) || ((key[2] == key[0]) && (key[3] < key[1]))) {
+        swap(key[0], key[2]);
+        swap(key[1], key[3]);
+    }
+}
+
+Simplifier::Simplifier(const double tolerance) {
+    theTolerance = tolerance;
+}
+
+void Simplifier::simplify(Segments &segs) const {
+    const vector<double> &x0 = segs.getX0();
+    const vector<double> &y0 = segs.getY0();
+    const vector<double> &x1 = segs.getX1();
+    const vector<double> &y1 = segs.getY1();
+    double minX = 0, minY = 0, maxX = 0, maxY = 0, quantum;
+    size_t seg;
+    if (segs.size() > 0) {
+        minX = maxX = x0[0];
+        minY = maxY = y0[0];
+    }
+    for (seg = 0; seg < segs.size(); seg++) {
+        minX = min(minX, min(x0[seg], x1[seg]));
+        maxX = max(maxX, max(x0[seg], x1[seg]));
+        minY = min(minY, min(y0[seg], y1[seg]));
+        maxY = max(maxY, max(y0[seg], y1[seg]));
+    }
+    quantum = theTolerance*max(max(maxX - minX, maxY - minY), 1e-300);
+    if (segs.size() > 0) {
+        deduplicate(segs, quantum);
+        merge(segs, quantum);
+        // Retraced runs are only equal once merged
+        deduplicate(segs, quantum);
+    }
+}
+
+void Simplifier::deduplicate(Segments &segs, const double quantum) const {
+    double* x0 = segs.dataX0();
+    double* y0 = segs.dataY0();
+    double* x1 = segs.dataX1();
+    double* y1 = segs.dataY1();
+    // Open addressing, at most half full, of kept segments plus one
+    size_t numSlots = 2, mask, slot, seg, kept = 0;
+    vector<uint32_t> slots;
+    vector<uint64_t> hashes;
+    int64_t key[4], other[4];
+    uint64_t hash;
+    bool found;
+    while (numSlots < 2*segs.size()) {
+        numSlots *= 2;
+    }
+    mask = numSlots - 1;
+    slots.assign(numSlots, 0);
+    hashes.resize(numSlots);
+    for (seg = 0; seg < segs.size(); seg++) {
+        keyOf(segs, seg, quantum, key);
+        hash = hashOf(key);
+        slot = hash & mask;
+        found = false;
+        while (!found && (slots[slot] != 0)) {
+            if (hashes[slot] == hash) {
+                keyOf(segs, slots[slot] - 1, quantum, other);
+                found = equal(key, key + 4, other);
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (!found) {
+            // Kept segments are packed at the front, in drawing order
+            x0[kept] = x0[seg];
+            y0[kept] = y0[seg];
+            x1[kept] = x1[seg];
+            y1[kept] = y1[seg];
+            slots[slot] = static_cast<uint32_t>(kept + 1);
+            hashes[slot] = hash;
+            kept++;
+        }
+    }
+    segs.truncate(kept);
+}
+
+void Simplifier::merge(Segments &segs, const double quantum) const {
+    double* x0 = segs.dataX0();
+    double* y0 = segs.dataY0();
+    double* x1 = segs.dataX1();
+    double* y1 = segs.dataY1();
+    double runX, runY, stepX, stepY, cross, dot;
+    size_t seg, last = 0;
+    bool joined;
+    for (seg = 1; seg < segs.size(); seg++) {
+        runX = x1[last] - x0[last];
+        runY = y1[last] - y0[last];
+        stepX = x1[seg] - x0[seg];
+        stepY = y1[seg] - y0[seg];
+        cross = runX*stepY - runY*stepX;
+        dot = runX*stepX + runY*stepY;
+        // Continues the run, in its direction
+        joined = (snap(x0[seg], quantum) == snap(x1[last], quantum)) &&
+            (snap(y0[seg], quantum) == snap(y1[last], quantum)) &&
+            (dot > 0) && (fabs(cross) <= theTolerance*
+            hypot(runX, runY)*hypot(stepX, stepY));
+        if (joined) {
+            x1[last] = x1[seg];
+            y1[last] = y1[seg];
+        } else {
+            last++;
+            x0[last] = x0[seg];
+            y0[last] = y0[seg];
+            x1[last] = x1[seg];
+            y1[last] = y1[seg];
+        }
+    }
+    segs.truncate(last + 1);
+}
@@ -0,0 +1,87 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : SvgWriter.cpp                                               |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "SvgWriter.hpp"
+#include "Segments.hpp"
+#include <vector>
+#include <ostream>
+#include <algorithm>
+
+using namespace std;
+
+SvgWriter::SvgWriter() {
+}
+
+void SvgWriter::write(const Segments &segs, ostream &out) const {
+    const vector<double> &x0 = segs.getX0();
+    const vector<double> &y0 = segs.getY0();
+    const vector<double> &x1 = segs.getX1();
+    const vector<double> &y1 = segs.getY1();
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    double width, height, margin;
+    size_t seg;
+    // View box of the drawing
+    if (segs.size() > 0) {
+        minX = maxX = x0[0];
+        minY = maxY = y0[0];
+    }
+    for (seg = 0; seg < segs.size(); seg++) {
+        minX = min(minX, min(x0[seg], x1[seg]));
+        maxX = max(maxX, max(x0[seg], x1[seg]));
+        minY = min(minY, min(y0[seg], y1[seg]));
+        maxY = max(maxY, max(y0[seg], y1[seg]));
+    }
+    width = maxX - minX;
+    height = maxY - minY;
+    margin = 0.02*max(max(width, height), 1.0);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out << "<!-- SVG automatically generated by L-system -->\n";
+    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"" <<
+        minX - margin << " " << -maxY - margin << " " <<
+        width + 2*margin << " " << height + 2*margin << "\">\n";
+    out << "<rect x=\"" << minX - margin << "\" y=\"" << -maxY - margin <<
+        "\" width=\"" << width + 2*margin << "\" height=\"" <<
+        height + 2*margin << "\" fill=\"black\"/>\n";
+    out << "<path fill=\"none\" stroke=\"white\" stroke-width=\"" <<
+        margin/10 << "\" d=\"";
+    // Ordinates are flipped, SVG points down
+    for (seg = 0; seg < segs.size(); seg++) {
+        if ((seg == 0) || (x0[seg] != x1[seg - 1]) ||
+                (y0[seg] != y1[seg - 1])) {
+            out << "M" << x0[seg] << " " << -y0[seg];
+        }
+        out << "L" << x1[seg] << " " << -y1[seg];
+    }
+    out << "\"/>\n</svg>\n";
+}
@@ -0,0 +1,140 @@
+/*
+                                                          _
+                                                        _(_)_       _
+     _                             _                   (_)@(_)    _(_)_
+    | |              ___ _   _ ___| |_ ___ _ __ ___      (_)\    (_)@(_)
+    | |      _____  / __| | | / __| __/ _ \ '_ ` _ \        |     /(_)
+    | |___  |_____| \__ \ |_| \__ \ ||  __/ | | | | |      \|/   \|/
+    |_____|         |___/\__, |___/\__\___|_| |_| |_|    \\\|//\\\|///
+ ________________________ |___/ ________________________________________
+|                                                                      |\
+|                                                                      |_\
+|   File    : ThreadPool.cpp                                              |
+|   Created : 18-Oct-2026                                                 |
+|   By      : atrilla                                                     |
+|                                                                         |
+|   L-system - Parallel string rewriting system                           |
+|                                                                         |
+|   Copyright (c) 2011 Alexandre Trilla                                   |
+|                                                                         |
+|   -------------------------------------------------------------------   |
+|                                                                         |
+|   This file is part of L-system.                                        |
+|                                                                         |
+|   L-system is free software: you can redistribute it and/or modify it   |
+|   under the terms of the MIT/X11 License as published by the            |
+|   Massachusetts Institute of Technology. See the MIT/X11 License for    |
+|   more details.                                                         |
+|                                                                         |
+|   You should have received a copy of the MIT/X11 License along with     |
+|   this source code distribution of L-system (see the COPYING            |
+|   file in the root directory). If not, see                              |
+|   <http://www.opensource.org/licenses/mit-license>.                     |
+|________________________________________________________________________*/
+
+#include "ThreadPool.hpp"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+ThreadPool::ThreadPool(const unsigned int numThreads) {
+    unsigned int worker;
+    theQueued = 0;
+    thePending = 0;
+    theNext = 0;
+    theStop = false;
+    for (worker = 0; (worker == 0) || (worker < numThreads); worker++) {
+        theQueues.push_back(new Queue);
+    }
+    for (worker = 0; worker < theQueues.size(); worker++) {
+        theWorkers.push_back(thread(&ThreadPool::work, this, worker));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    unsigned int worker;
+    wait();
+    {
+        lock_guard<mutex> guard(theLock);
+        theStop = true;
+    }
+    theWake.notify_all();
+    for (worker = 0; worker < theWorkers.size(); worker++) {
+        theWorkers[worker].join();
+        delete theQueues[worker];
+    }
+}
+
+void ThreadPool::submit(const function<void()> &task) {
+    Queue* queue;
+    {
+        lock_guard<mutex> guard(theLock);
+        queue = theQueues[theNext];
+        theNext = (theNext + 1)%theQueues.size();
+        // Counted before it is queued, so a worker that looks for it in
+        // between just looks again
+        thePending++;
+        theQueued++;
+    }
+    {
+        lock_guard<mutex> guard(queue->lock);
+        queue->tasks.push_back(task);
+    }
+    theWake.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(theLock);
+    theDone.wait(guard, [this]() { return thePending == 0; });
+}
+
+bool ThreadPool::take(const unsigned int worker, function<void()> &task) {
+    unsigned int victim;
+    bool found = false;
+    // Own queue newest first, then steal the oldest of the others
+    for (victim = 0; !found && (victim < theQueues.size()); victim++) {
+        Queue* queue = theQueues[(worker + victim)%theQueues.size()];
+        lock_guard<mutex> guard(queue->lock);
+        if (!queue->tasks.empty()) {
+            if (victim == 0) {
+                task = queue->tasks.back();
+                queue->tasks.pop_back();
+            } else {
+                task = queue->tasks.front();
+                queue->tasks.pop_front();
+            }
+            found = true;
+        }
+    }
+    if (found) {
+        lock_guard<mutex> guard(theLock);
+        theQueued--;
+    }
+    return found;
+}
+
+void ThreadPool::work(const unsigned int worker) {
+    function<void()> task;
+    bool running = true;
+    while (running) {
+        if (take(worker, task)) {
+            task();
+            lock_guard<mutex> guard(theLock);
+            thePending--;
+            if (thePending == 0) {
+                theDone.notify_all();
+            }
+        } else {
+            unique_lock<mutex> guard(theLock);
+            theWake.wait(guard, [this]() {
+                return theStop || (theQueued > 0);
+            });
+            running = !theStop || (theQueued > 0);
+        }
+    }
+}
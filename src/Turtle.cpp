@@ -33,23 +33,368 @@
 |________________________________________________________________________*/
 
 #include "Turtle.hpp"
+#include "SymbolSource.hpp"
+#include "StringSource.hpp"
+#include "Segments.hpp"
+#include "Extent.hpp"
+#include "Derivation.hpp"
 #include <string>
 #include <map>
 #include <vector>
+#include <ostream>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <charconv>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #include <boost/tokenizer.hpp>
 
 using namespace std;
 using namespace boost;
 
+/**
+ * @brief Number of symbols read from the source at once.
+ */
+static const size_t BLOCK_SIZE = 4096;
+
+/**
+ * @brief Size of the Logo code buffered before writing it out.
+ */
+static const size_t FLUSH_SIZE = 1 << 16;
+
+/**
+ * @brief Radians per degree.
+ */
+static const double DEG_TO_RAD = M_PI/180.0;
+
+/**
+ * @brief Number of symbols of every chunk of the parallel tracing.
+ */
+static const size_t TRACE_GRAIN = 16*BLOCK_SIZE;
+
+/**
+ * @brief Fixed-point units per drawing unit (2^64).
+ */
+static const double FIXED_ONE = 18446744073709551616.0;
+
+/**
+ * @brief Weight of the 53 leading fraction bits of a fixed-point value
+ *     (2^-53).
+ */
+static const double FRACTION_UNIT = 1.0/9007199254740992.0;
+
+/**
+ * @brief Fixed-point value of a number of drawing units, truncated.
+ */
+static inline __int128 toFixed(const double value) {
+    return static_cast<__int128>(value*FIXED_ONE);
+}
+
+/**
+ * @brief Drawing units of a fixed-point value, from its integer part and
+ *     the 53 leading bits of its fraction, both exact.
+ */
+static inline double toDouble(const __int128 value) {
+    return static_cast<double>(static_cast<long long>(value >> 64)) +
+        static_cast<double>(static_cast<long long>(
+        static_cast<unsigned long long>(value) >> 11))*FRACTION_UNIT;
+}
+
+/**
+ * @brief Remainder in [0, modulus).
+ */
+static int wrap(const int value, const int modulus) {
+    int rest = value%modulus;
+    return rest < 0 ? rest + modulus : rest;
+}
+
+/**
+ * @brief Run a task on every chunk, with the chunks handed out to the
+ *     threads in order (at least one thread, as the number of cores
+ *     may be unknown).
+ */
+static void parallelChunks(const size_t numChunks,
+        const unsigned int numThreads,
+        const function<void(size_t)> &task) {
+    atomic<size_t> next(0);
+    vector<thread> workers;
+    unsigned int worker;
+    for (worker = 0; (worker == 0) ||
+            ((worker < numThreads) && (worker < numChunks)); worker++) {
+        workers.push_back(thread([&]() {
+            size_t chunk;
+            while ((chunk = next++) < numChunks) {
+                task(chunk);
+            }
+        }));
+    }
+    for (worker = 0; worker < workers.size(); worker++) {
+        workers[worker].join();
+    }
+}
+
+/**
+ * @brief Segments of a straight run: the k-th goes from the start point
+ *     moved offsets[k] along the heading, to the start point moved
+ *     offsets[k + 1].
+ */
+static void straightRun(const double x, const double y, const double dirX,
+        const double dirY, const double* offsets, const size_t count,
+        double* x0, double* y0, double* x1, double* y1) {
+    size_t seg = 0;
+#if defined(__AVX__)
+    __m256d posX = _mm256_set1_pd(x), posY = _mm256_set1_pd(y);
+    __m256d stepX = _mm256_set1_pd(dirX), stepY = _mm256_set1_pd(dirY);
+    __m256d start, end;
+    for (; seg + 4 <= count; seg += 4) {
+        start = _mm256_loadu_pd(offsets + seg);
+        end = _mm256_loadu_pd(offsets + seg + 1);
+#if defined(__FMA__)
+        _mm256_storeu_pd(x0 + seg, _mm256_fmadd_pd(stepX, start, posX));
+        _mm256_storeu_pd(y0 + seg, _mm256_fmadd_pd(stepY, start, posY));
+        _mm256_storeu_pd(x1 + seg, _mm256_fmadd_pd(stepX, end, posX));
+        _mm256_storeu_pd(y1 + seg, _mm256_fmadd_pd(stepY, end, posY));
+#else
+        _mm256_storeu_pd(x0 + seg,
+            _mm256_add_pd(posX, _mm256_mul_pd(stepX, start)));
+        _mm256_storeu_pd(y0 + seg,
+            _mm256_add_pd(posY, _mm256_mul_pd(stepY, start)));
+        _mm256_storeu_pd(x1 + seg,
+            _mm256_add_pd(posX, _mm256_mul_pd(stepX, end)));
+        _mm256_storeu_pd(y1 + seg,
+            _mm256_add_pd(posY, _mm256_mul_pd(stepY, end)));
+#endif
+    }
+#elif defined(__SSE2__)
+    __m128d posX = _mm_set1_pd(x), posY = _mm_set1_pd(y);
+    __m128d stepX = _mm_set1_pd(dirX), stepY = _mm_set1_pd(dirY);
+    __m128d start, end;
+    for (; seg + 2 <= count; seg += 2) {
+        start = _mm_loadu_pd(offsets + seg);
+        end = _mm_loadu_pd(offsets + seg + 1);
+        _mm_storeu_pd(x0 + seg, _mm_add_pd(posX, _mm_mul_pd(stepX, start)));
+        _mm_storeu_pd(y0 + seg, _mm_add_pd(posY, _mm_mul_pd(stepY, start)));
+        _mm_storeu_pd(x1 + seg, _mm_add_pd(posX, _mm_mul_pd(stepX, end)));
+        _mm_storeu_pd(y1 + seg, _mm_add_pd(posY, _mm_mul_pd(stepY, end)));
+    }
+#endif
+    // Scalar fallback, and the remainder of the vectorised loops
+    for (; seg < count; seg++) {
+        x0[seg] = x + dirX*offsets[seg];
+        y0[seg] = y + dirY*offsets[seg];
+        x1[seg] = x + dirX*offsets[seg + 1];
+        y1[seg] = y + dirY*offsets[seg + 1];
+    }
+}
+
+/**
+ * @brief Shortest text of a number that reads back the same.
+ */
+static string format(const double value) {
+    char text[32];
+    to_chars_result result = to_chars(text, text + sizeof(text), value);
+    return string(text, result.ptr);
+}
+
 Turtle::Turtle() {
+    int symbol;
     starterLogoCode = "; Logo code automatically generated by L-system\n";
     starterLogoCode += "\nmake \"stackPOS []\nmake \"stackANG []\nsetpencolor 7\nsetbackground 0\n";
+    for (symbol = 0; symbol < 256; symbol++) {
+        thePrograms[symbol].first = 0;
+        thePrograms[symbol].count = 0;
+        theStraight[symbol] = false;
+    }
+    theAngleStep = 360;
+}
+
+Turtle::Turtle(const map<char, string> &corresp) : Turtle() {
+    map<char, string>::const_iterator corrIter;
+    for (corrIter = corresp.begin(); corrIter != corresp.end();
+            corrIter++) {
+        compile((*corrIter).first, (*corrIter).second);
+    }
+    discretise();
+}
+
+void Turtle::compile(const char symbol, const string &instros) {
+    Program &program = thePrograms[static_cast<unsigned char>(symbol)];
+    // Signed and fractional operands are kept whole
+    char_separator<char> blanks(" \t,");
+    tokenizer<char_separator<char> > tok(instros, blanks);
+    tokenizer<char_separator<char> >::iterator expToken, operand;
+    double angle;
+    int opcode;
+    program.first = theCode.size();
+    for (expToken = tok.begin(); expToken != tok.end(); expToken++) {
+        opcode = -1;
+        if (!(*expToken).compare("drawForward")) {
+            opcode = DRAW_FORWARD;
+        } else if (!(*expToken).compare("pushPos")) {
+            opcode = PUSH_POS;
+        } else if (!(*expToken).compare("pushAng")) {
+            opcode = PUSH_ANG;
+        } else if (!(*expToken).compare("turnLeft")) {
+            opcode = TURN_LEFT;
+        } else if (!(*expToken).compare("turnRight")) {
+            opcode = TURN_RIGHT;
+        } else if (!(*expToken).compare("popPos")) {
+            opcode = POP_POS;
+        } else if (!(*expToken).compare("popAng")) {
+            opcode = POP_ANG;
+        } else if (!(*expToken).compare("pitchDown")) {
+            opcode = PITCH_DOWN;
+        } else if (!(*expToken).compare("pitchUp")) {
+            opcode = PITCH_UP;
+        } else if (!(*expToken).compare("rollLeft")) {
+            opcode = ROLL_LEFT;
+        } else if (!(*expToken).compare("rollRight")) {
+            opcode = ROLL_RIGHT;
+        } else if (!(*expToken).compare("turnAround")) {
+            // A half turn, on the plane as well
+            opcode = TURN_RIGHT;
+        }
+        if (opcode >= 0) {
+            theCode.push_back(opcode);
+            theOperands.push_back(0);
+            theTexts.push_back("0");
+            // Moves and rotations take a numeric operand
+            if (!(*expToken).compare("turnAround")) {
+                theOperands.back() = 180;
+                theTexts.back() = "180";
+            } else if ((opcode != PUSH_POS) && (opcode != PUSH_ANG) &&
+                    (opcode != POP_POS) && (opcode != POP_ANG)) {
+                operand = expToken;
+                operand++;
+                if (operand != tok.end()) {
+                    expToken = operand;
+                    theOperands.back() = atof((*expToken).c_str());
+                    theTexts.back() = *expToken;
+                }
+            }
+            // Left, up and right-hand rolls are positive rotations
+            angle = 0;
+            if ((opcode == TURN_LEFT) || (opcode == PITCH_UP) ||
+                    (opcode == ROLL_RIGHT)) {
+                angle = theOperands.back()*DEG_TO_RAD;
+            } else if ((opcode == TURN_RIGHT) || (opcode == PITCH_DOWN) ||
+                    (opcode == ROLL_LEFT)) {
+                angle = -theOperands.back()*DEG_TO_RAD;
+            }
+            theCosines.push_back(cos(angle));
+            theSines.push_back(sin(angle));
+        }
+    }
+    program.count = theCode.size() - program.first;
+    theStraight[static_cast<unsigned char>(symbol)] = (program.count == 1) &&
+        (theCode[program.first] == DRAW_FORWARD);
+}
+
+void Turtle::discretise() {
+    unsigned int pc;
+    long angle, step = 360, rest;
+    bool discrete = true;
+    theTurnSteps.assign(theCode.size(), 0);
+    // Greatest common divisor of the full turn and all the turns
+    for (pc = 0; pc < theCode.size(); pc++) {
+        if ((theCode[pc] == TURN_LEFT) || (theCode[pc] == TURN_RIGHT)) {
+            angle = static_cast<long>(floor(theOperands[pc] + 0.5));
+            if (fabs(theOperands[pc] - angle) > 1e-9) {
+                discrete = false;
+            }
+            angle = labs(angle);
+            while (angle != 0) {
+                rest = step%angle;
+                step = angle;
+                angle = rest;
+            }
+        }
+    }
+    theAngleStep = 0;
+    if (discrete) {
+        theAngleStep = step;
+        for (pc = 0; pc < theCode.size(); pc++) {
+            angle = static_cast<long>(floor(theOperands[pc] + 0.5));
+            if (theCode[pc] == TURN_LEFT) {
+                theTurnSteps[pc] = -angle/step;
+            } else if (theCode[pc] == TURN_RIGHT) {
+                theTurnSteps[pc] = angle/step;
+            }
+        }
+    }
 }
 
-string Turtle::rewrite(const string prod, map<char, string> corresp,
-        string scale, vector<string> iniPos, string iniAng) const {
-    string expansion;
-    string::const_iterator charIt;
+void Turtle::rewrite(const string &prod, const string &scale,
+        const vector<string> &iniPos, const string &iniAng,
+        ostream &out) const {
+    StringSource source(prod);
+    rewrite(source, scale, iniPos, iniAng, out);
+}
+
+void Turtle::rewrite(SymbolSource &prod, const string &scale,
+        const vector<string> &iniPos, const string &iniAng,
+        ostream &out) const {
+    string snippets[256];
+    char block[BLOCK_SIZE];
+    size_t count, symbol;
+    string logoCode = preamble(iniPos, iniAng);
+    // Logo code of every program, once per symbol. Not all produced
+    // symbols have an associated graphical instro.
+    for (symbol = 0; symbol < 256; symbol++) {
+        snippets[symbol] = translate(symbol, scale);
+    }
+    // Drawing instructions
+    logoCode.reserve(FLUSH_SIZE + BLOCK_SIZE);
+    while ((count = prod.read(block, BLOCK_SIZE)) > 0) {
+        for (symbol = 0; symbol < count; symbol++) {
+            logoCode += snippets[static_cast<unsigned char>(block[symbol])];
+        }
+        if (logoCode.size() >= FLUSH_SIZE) {
+            out.write(logoCode.data(), logoCode.size());
+            logoCode.clear();
+        }
+    }
+    out.write(logoCode.data(), logoCode.size());
+}
+
+void Turtle::rewrite(const ParametricLsystem &lsys,
+        const ParametricLsystem::Modules &prod, const string &scale,
+        const vector<string> &iniPos, const string &iniAng,
+        ostream &out) const {
+    string snippets[256];
+    size_t position, param = 0;
+    unsigned int symbol, arity;
+    string logoCode = preamble(iniPos, iniAng);
+    for (symbol = 0; symbol < 256; symbol++) {
+        snippets[symbol] = translate(symbol, scale);
+    }
+    logoCode.reserve(FLUSH_SIZE + BLOCK_SIZE);
+    for (position = 0; position < prod.symbols.size(); position++) {
+        symbol = static_cast<unsigned char>(prod.symbols[position]);
+        arity = lsys.getArity(symbol);
+        if ((arity > 0) && (getDraws(symbol) > 0)) {
+            logoCode += translate(symbol, scale,
+                format(prod.params[param]));
+        } else {
+            logoCode += snippets[symbol];
+        }
+        param += arity;
+        if (logoCode.size() >= FLUSH_SIZE) {
+            out.write(logoCode.data(), logoCode.size());
+            logoCode.clear();
+        }
+    }
+    out.write(logoCode.data(), logoCode.size());
+}
+
+string Turtle::preamble(const vector<string> &iniPos,
+        const string &iniAng) const {
     string logoCode = starterLogoCode;
     // Initial setup
     logoCode += "hideturtle\n";
@@ -61,44 +406,645 @@ string Turtle::rewrite(const string prod, map<char, string> corresp,
     logoCode += "setheading ";
     logoCode += iniAng;
     logoCode += "\n";
-    // Drawing instructions
-    for (charIt = prod.begin(); charIt < prod.end(); charIt++) {
-        // Not all produced symbols have an associated graphical instro.
-        expansion += corresp[*charIt];
-        expansion += " "; // Just to ensure.
-    }
-    // Translation of the drawing instructions
-    tokenizer<> tok(expansion);
-    tokenizer<>::iterator expToken;
-    for (expToken = tok.begin(); expToken != tok.end(); expToken++) {
-        if (!(*expToken).compare("drawForward")) {
-            logoCode += "fd ";
-            expToken++;
-            // scaling
-            logoCode += *expToken;
-            logoCode += " / ";
-            logoCode += scale;
-            logoCode += "\n";
-        } else if (!(*expToken).compare("pushPos")) {
-            logoCode += "push \"stackPOS pos\n";
-        } else if (!(*expToken).compare("pushAng")) {
-            logoCode += "push \"stackANG heading\n";
-        } else if (!(*expToken).compare("turnLeft")) {
-            logoCode += "lt ";
-            expToken++;
-            logoCode += *expToken;
-            logoCode += "\n";
-        } else if (!(*expToken).compare("turnRight")) {
-            logoCode += "rt ";
-            expToken++;
-            logoCode += *expToken;
-            logoCode += "\n";
-        } else if (!(*expToken).compare("popPos")) {
-            logoCode += "pu setpos pop \"stackPOS pd\n";
-        } else if (!(*expToken).compare("popAng")) {
-            logoCode += "setheading pop \"stackANG\n";
+    return logoCode;
+}
+
+string Turtle::translate(const char symbol, const string &scale,
+        const string &length) const {
+    const Program &program =
+        thePrograms[static_cast<unsigned char>(symbol)];
+    ostringstream logoCode;
+    unsigned int pc;
+    for (pc = program.first; pc < program.first + program.count; pc++) {
+        switch (theCode[pc]) {
+            case DRAW_FORWARD:
+                // scaling
+                if (length.empty()) {
+                    logoCode << "fd " << theTexts[pc];
+                } else {
+                    logoCode << "fd " << length;
+                }
+                logoCode << " / " << scale << "\n";
+                break;
+            case PUSH_POS:
+                logoCode << "push \"stackPOS pos\n";
+                break;
+            case PUSH_ANG:
+                logoCode << "push \"stackANG heading\n";
+                break;
+            case TURN_LEFT:
+                logoCode << "lt " << theTexts[pc] << "\n";
+                break;
+            case TURN_RIGHT:
+                logoCode << "rt " << theTexts[pc] << "\n";
+                break;
+            case POP_POS:
+                logoCode << "pu setpos pop \"stackPOS pd\n";
+                break;
+            case POP_ANG:
+                logoCode << "setheading pop \"stackANG\n";
+                break;
         }
     }
-    return logoCode;
+    return logoCode.str();
+}
+
+void Turtle::trace(const string &prod, const double scale,
+        const double iniX, const double iniY, const double iniAng,
+        Segments &out) const {
+    StringSource source(prod);
+    trace(source, scale, iniX, iniY, iniAng, out);
+}
+
+void Turtle::trace(SymbolSource &prod, const double scale,
+        const double iniX, const double iniY, const double iniAng,
+        Segments &out) const {
+    char block[BLOCK_SIZE];
+    size_t count;
+    vector<Point> moves;
+    Pen pen;
+    setup(iniX, iniY, iniAng, scale, moves, pen);
+    while ((count = prod.read(block, BLOCK_SIZE)) > 0) {
+        draw(block, count, scale, pen, out);
+    }
+}
+
+void Turtle::trace(const string &prod, const double scale,
+        const double iniX, const double iniY, const double iniAng,
+        Segments &out, const unsigned int numThreads) const {
+    trace(prod.data(), prod.size(), scale, iniX, iniY, iniAng, out,
+        numThreads);
+}
+
+template <class T, class Add>
+T Turtle::settle(const Summary<T> &summary, const T &start,
+        vector<T> &stack, const Add &add) {
+    vector<T> popped;
+    size_t pop;
+    // Values relative to pops from below refer to earlier ones
+    popped.reserve(summary.below.size());
+    for (pop = 0; pop < summary.below.size(); pop++) {
+        if (!stack.empty()) {
+            popped.push_back(stack.back());
+            stack.pop_back();
+        } else {
+            popped.push_back(add(summary.below[pop].base < 0 ? start :
+                popped[summary.below[pop].base],
+                summary.below[pop].delta));
+        }
+    }
+    for (pop = 0; pop < summary.pushed.size(); pop++) {
+        stack.push_back(add(summary.pushed[pop].base < 0 ? start :
+            popped[summary.pushed[pop].base], summary.pushed[pop].delta));
+    }
+    return add(summary.last.base < 0 ? start :
+        popped[summary.last.base], summary.last.delta);
+}
+
+void Turtle::trace(const char* prod, const size_t size,
+        const double scale, const double iniX, const double iniY,
+        const double iniAng, Segments &out,
+        const unsigned int numThreads) const {
+    size_t numChunks = (size + TRACE_GRAIN - 1)/TRACE_GRAIN;
+    int numHeadings;
+    vector<Summary<int> > turns;
+    vector<Summary<Point> > shifts;
+    vector<Pen> starts;
+    vector<Segments> parts(numChunks);
+    vector<Point> moves;
+    vector<int> angStack;
+    vector<Point> posStack;
+    vector<size_t> offsets;
+    Pen pen;
+    size_t chunk, first;
+    setup(iniX, iniY, iniAng, scale, moves, pen);
+    numHeadings = pen.lutSin.size();
+    if ((numThreads > 1) && (numChunks > 1) && (numHeadings > 0)) {
+        // Turns of every chunk, relative to the state it starts with
+        turns.resize(numChunks);
+        parallelChunks(numChunks, numThreads, [&](size_t chunk) {
+            summarise(prod + chunk*TRACE_GRAIN,
+                min(TRACE_GRAIN, size - chunk*TRACE_GRAIN), numHeadings,
+                turns[chunk]);
+        });
+        starts.assign(numChunks, pen);
+        for (chunk = 1; chunk < numChunks; chunk++) {
+            starts[chunk].index = settle(turns[chunk - 1],
+                starts[chunk - 1].index, angStack,
+                [numHeadings](const int base, const int delta) {
+                    return wrap(base + delta, numHeadings);
+                });
+            starts[chunk].angStack.assign(angStack.begin(), angStack.end());
+            starts[chunk].dirX = pen.lutSin[starts[chunk].index];
+            starts[chunk].dirY = pen.lutCos[starts[chunk].index];
+        }
+        // Moves of every chunk, from the heading it starts with
+        shifts.resize(numChunks);
+        parallelChunks(numChunks, numThreads, [&](size_t chunk) {
+            Pen walker = starts[chunk];
+            summarise(prod + chunk*TRACE_GRAIN,
+                min(TRACE_GRAIN, size - chunk*TRACE_GRAIN), walker,
+                shifts[chunk]);
+        });
+        for (chunk = 1; chunk < numChunks; chunk++) {
+            starts[chunk].fixed = settle(shifts[chunk - 1],
+                starts[chunk - 1].fixed, posStack,
+                [](const Point &base, const Point &delta) {
+                    Point sum = {base.x + delta.x, base.y + delta.y};
+                    return sum;
+                });
+            starts[chunk].fixedStack = posStack;
+            starts[chunk].x = toDouble(starts[chunk].fixed.x);
+            starts[chunk].y = toDouble(starts[chunk].fixed.y);
+        }
+        // Exact positions: the chunks draw as the serial tracing does
+        parallelChunks(numChunks, numThreads, [&](size_t chunk) {
+            draw(prod + chunk*TRACE_GRAIN,
+                min(TRACE_GRAIN, size - chunk*TRACE_GRAIN), scale,
+                starts[chunk], parts[chunk]);
+        });
+        // Every chunk is copied to its place concurrently as well
+        offsets.push_back(out.size());
+        for (chunk = 0; chunk < numChunks; chunk++) {
+            offsets.push_back(offsets.back() + parts[chunk].size());
+        }
+        out.extend(offsets.back() - offsets.front());
+        parallelChunks(numChunks, numThreads, [&](size_t chunk) {
+            copy(parts[chunk].getX0().begin(), parts[chunk].getX0().end(),
+                out.dataX0() + offsets[chunk]);
+            copy(parts[chunk].getY0().begin(), parts[chunk].getY0().end(),
+                out.dataY0() + offsets[chunk]);
+            copy(parts[chunk].getX1().begin(), parts[chunk].getX1().end(),
+                out.dataX1() + offsets[chunk]);
+            copy(parts[chunk].getY1().begin(), parts[chunk].getY1().end(),
+                out.dataY1() + offsets[chunk]);
+            parts[chunk] = Segments();
+        });
+    } else {
+        // Serially, in blocks as read from a source
+        for (first = 0; first < size; first += BLOCK_SIZE) {
+            draw(prod + first, min(BLOCK_SIZE, size - first), scale, pen,
+                out);
+        }
+    }
+}
+
+void Turtle::trace(const ParametricLsystem &lsys,
+        const ParametricLsystem::Modules &prod, const double scale,
+        const double iniX, const double iniY, const double iniAng,
+        Segments &out) const {
+    size_t position, param = 0;
+    unsigned int pc, end, arity;
+    double length;
+    vector<Point> moves;
+    Pen pen;
+    setup(iniX, iniY, iniAng, scale, moves, pen);
+    for (position = 0; position < prod.symbols.size(); position++) {
+        const Program &program = thePrograms[
+            static_cast<unsigned char>(prod.symbols[position])];
+        arity = lsys.getArity(prod.symbols[position]);
+        end = program.first + program.count;
+        for (pc = program.first; pc < end; pc++) {
+            if (theCode[pc] == DRAW_FORWARD) {
+                // The first parameter, if any, is the length
+                length = (arity > 0 ? prod.params[param] :
+                    theOperands[pc])/scale;
+                if (pen.moves != NULL) {
+                    pen.fixed.x += toFixed(length*pen.dirX);
+                    pen.fixed.y += toFixed(length*pen.dirY);
+                    out.add(pen.x, pen.y, toDouble(pen.fixed.x),
+                        toDouble(pen.fixed.y));
+                } else {
+                    out.add(pen.x, pen.y, pen.x + length*pen.dirX,
+                        pen.y + length*pen.dirY);
+                }
+                pen.x = out.getX1().back();
+                pen.y = out.getY1().back();
+            } else {
+                steer(pc, pen);
+            }
+        }
+        param += arity;
+    }
+}
+
+bool Turtle::isParametric(const ParametricLsystem &lsys) const {
+    unsigned int symbol;
+    bool parametric = false;
+    for (symbol = 0; (symbol < 256) && !parametric; symbol++) {
+        parametric = (lsys.getArity(symbol) > 0) && (getDraws(symbol) > 0);
+    }
+    return parametric;
+}
+
+unsigned int Turtle::getDraws(const char symbol) const {
+    const Program &program =
+        thePrograms[static_cast<unsigned char>(symbol)];
+    unsigned int pc, draws = 0;
+    for (pc = program.first; pc < program.first + program.count; pc++) {
+        if (theCode[pc] == DRAW_FORWARD) {
+            draws++;
+        }
+    }
+    return draws;
+}
+
+unsigned long long Turtle::getDraws(SymbolSource &prod) const {
+    char block[BLOCK_SIZE];
+    unsigned int draws[256];
+    unsigned long long total = 0;
+    size_t count, position;
+    unsigned int symbol;
+    for (symbol = 0; symbol < 256; symbol++) {
+        draws[symbol] = getDraws(symbol);
+    }
+    while ((count = prod.read(block, BLOCK_SIZE)) > 0) {
+        for (position = 0; position < count; position++) {
+            total += draws[static_cast<unsigned char>(block[position])];
+        }
+    }
+    return total;
+}
+
+bool Turtle::fit(const Lsystem &lsys, const int numIter,
+        const double iniAng, const double size, double &scale, double &iniX,
+        double &iniY) const {
+    Extent extent(lsys, *this, numIter, iniAng);
+    if (extent.isEmpty()) {
+        return false;
+    }
+    extent.fit(size, scale, iniX, iniY);
+    return true;
+}
+
+void Turtle::trace(const Lsystem &lsys, const int numIter,
+        const double tolerance, const double scale, const double iniX,
+        const double iniY, const double iniAng, Segments &out) const {
+    if (Extent::isMemoisable(lsys, *this)) {
+        Extent(lsys, *this, numIter, iniAng).trace(tolerance, scale, iniX,
+            iniY, out);
+    } else {
+        // Without transforms every symbol is drawn
+        Derivation derivation(lsys, numIter);
+        trace(derivation, scale, iniX, iniY, iniAng, out);
+    }
 }
 
+/**
+ * @brief Rotate two directions of the orientation in their plane.
+ */
+static inline void rotate(double* first, double* second, const double c,
+        const double s) {
+    double component;
+    int axis;
+    for (axis = 0; axis < 3; axis++) {
+        component = first[axis];
+        first[axis] = component*c + second[axis]*s;
+        second[axis] = second[axis]*c - component*s;
+    }
+}
+
+void Turtle::trace(SymbolSource &prod, const double scale,
+        const double iniX, const double iniY, const double iniAng,
+        PlyWriter &out) const {
+    char block[BLOCK_SIZE];
+    size_t count, position;
+    unsigned int pc, end;
+    double step, x = iniX, y = iniY, z = 0;
+    // Heading, left and up directions, one after the other
+    double frame[9] = {sin(iniAng*DEG_TO_RAD), cos(iniAng*DEG_TO_RAD), 0,
+        -cos(iniAng*DEG_TO_RAD), sin(iniAng*DEG_TO_RAD), 0, 0, 0, 1};
+    double* heading = frame;
+    double* left = frame + 3;
+    double* up = frame + 6;
+    vector<double> posStack, angStack;
+    posStack.reserve(3*64);
+    angStack.reserve(9*64);
+    while ((count = prod.read(block, BLOCK_SIZE)) > 0) {
+        for (position = 0; position < count; position++) {
+            const Program &program =
+                thePrograms[static_cast<unsigned char>(block[position])];
+            end = program.first + program.count;
+            for (pc = program.first; pc < end; pc++) {
+                switch (theCode[pc]) {
+                    case DRAW_FORWARD:
+                        step = theOperands[pc]/scale;
+                        out.add(x, y, z, x + step*heading[0],
+                            y + step*heading[1], z + step*heading[2]);
+                        x += step*heading[0];
+                        y += step*heading[1];
+                        z += step*heading[2];
+                        break;
+                    case TURN_LEFT:
+                    case TURN_RIGHT:
+                        rotate(heading, left, theCosines[pc], theSines[pc]);
+                        break;
+                    case PITCH_DOWN:
+                    case PITCH_UP:
+                        rotate(heading, up, theCosines[pc], theSines[pc]);
+                        break;
+                    case ROLL_LEFT:
+                    case ROLL_RIGHT:
+                        rotate(left, up, theCosines[pc], theSines[pc]);
+                        break;
+                    case PUSH_POS:
+                        posStack.push_back(x);
+                        posStack.push_back(y);
+                        posStack.push_back(z);
+                        break;
+                    case POP_POS:
+                        // Unbalanced pops leave the turtle in place
+                        if (posStack.size() >= 3) {
+                            z = posStack.back();
+                            posStack.pop_back();
+                            y = posStack.back();
+                            posStack.pop_back();
+                            x = posStack.back();
+                            posStack.pop_back();
+                        }
+                        break;
+                    case PUSH_ANG:
+                        angStack.insert(angStack.end(), frame, frame + 9);
+                        break;
+                    case POP_ANG:
+                        if (angStack.size() >= 9) {
+                            copy(angStack.end() - 9, angStack.end(), frame);
+                            angStack.resize(angStack.size() - 9);
+                        }
+                        break;
+                }
+            }
+        }
+    }
+}
+
+void Turtle::setup(const double iniX, const double iniY,
+        const double iniAng, const double scale, vector<Point> &moves,
+        Pen &pen) const {
+    int numHeadings, index;
+    unsigned int pc;
+    Point move;
+    pen.x = iniX;
+    pen.y = iniY;
+    pen.heading = iniAng;
+    pen.index = 0;
+    pen.lutSin.clear();
+    pen.lutCos.clear();
+    moves.clear();
+    // Table of the reachable headings if the turns are discrete
+    if (theAngleStep > 0) {
+        numHeadings = static_cast<int>(floor(360/theAngleStep + 0.5));
+        pen.lutSin.reserve(numHeadings);
+        pen.lutCos.reserve(numHeadings);
+        moves.reserve(numHeadings*theCode.size());
+        for (index = 0; index < numHeadings; index++) {
+            pen.lutSin.push_back(sin((iniAng + index*theAngleStep)*
+                DEG_TO_RAD));
+            pen.lutCos.push_back(cos((iniAng + index*theAngleStep)*
+                DEG_TO_RAD));
+            for (pc = 0; pc < theCode.size(); pc++) {
+                move.x = 0;
+                move.y = 0;
+                if (theCode[pc] == DRAW_FORWARD) {
+                    move.x = toFixed(theOperands[pc]/scale*
+                        pen.lutSin.back());
+                    move.y = toFixed(theOperands[pc]/scale*
+                        pen.lutCos.back());
+                }
+                moves.push_back(move);
+            }
+        }
+        // The position is the rounding of the fixed point one
+        pen.fixed.x = toFixed(iniX);
+        pen.fixed.y = toFixed(iniY);
+        pen.x = toDouble(pen.fixed.x);
+        pen.y = toDouble(pen.fixed.y);
+    }
+    pen.moves = moves.empty() ? NULL : &moves[0];
+    pen.dirX = sin(iniAng*DEG_TO_RAD);
+    pen.dirY = cos(iniAng*DEG_TO_RAD);
+}
+
+void Turtle::draw(const char* symbols, const size_t count,
+        const double scale, Pen &pen, Segments &out) const {
+    size_t symbol = 0, run, first, seg;
+    unsigned int pc, end;
+    const Point* row;
+    double* x0;
+    double* y0;
+    double* x1;
+    double* y1;
+    while (symbol < count) {
+        if (theStraight[static_cast<unsigned char>(symbols[symbol])]) {
+            for (run = symbol; (run < count) && theStraight[
+                    static_cast<unsigned char>(symbols[run])]; run++) {
+            }
+            first = out.extend(run - symbol);
+            x0 = out.dataX0() + first;
+            y0 = out.dataY0() + first;
+            x1 = out.dataX1() + first;
+            y1 = out.dataY1() + first;
+            if (pen.moves != NULL) {
+                // Exact moves along the heading
+                row = pen.moves + pen.index*theCode.size();
+                for (seg = 0; symbol < run; symbol++, seg++) {
+                    const Point &move = row[thePrograms[
+                        static_cast<unsigned char>(symbols[symbol])].first];
+                    x0[seg] = pen.x;
+                    y0[seg] = pen.y;
+                    pen.fixed.x += move.x;
+                    pen.fixed.y += move.y;
+                    pen.x = toDouble(pen.fixed.x);
+                    pen.y = toDouble(pen.fixed.y);
+                    x1[seg] = pen.x;
+                    y1[seg] = pen.y;
+                }
+            } else {
+                // Cumulative distances along the heading
+                pen.offsets.assign(1, 0);
+                for (seg = symbol; seg < run; seg++) {
+                    pen.offsets.push_back(pen.offsets.back() + theOperands[
+                        thePrograms[static_cast<unsigned char>(
+                        symbols[seg])].first]/scale);
+                }
+                straightRun(pen.x, pen.y, pen.dirX, pen.dirY,
+                    &pen.offsets[0], run - symbol, x0, y0, x1, y1);
+                pen.x = x1[run - symbol - 1];
+                pen.y = y1[run - symbol - 1];
+                symbol = run;
+            }
+        } else {
+            const Program &program =
+                thePrograms[static_cast<unsigned char>(symbols[symbol])];
+            end = program.first + program.count;
+            for (pc = program.first; pc < end; pc++) {
+                if (theCode[pc] != DRAW_FORWARD) {
+                    steer(pc, pen);
+                } else if (pen.moves != NULL) {
+                    const Point &move =
+                        pen.moves[pen.index*theCode.size() + pc];
+                    pen.fixed.x += move.x;
+                    pen.fixed.y += move.y;
+                    out.add(pen.x, pen.y, toDouble(pen.fixed.x),
+                        toDouble(pen.fixed.y));
+                    pen.x = out.getX1().back();
+                    pen.y = out.getY1().back();
+                } else {
+                    out.add(pen.x, pen.y,
+                        pen.x + theOperands[pc]/scale*pen.dirX,
+                        pen.y + theOperands[pc]/scale*pen.dirY);
+                    pen.x = out.getX1().back();
+                    pen.y = out.getY1().back();
+                }
+            }
+            symbol++;
+        }
+    }
+}
+
+void Turtle::summarise(const char* symbols, const size_t count,
+        const int numHeadings, Summary<int> &turns) const {
+    size_t symbol;
+    unsigned int pc, end;
+    turns.last.base = -1;
+    turns.last.delta = 0;
+    turns.pushed.clear();
+    turns.below.clear();
+    for (symbol = 0; symbol < count; symbol++) {
+        const Program &program =
+            thePrograms[static_cast<unsigned char>(symbols[symbol])];
+        end = program.first + program.count;
+        for (pc = program.first; pc < end; pc++) {
+            switch (theCode[pc]) {
+                case TURN_LEFT:
+                case TURN_RIGHT:
+                    turns.last.delta = wrap(turns.last.delta +
+                        theTurnSteps[pc], numHeadings);
+                    break;
+                case PUSH_ANG:
+                    turns.pushed.push_back(turns.last);
+                    break;
+                case POP_ANG:
+                    // A pop from below keeps the heading if none is saved
+                    if (!turns.pushed.empty()) {
+                        turns.last = turns.pushed.back();
+                        turns.pushed.pop_back();
+                    } else {
+                        turns.below.push_back(turns.last);
+                        turns.last.base = turns.below.size() - 1;
+                        turns.last.delta = 0;
+                    }
+                    break;
+            }
+        }
+    }
+}
+
+void Turtle::summarise(const char* symbols, const size_t count, Pen &pen,
+        Summary<Point> &moves) const {
+    size_t symbol;
+    unsigned int pc, end;
+    moves.last.base = -1;
+    moves.last.delta.x = 0;
+    moves.last.delta.y = 0;
+    moves.pushed.clear();
+    moves.below.clear();
+    for (symbol = 0; symbol < count; symbol++) {
+        const Program &program =
+            thePrograms[static_cast<unsigned char>(symbols[symbol])];
+        end = program.first + program.count;
+        for (pc = program.first; pc < end; pc++) {
+            switch (theCode[pc]) {
+                case DRAW_FORWARD: {
+                    const Point &move =
+                        pen.moves[pen.index*theCode.size() + pc];
+                    moves.last.delta.x += move.x;
+                    moves.last.delta.y += move.y;
+                    break;
+                }
+                case PUSH_POS:
+                    moves.pushed.push_back(moves.last);
+                    break;
+                case POP_POS:
+                    if (!moves.pushed.empty()) {
+                        moves.last = moves.pushed.back();
+                        moves.pushed.pop_back();
+                    } else {
+                        moves.below.push_back(moves.last);
+                        moves.last.base = moves.below.size() - 1;
+                        moves.last.delta.x = 0;
+                        moves.last.delta.y = 0;
+                    }
+                    break;
+                default:
+                    steer(pc, pen);
+                    break;
+            }
+        }
+    }
+}
+
+void Turtle::steer(const unsigned int pc, Pen &pen) const {
+    int numHeadings = pen.lutSin.size();
+    switch (theCode[pc]) {
+        case TURN_LEFT:
+        case TURN_RIGHT:
+            if (numHeadings > 0) {
+                pen.index = wrap(pen.index + theTurnSteps[pc], numHeadings);
+                pen.dirX = pen.lutSin[pen.index];
+                pen.dirY = pen.lutCos[pen.index];
+            } else {
+                if (theCode[pc] == TURN_LEFT) {
+                    pen.heading -= theOperands[pc];
+                } else {
+                    pen.heading += theOperands[pc];
+                }
+                pen.heading = fmod(pen.heading, 360.0);
+                pen.dirX = sin(pen.heading*DEG_TO_RAD);
+                pen.dirY = cos(pen.heading*DEG_TO_RAD);
+            }
+            break;
+        case PUSH_POS:
+            if (numHeadings > 0) {
+                pen.fixedStack.push_back(pen.fixed);
+            } else {
+                pen.posStack.push_back(pen.x);
+                pen.posStack.push_back(pen.y);
+            }
+            break;
+        case POP_POS:
+            // Unbalanced pops leave the turtle in place
+            if (numHeadings > 0) {
+                if (!pen.fixedStack.empty()) {
+                    pen.fixed = pen.fixedStack.back();
+                    pen.fixedStack.pop_back();
+                    pen.x = toDouble(pen.fixed.x);
+                    pen.y = toDouble(pen.fixed.y);
+                }
+            } else if (pen.posStack.size() >= 2) {
+                pen.y = pen.posStack.back();
+                pen.posStack.pop_back();
+                pen.x = pen.posStack.back();
+                pen.posStack.pop_back();
+            }
+            break;
+        case PUSH_ANG:
+            pen.angStack.push_back(numHeadings > 0 ? pen.index :
+                pen.heading);
+            break;
+        case POP_ANG:
+            if (!pen.angStack.empty()) {
+                if (numHeadings > 0) {
+                    pen.index = static_cast<int>(pen.angStack.back());
+                    pen.dirX = pen.lutSin[pen.index];
+                    pen.dirY = pen.lutCos[pen.index];
+                } else {
+                    pen.heading = pen.angStack.back();
+                    pen.dirX = sin(pen.heading*DEG_TO_RAD);
+                    pen.dirY = cos(pen.heading*DEG_TO_RAD);
+                }
+                pen.angStack.pop_back();
+            }
+            break;
+    }
+}
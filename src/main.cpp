@@ -33,34 +33,451 @@
 |________________________________________________________________________*/
 
 #include "Lsystem.hpp"
+#include "ParametricLsystem.hpp"
 #include "Parser.hpp"
 #include "Turtle.hpp"
+#include "Derivation.hpp"
+#include "DerivationSession.hpp"
+#include "ExpansionCache.hpp"
+#include "Growth.hpp"
+#include "StringSource.hpp"
+#include "ProductionFile.hpp"
+#include "MappedSource.hpp"
+#include "Rope.hpp"
+#include "RopeSource.hpp"
+#include "Batch.hpp"
+#include "Segments.hpp"
+#include "Simplifier.hpp"
+#include "SvgWriter.hpp"
+#include "BinaryWriter.hpp"
+#include "RasterWriter.hpp"
+#include "PlyWriter.hpp"
 #include <string>
 #include <set>
 #include <map>
 #include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <climits>
+#include <ctime>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <thread>
+#include <memory_resource>
+#include <unistd.h>
 
 using namespace std;
 
-int main(int argc, const char* argv[]) {
+/**
+ * @brief Command line usage.
+ */
+static const char* USAGE =
+    "usage: lsystem [-a] [-b logo|svg|bin|ppm|png|ply] [-c checkpoint]\n"
+    "               [-d tolerance] [-f production] [-l] [-m megabytes] [-o]\n"
+    "               [-p pixels] [-r] [-s seed] [-z] file.def\n"
+    "       lsystem [-p pixels] -B manifest";
+
+/**
+ * @brief Side of the square that auto-fitted drawings fill.
+ */
+static const double FIT_SIZE = 450;
+
+/**
+ * @brief Read a real number, which must be all of the text.
+ */
+static bool real(const char* text, double &value) {
+    char* end;
+    errno = 0;
+    value = strtod(text, &end);
+    return (end != text) && (*end == '\0') && (errno == 0) &&
+        isfinite(value);
+}
+
+/**
+ * @brief Read a whole number, which must be all of the text.
+ */
+static bool whole(const char* text, long &value) {
+    char* end;
+    errno = 0;
+    value = strtol(text, &end, 10);
+    return (end != text) && (*end == '\0') && (errno == 0);
+}
+
+int main(int argc, char* argv[]) {
     Parser p;
-    ifstream f(argv[1]);
-    string prod, drawing;
-    if (f.is_open()) {
-        p.parse(f);
-        f.close();
-        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules());
-        prod = lsys.produce(p.getIterations());
-        Turtle ninja;
-        drawing = ninja.rewrite(prod, p.getTurtle(),
-            p.getReductionScale(), p.getInitPos(), p.getInitAng());
-        cout << drawing;
+    string prod;
+    unsigned long long seed = time(NULL);
+    string backend = "logo";
+    string manifest;
+    string resume;
+    string outOfCore;
+    string error;
+    bool lazy = false;
+    bool analyse = false;
+    bool shared = false;
+    bool modular = false;
+    bool autofit = false;
+    bool simplify = false;
+    bool seeded = false;
+    bool exact;
+    double limit = 0;
+    double detail = 0;
+    unsigned int pixels = 1024;
+    double scale, iniX, iniY;
+    double length, segments, produceBytes, segmentBytes;
+    Growth::Count exactSegments;
+    size_t index;
+    long number;
+    int option;
+    while ((option = getopt(argc, argv, "aB:b:c:d:f:lm:op:rs:z")) != -1) {
+        switch (option) {
+            case 'a':
+                analyse = true;
+                break;
+            case 'B':
+                manifest = optarg;
+                break;
+            case 'b':
+                backend = optarg;
+                break;
+            case 'c':
+                resume = optarg;
+                break;
+            case 'd':
+                if (!real(optarg, detail) || (detail < 0)) {
+                    cout << "option -d expects a tolerance, not \"" <<
+                        optarg << "\"" << endl;
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'f':
+                outOfCore = optarg;
+                break;
+            case 'l':
+                lazy = true;
+                break;
+            case 'm':
+                limit = atof(optarg)*(1 << 20);
+                break;
+            case 'o':
+                simplify = true;
+                break;
+            case 'p':
+                if (!whole(optarg, number) || (number < 1) ||
+                        (number > UINT_MAX)) {
+                    cout << "option -p expects a number of pixels, not \"" <<
+                        optarg << "\"" << endl;
+                    return EXIT_FAILURE;
+                }
+                pixels = number;
+                break;
+            case 'r':
+                shared = true;
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                seeded = true;
+                break;
+            case 'z':
+                autofit = true;
+                break;
+            default:
+                cout << USAGE << endl;
+                return EXIT_FAILURE;
+        }
+    }
+    // Batch mode: all the jobs of the manifest in this process
+    if (!manifest.empty()) {
+        Batch batch(pixels);
+        ifstream m(manifest.c_str());
+        if (!m.is_open()) {
+            cout << "error opening file" << endl;
+            return EXIT_FAILURE;
+        }
+        if (!batch.load(m, error)) {
+            cout << error << endl;
+            return EXIT_FAILURE;
+        }
+        m.close();
+        return batch.run(thread::hardware_concurrency()) == 0 ?
+            EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if ((optind >= argc) || (backend.compare("logo") &&
+            backend.compare("svg") && backend.compare("bin") &&
+            backend.compare("ppm") && backend.compare("png") &&
+            backend.compare("ply")) || (((detail > 0) || simplify) &&
+            (!backend.compare("logo") || !backend.compare("ply")))) {
+        cout << USAGE << endl;
+        return EXIT_FAILURE;
+    }
+    // The checkpoint saves the generations, which these never derive
+    if (!resume.empty() && (lazy || shared || (detail > 0) ||
+            !outOfCore.empty())) {
+        cout << "option -c does not combine with -d, -f, -l or -r" << endl;
+        return EXIT_FAILURE;
+    }
+    if (p.parse(argv[optind], error)) {
+        // A run resumes with the seed of its checkpoint, or reuses that
+        // of its production file, unless given
+        ProductionFile checkpoint;
+        if (!seeded && (!resume.empty() || !outOfCore.empty()) &&
+                checkpoint.open(resume.empty() ? outOfCore : resume,
+                error)) {
+            seed = checkpoint.getHeader().seed;
+            checkpoint.close();
+        }
+        Lsystem lsys(p.getAlphabet(), p.getAxiom(), p.getRules(), seed);
+        Turtle ninja(p.getTurtle());
+        // Context-sensitive and parametric rules take their own engine
+        ParametricLsystem modules;
+        ParametricLsystem::Modules produced;
+        modular = !p.getModuleRules().empty();
+        if (modular && !modules.compile(p.getAxiom(), p.getRules(),
+                p.getModuleRules(), p.getIgnored(), p.getOpening(),
+                p.getClosing(), error)) {
+            // The parser checked the rest, with its line and column
+            cout << argv[optind] << ": " << error << endl;
+            return EXIT_FAILURE;
+        }
+        if (modular && (analyse || lazy || shared || autofit ||
+                (detail > 0) || !resume.empty() || !outOfCore.empty())) {
+            cout << "options -a, -c, -d, -f, -l, -r and -z need " <<
+                "context-free rules" << endl;
+            return EXIT_FAILURE;
+        }
+        if (modular && !backend.compare("ply") &&
+                ninja.isParametric(modules)) {
+            cout << "ply does not draw modules by their parameters" << endl;
+            return EXIT_FAILURE;
+        }
+        // Frame of the drawing, from the definition or from its extent
+        string reduction = p.getReductionScale();
+        vector<string> initPos = p.getInitPos();
+        if (autofit && ninja.fit(lsys, p.getIterations(),
+                atof(p.getInitAng().c_str()), FIT_SIZE, scale, iniX, iniY)) {
+            reduction = to_string(scale);
+            initPos[0] = to_string(iniX);
+            initPos[1] = to_string(iniY);
+        }
+        // Size of the job, exact if deterministic, else expected (the
+        // modules are not analysed)
+        exact = false;
+        segments = 0;
+        exactSegments = 0;
+        if (!modular) {
+            Growth growth(lsys, p.getIterations());
+            const string &symbols = growth.getSymbols();
+            exact = growth.isExact();
+            length = exact ? static_cast<double>(growth.getLength()) :
+                growth.getExpectedLength();
+            for (index = 0; index < symbols.size(); index++) {
+                segments += (exact ?
+                    static_cast<double>(growth.getCount(symbols[index])) :
+                    growth.getExpectedCount(symbols[index]))*
+                    ninja.getDraws(symbols[index]);
+                exactSegments += growth.getCount(symbols[index])*
+                    ninja.getDraws(symbols[index]);
+            }
+            // Two generations are held in memory, plus the segments
+            produceBytes = 2*length;
+            segmentBytes = (backend.compare("logo") &&
+                backend.compare("ply")) ? 4*sizeof(double)*segments : 0;
+            if (analyse) {
+                cout << (exact ? "exact" : "expected") <<
+                    " counts (segments per symbol) after " <<
+                    p.getIterations() << " iterations" << endl;
+                for (index = 0; index < symbols.size(); index++) {
+                    cout << "  " << symbols[index] << ": ";
+                    if (exact) {
+                        cout << Growth::format(
+                            growth.getCount(symbols[index]));
+                    } else {
+                        cout << fixed << setprecision(1) <<
+                            growth.getExpectedCount(symbols[index]);
+                    }
+                    cout << " (" << ninja.getDraws(symbols[index]) <<
+                        ")" << endl;
+                }
+                if (exact) {
+                    cout << "symbols: " <<
+                        Growth::format(growth.getLength()) << endl <<
+                        "segments: " << Growth::format(exactSegments) <<
+                        endl;
+                } else {
+                    cout << fixed << setprecision(1) << "symbols: " <<
+                        length << endl << "segments: " << segments << endl;
+                }
+                cout << fixed << setprecision(1) << "memory: " <<
+                    (produceBytes + segmentBytes)/(1 << 20) << " MB, " <<
+                    segmentBytes/(1 << 20) << " MB if lazy" << endl;
+                return EXIT_SUCCESS;
+            }
+            // Stream the jobs that do not fit, refuse those that never
+            // will (or that resume, which holds the whole production)
+            if ((limit > 0) && ((segmentBytes > limit) || (!resume.empty() &&
+                    (produceBytes + segmentBytes > limit)))) {
+                cout << "job exceeds memory limit" << endl;
+                return EXIT_FAILURE;
+            }
+            if ((limit > 0) && (produceBytes + segmentBytes > limit)) {
+                lazy = true;
+            }
+        }
+        // Deterministic subtrees are expanded once and copied, if the
+        // production is derived from the axiom or counted (else the cache
+        // is left empty)
+        ExpansionCache cache(lsys, !modular && ((!shared && (detail <= 0) &&
+            outOfCore.empty() && (lazy || resume.empty())) ||
+            (!backend.compare("ply") && !exact)) ? p.getIterations() : 0);
+        // If lazy, symbols are derived as the turtle asks for them
+        Derivation derivation(lsys, p.getIterations(), &cache);
+        StringSource whole(prod);
+        // Scratch of the run, released at once at the end
+        pmr::monotonic_buffer_resource scratch;
+        // If shared, symbols are read from a rope of shared subtrees
+        Rope rope = shared ? lsys.produceRope(p.getIterations(), &scratch) :
+            Rope();
+        RopeSource branches(rope);
+        // If out of core, symbols are mapped from a production file
+        ProductionFile file;
+        MappedSource mapped(file);
+        SymbolSource *source = &derivation;
+        if (modular) {
+            produced = modules.produce(p.getIterations());
+            prod = produced.symbols;
+            source = &whole;
+        } else if (detail > 0) {
+            // Derived as it is drawn, down to the level of detail
+            lazy = true;
+        } else if (shared) {
+            source = &branches;
+            lazy = true;
+        } else if (!outOfCore.empty()) {
+            // Derive the file unless it holds this production already
+            // (the seed only matters to stochastic grammars)
+            if (!file.open(outOfCore, error) ||
+                    (static_cast<int>(file.getHeader().epoch) !=
+                    p.getIterations()) || (lsys.isStochastic() &&
+                    (file.getHeader().seed != lsys.getSeed())) ||
+                    (file.getHeader().grammar != lsys.getFingerprint())) {
+                file.close();
+                if (!lsys.produceFile(p.getIterations(), outOfCore, error) ||
+                        !file.open(outOfCore, error)) {
+                    cout << error << endl;
+                    return EXIT_FAILURE;
+                }
+            }
+            source = &mapped;
+            lazy = false;
+        } else if (!lazy && !resume.empty()) {
+            // Resume from the last generation saved, and save every new
+            // one, so that a long run survives a crash
+            DerivationSession session(lsys, thread::hardware_concurrency());
+            ifstream saved(resume.c_str());
+            if (saved.is_open() && !session.load(resume, error)) {
+                cout << error << endl;
+                return EXIT_FAILURE;
+            }
+            if (static_cast<int>(session.getEpoch()) >
+                    p.getIterations()) {
+                cout << resume << ": checkpoint beyond " <<
+                    p.getIterations() << " iterations" << endl;
+                return EXIT_FAILURE;
+            }
+            while (static_cast<int>(session.getEpoch()) <
+                    p.getIterations()) {
+                session.advance();
+                if (!session.save(resume, error)) {
+                    cout << error << endl;
+                    return EXIT_FAILURE;
+                }
+            }
+            prod = session.getProduction();
+            source = &whole;
+        } else if (!lazy) {
+            prod = lsys.produce(p.getIterations(),
+                thread::hardware_concurrency(), &cache);
+            source = &whole;
+        }
+        if (!backend.compare("logo") && modular) {
+            ninja.rewrite(modules, produced, reduction, initPos,
+                p.getInitAng(), cout);
+        } else if (!backend.compare("logo")) {
+            ninja.rewrite(*source, reduction, initPos, p.getInitAng(), cout);
+        } else if (!backend.compare("ply")) {
+            // Streamed, the header takes the number of segments, known
+            // exactly or else counted by a first pass over the symbols
+            unsigned long long numSegs =
+                static_cast<unsigned long long>(exactSegments);
+            if (modular) {
+                StringSource counted(prod);
+                numSegs = ninja.getDraws(counted);
+            } else if (!exact) {
+                Derivation counted(lsys, p.getIterations(), &cache);
+                numSegs = ninja.getDraws(counted);
+            }
+            if (!PlyWriter::fits(numSegs, error)) {
+                cerr << error << endl;
+                return EXIT_FAILURE;
+            }
+            PlyWriter ply(cout, numSegs);
+            ninja.trace(*source, atof(reduction.c_str()),
+                atof(initPos[0].c_str()), atof(initPos[1].c_str()),
+                atof(p.getInitAng().c_str()), ply);
+            if (!ply.close(error)) {
+                // Not on the output, which holds the drawing
+                cerr << error << endl;
+                return EXIT_FAILURE;
+            }
+        } else {
+            // The analysis tells the room for all the segments
+            Segments segs;
+            segs.reserve((modular || (detail > 0)) ? 0 :
+                static_cast<size_t>(segments));
+            if (modular) {
+                ninja.trace(modules, produced, atof(reduction.c_str()),
+                    atof(initPos[0].c_str()), atof(initPos[1].c_str()),
+                    atof(p.getInitAng().c_str()), segs);
+            } else if (detail > 0) {
+                ninja.trace(lsys, p.getIterations(), detail,
+                    atof(reduction.c_str()), atof(initPos[0].c_str()),
+                    atof(initPos[1].c_str()), atof(p.getInitAng().c_str()),
+                    segs);
+            } else if (!outOfCore.empty()) {
+                ninja.trace(file.getSymbols(), file.getHeader().length,
+                    atof(reduction.c_str()),
+                    atof(initPos[0].c_str()), atof(initPos[1].c_str()),
+                    atof(p.getInitAng().c_str()), segs,
+                    thread::hardware_concurrency());
+            } else if (lazy) {
+                ninja.trace(*source, atof(reduction.c_str()),
+                    atof(initPos[0].c_str()), atof(initPos[1].c_str()),
+                    atof(p.getInitAng().c_str()), segs);
+            } else {
+                ninja.trace(prod, atof(reduction.c_str()),
+                    atof(initPos[0].c_str()), atof(initPos[1].c_str()),
+                    atof(p.getInitAng().c_str()), segs,
+                    thread::hardware_concurrency());
+            }
+            if (simplify) {
+                Simplifier().simplify(segs);
+            }
+            if (!backend.compare("svg")) {
+                SvgWriter().write(segs, cout);
+            } else if (!backend.compare("ppm")) {
+                RasterWriter(pixels, RasterWriter::PPM,
+                    thread::hardware_concurrency()).write(segs, cout);
+            } else if (!backend.compare("png")) {
+                RasterWriter(pixels, RasterWriter::PNG,
+                    thread::hardware_concurrency()).write(segs, cout);
+            } else {
+                BinaryWriter().write(segs, cout);
+            }
+        }
         return EXIT_SUCCESS;
     } else {
-        cout << "error opening file" << endl;
+        cout << error << endl;
         return EXIT_FAILURE;
     }
 }
-